@@ -2,6 +2,10 @@
 #define ALGOBASE
 
 #include <algorithm>
+#include <type_traits>
+#include <string.h>
+
+#include "type_traits.h"
 
 namespace mystl {
 
@@ -30,6 +34,118 @@ bool equal(II1 first1, II1 last, II2 first2) {
     return true;
 }
 
+// 单字节字符类型，可以直接使用memchr/memcmp/memset
+template<typename T>
+struct __is_byte_char
+    : std::integral_constant<bool,
+      std::is_same<typename std::remove_cv<T>::type, char>::value ||
+      std::is_same<typename std::remove_cv<T>::type, signed char>::value ||
+      std::is_same<typename std::remove_cv<T>::type, unsigned char>::value> {};
+
+template<typename T>
+typename std::enable_if<__is_byte_char<T>::value, bool>::type
+equal(T* first1, T* last, T* first2) {
+    const size_t n = static_cast<size_t>(last - first1);
+    return n == 0 || memcmp(first1, first2, n) == 0;
+}
+
+// copy，原生指针且元素平凡可拷贝时使用memmove(允许区间重叠且result在first之前)
+template<typename II, typename OI>
+MYSTL_CONSTEXPR20 OI copy(II first, II last, OI result) {
+    for(; first != last; ++first, ++result) {
+        *result = *first;
+    }
+    return result;
+}
+
+template<typename T, typename U>
+MYSTL_CONSTEXPR20 typename std::enable_if<
+    std::is_same<typename std::remove_const<T>::type, U>::value &&
+    std::is_trivially_copyable<U>::value, U*>::type
+copy(T* first, T* last, U* result) {
+    if(mystl::is_constant_evaluated()) {
+        for(; first != last; ++first, ++result) *result = *first;
+        return result;
+    }
+    const size_t n = static_cast<size_t>(last - first);
+    if(n) {
+        memmove(result, first, n * sizeof(U));
+    }
+    return result + n;
+}
+
+// fill_n，单字节类型使用memset
+template<typename OI, typename Size, typename T>
+OI fill_n(OI first, Size n, const T& value) {
+    for(; n > 0; --n, ++first) {
+        *first = value;
+    }
+    return first;
+}
+
+template<typename T, typename Size>
+typename std::enable_if<__is_byte_char<T>::value, T*>::type
+fill_n(T* first, Size n, const T& value) {
+    if(n > 0) {
+        memset(first, static_cast<unsigned char>(value), static_cast<size_t>(n));
+        return first + n;
+    }
+    return first;
+}
+
+// find，单字节类型使用memchr
+template<typename II, typename T>
+II find(II first, II last, const T& value) {
+    for(; first != last; ++first) {
+        if(*first == value) break;
+    }
+    return first;
+}
+
+template<typename T>
+typename std::enable_if<__is_byte_char<T>::value, T*>::type
+find(T* first, T* last, const T& value) {
+    if(first == last) return last;
+    void* p = memchr(const_cast<typename std::remove_const<T>::type*>(first),
+                     static_cast<unsigned char>(value),
+                     static_cast<size_t>(last - first));
+    return p ? static_cast<T*>(p) : last;
+}
+
+// search，在[first1, last1)中查找子序列[first2, last2)
+// 先用find定位首元素(对字符走memchr)，再用equal比较剩下的部分
+template<typename T>
+T* search(T* first1, T* last1, T* first2, T* last2) {
+    const ptrdiff_t n = last2 - first2;
+    if(n == 0) return first1;
+    T* const stop = last1 - n + 1;
+    while(first1 < stop) {
+        first1 = mystl::find(first1, stop, *first2);
+        if(first1 == stop) break;
+        if(mystl::equal(first1 + 1, first1 + n, first2 + 1)) return first1;
+        ++first1;
+    }
+    return last1;
+}
+
+// 字典序比较，返回 <0 / 0 / >0
+template<typename T>
+int compare(const T* first1, size_t n1, const T* first2, size_t n2) {
+    const size_t n = n1 < n2 ? n1 : n2;
+    for(size_t i = 0; i < n; ++i) {
+        if(first1[i] < first2[i]) return -1;
+        if(first2[i] < first1[i]) return 1;
+    }
+    return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
+}
+
+inline int compare(const char* first1, size_t n1, const char* first2, size_t n2) {
+    const size_t n = n1 < n2 ? n1 : n2;
+    const int r = n ? memcmp(first1, first2, n) : 0;
+    if(r != 0) return r;
+    return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
+}
+
 
 }   // end of namespace mystl
 
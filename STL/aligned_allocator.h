@@ -0,0 +1,77 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+// 按指定对齐申请内存的分配器，接口和 mystl::allocator 一样都是静态函数，容器可以直接替换
+// 缓冲区起点按 Align 对齐(取 Align 和 alignof(T) 中较大的)，长度补齐到 Align 的整数倍，
+// 缓冲区独占它所在的缓存行，不会和其他分配共享同一行(伪共享)
+// 常用的对齐：cache_line_size 方便SIMD对齐加载和按线程分槽，page_size 方便 mmap/madvise/大页
+
+#include "allocator.h"
+
+namespace mystl {
+
+template<typename T, size_t Align>
+class aligned_allocator : public allocator<T> {
+public:
+    typedef typename allocator<T>::pointer pointer;
+    typedef typename allocator<T>::sizeType sizeType;
+
+    static const size_t alignment = Align > alignof(T) ? Align : alignof(T);
+    static_assert((alignment & (alignment - 1)) == 0, "aligned_allocator: Align must be a power of two");
+
+    template<typename U>
+    struct rebind { typedef aligned_allocator<U, Align> other; };
+
+public:
+    constexpr aligned_allocator() noexcept {}
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    static MYSTL_CONSTEXPR20 pointer allocate() { return allocate(1); }
+    static MYSTL_CONSTEXPR20 pointer allocate(sizeType n) {
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+        if(mystl::is_constant_evaluated()) return std::allocator<T>().allocate(n);
+#endif
+        return static_cast<pointer>(aligned_operator_new(padded_bytes(n), alignment));
+    }
+
+    static MYSTL_CONSTEXPR20 void deallocate(pointer ptr) { deallocate(ptr, 1); }
+    static MYSTL_CONSTEXPR20 void deallocate(pointer ptr, sizeType n) {
+        if(ptr == nullptr) return;
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+        if(mystl::is_constant_evaluated()) {
+            std::allocator<T>().deallocate(ptr, n);
+            return;
+        }
+#endif
+        (void)n;
+        aligned_operator_delete(ptr, alignment);
+    }
+
+private:
+    static size_t padded_bytes(sizeType n) {
+        if(n > (size_t(-1) - alignment) / sizeof(T)) throw std::bad_alloc();
+        return (n * sizeof(T) + alignment - 1) & ~(alignment - 1);
+    }
+};
+
+template<typename T, size_t Align>
+const size_t aligned_allocator<T, Align>::alignment;
+
+template<typename T, typename U, size_t Align>
+constexpr bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept { return true; }
+
+template<typename T, typename U, size_t Align>
+constexpr bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept { return false; }
+
+// 容器按对齐选项挑选分配器：不超过 alignof(T) 时没必要多付出补齐的空间，直接用 allocator
+template<typename T, size_t Align>
+struct aligned_allocator_for {
+    typedef typename std::conditional<(Align > alignof(T)),
+                                      aligned_allocator<T, Align>,
+                                      allocator<T>>::type type;
+};
+
+}   // end of namespace mystl
+
+#endif
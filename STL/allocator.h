@@ -6,9 +6,61 @@
 
 #include "type_traits.h"
 #include "construct.h"
+#include "uninitialized.h"
+
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+
+// 定义了 MYSTL_THREAD_CACHE 时从线程缓存申请内存，多线程频繁申请释放时不争用系统分配器
+#ifdef MYSTL_THREAD_CACHE
+#include "thread_cache.h"
+#endif
+
+// 缓存行和页的大小，aligned_allocator 和容器的对齐选项使用
+#ifndef MYSTL_CACHE_LINE_SIZE
+#define MYSTL_CACHE_LINE_SIZE 64
+#endif
+
+#ifndef MYSTL_PAGE_SIZE
+#define MYSTL_PAGE_SIZE 4096
+#endif
 
 namespace mystl{
 
+const size_t cache_line_size = MYSTL_CACHE_LINE_SIZE;
+const size_t page_size = MYSTL_PAGE_SIZE;
+
+// 普通 operator new 保证的对齐，超过它的类型(alignas(64)、AVX-512向量)需要走对齐的分配
+#ifdef __STDCPP_DEFAULT_NEW_ALIGNMENT__
+const size_t default_new_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+#else
+const size_t default_new_alignment = alignof(std::max_align_t);
+#endif
+
+// C++17 起有对齐的 operator new，之前用 posix_memalign
+// align 必须是2的幂
+inline void* aligned_operator_new(size_t bytes, size_t align) {
+#ifdef __cpp_aligned_new
+    return ::operator new(bytes, std::align_val_t(align));
+#else
+    void* ptr = nullptr;
+    if(align < sizeof(void*)) align = sizeof(void*);
+    if(posix_memalign(&ptr, align, bytes ? bytes : 1) != 0) throw std::bad_alloc();
+    return ptr;
+#endif
+}
+
+inline void aligned_operator_delete(void* ptr, size_t align) noexcept {
+#ifdef __cpp_aligned_new
+    ::operator delete(ptr, std::align_val_t(align));
+#else
+    (void)align;
+    std::free(ptr);
+#endif
+}
+
 
 template<typename T>
 class allocator {
@@ -21,79 +73,235 @@ public:
     typedef size_t sizeType;
     typedef ptrdiff_t differenceType;
 
+    template<typename U>
+    struct rebind { typedef allocator<U> other; };
+
 public:
-    static pointer allocate();
-    static pointer allocate(sizeType);
+    // 没有状态，任意两个 allocator 都相等，可以互相转换
+    constexpr allocator() noexcept {}
+    template<typename U>
+    constexpr allocator(const allocator<U>&) noexcept {}
+
+    // 常量求值中改用 std::allocator，编译期申请的内存必须在求值结束前释放
+    static MYSTL_CONSTEXPR20 pointer allocate();
+    static MYSTL_CONSTEXPR20 pointer allocate(sizeType);
 
-    static void deallocate(pointer);
-    static void deallocate(pointer, sizeType);
+    static MYSTL_CONSTEXPR20 void deallocate(pointer);
+    static MYSTL_CONSTEXPR20 void deallocate(pointer, sizeType);
 
-    static void construct(pointer);
-    static void construct(pointer, const T&);
-    static void construct(pointer, T&&);
+    static MYSTL_CONSTEXPR20 void construct(pointer);
+    static MYSTL_CONSTEXPR20 void construct(pointer, const T&);
+    static MYSTL_CONSTEXPR20 void construct(pointer, T&&);
     template<typename... Args>
-    static void construct(pointer, Args&&...);
+    static MYSTL_CONSTEXPR20 void construct(pointer, Args&&...);
 
-    static void destory(pointer);
-    static void destory(T*, T*);
+    static MYSTL_CONSTEXPR20 void destory(pointer);
+    static MYSTL_CONSTEXPR20 void destory(T*, T*);
 
 };
 
 
 template <typename T>
-T* allocator<T>::allocate() {
-    return static_cast<T*>(::operator new(sizeof(T)));
+MYSTL_CONSTEXPR20 T* allocator<T>::allocate() {
+    return allocate(1);
 }
 
 template <typename T>
-T* allocator<T>::allocate(size_t n) {
+MYSTL_CONSTEXPR20 T* allocator<T>::allocate(size_t n) {
     //TODO n==0
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+    if(mystl::is_constant_evaluated()) return std::allocator<T>().allocate(n);
+#endif
+    if(alignof(T) > default_new_alignment)
+        return static_cast<T*>(aligned_operator_new(n * sizeof(T), alignof(T)));
+#ifdef MYSTL_THREAD_CACHE
+    return static_cast<T*>(mystl::thread_cache_allocate(n * sizeof(T)));
+#else
     return static_cast<T*>(::operator new(n * sizeof(T)));
+#endif
 }
 
+// 编译期释放需要知道申请时的个数，只能用带size的版本
 template <typename T>
-void allocator<T>::deallocate(T* ptr) {
-    if(ptr == nullptr) return;
-    ::operator delete(ptr);
+MYSTL_CONSTEXPR20 void allocator<T>::deallocate(T* ptr) {
+    deallocate(ptr, 1);
 }
 
 template <typename T>
-void allocator<T>::deallocate(T* ptr, size_t) {
+MYSTL_CONSTEXPR20 void allocator<T>::deallocate(T* ptr, size_t n) {
     if(ptr == nullptr) return;
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+    if(mystl::is_constant_evaluated()) {
+        std::allocator<T>().deallocate(ptr, n);
+        return;
+    }
+#endif
+    if(alignof(T) > default_new_alignment) {
+        aligned_operator_delete(ptr, alignof(T));
+        return;
+    }
+#ifdef MYSTL_THREAD_CACHE
+    mystl::thread_cache_deallocate(ptr, n * sizeof(T));
+#else
+    (void)n;
     ::operator delete(ptr);  // void operator delete  ( void* ptr, std::size_t sz ) noexcept;(since C++14)
+#endif
 }
 
 template <typename T>
-void allocator<T>::construct(T* ptr) {
-    new(ptr) T();
+MYSTL_CONSTEXPR20 void allocator<T>::construct(T* ptr) {
+    mystl::construct_at(ptr);
 }
 
 template <typename T>
-void allocator<T>::construct(T* ptr, const T& t) {
-    new(ptr) T(t);
+MYSTL_CONSTEXPR20 void allocator<T>::construct(T* ptr, const T& t) {
+    mystl::construct_at(ptr, t);
 }
 
 template <typename T>
-void allocator<T>::construct(T* ptr, T&& t) {
-    new(ptr) T(std::forward<T>(t));
+MYSTL_CONSTEXPR20 void allocator<T>::construct(T* ptr, T&& t) {
+    mystl::construct_at(ptr, std::forward<T>(t));
 }
 
 template <typename T>
 template <typename... Args>
-void allocator<T>::construct(T* ptr, Args&&... args) {
-    new(ptr) T(std::forward<Args>(args)...);
+MYSTL_CONSTEXPR20 void allocator<T>::construct(T* ptr, Args&&... args) {
+    mystl::construct_at(ptr, std::forward<Args>(args)...);
 }
 
 template <typename T>
-void allocator<T>::destory(T* t) {
+MYSTL_CONSTEXPR20 void allocator<T>::destory(T* t) {
     mystl::destory(t);
 }
 
 template <typename T>
-void allocator<T>::destory(T* begin, T* end) {
+MYSTL_CONSTEXPR20 void allocator<T>::destory(T* begin, T* end) {
     mystl::destory(begin, end);
 }
 
+template<typename T, typename U>
+constexpr bool operator==(const allocator<T>&, const allocator<U>&) noexcept { return true; }
+
+template<typename T, typename U>
+constexpr bool operator!=(const allocator<T>&, const allocator<U>&) noexcept { return false; }
+
+
+// 类型 T 是否接受分配器 Alloc：T 有 allocator_type 并且 Alloc 能转换过去(如 pmr 容器)
+template<typename...>
+struct __void_type { typedef void type; };
+
+template<typename T, typename Alloc, typename = void>
+struct uses_allocator : std::false_type {};
+
+template<typename T, typename Alloc>
+struct uses_allocator<T, Alloc, typename __void_type<typename T::allocator_type>::type>
+    : std::is_convertible<Alloc, typename T::allocator_type> {};
+
+// 容器构造元素时是否要经过分配器的 construct，把分配器传给元素(uses-allocator 构造)
+// 默认为false，批量构造直接用 mystl::uninitialized_copy 等(平凡类型是memmove)；pmr::polymorphic_allocator 特化
+template<typename Alloc, typename T>
+struct needs_allocator_construct : std::false_type {};
+
+// 拷贝构造容器时新容器使用的分配器，分配器有 select_on_container_copy_construction 时用它的结果
+template<typename Alloc>
+auto __alloc_select_on_copy(const Alloc& alloc, int)
+    -> decltype(alloc.select_on_container_copy_construction()) {
+    return alloc.select_on_container_copy_construction();
+}
+
+template<typename Alloc>
+constexpr Alloc __alloc_select_on_copy(const Alloc& alloc, long) { return alloc; }
+
+template<typename Alloc>
+constexpr Alloc alloc_select_on_copy(const Alloc& alloc) { return __alloc_select_on_copy(alloc, 0); }
+
+/**
+ * @brief 容器保存分配器的基类
+ *        无状态的分配器(mystl::allocator、aligned_allocator，接口都是静态函数)不占空间，每次用时临时构造
+ *        有状态的分配器(pmr::polymorphic_allocator)每个容器保存一份
+ */
+template<typename Alloc, bool = std::is_empty<Alloc>::value>
+class allocator_holder {
+public:
+    allocator_holder() : allocatorInstance() {}
+    explicit allocator_holder(const Alloc& alloc) : allocatorInstance(alloc) {}
+
+    Alloc& alloc() noexcept { return allocatorInstance; }
+    const Alloc& alloc() const noexcept { return allocatorInstance; }
+    void swap_alloc(allocator_holder& rhs) noexcept {
+        using std::swap;
+        swap(allocatorInstance, rhs.allocatorInstance);
+    }
+
+private:
+    Alloc allocatorInstance;
+};
+
+template<typename Alloc>
+class allocator_holder<Alloc, true> {
+public:
+    constexpr allocator_holder() noexcept {}
+    explicit constexpr allocator_holder(const Alloc&) noexcept {}
+
+    constexpr Alloc alloc() const noexcept { return Alloc(); }
+    MYSTL_CONSTEXPR14 void swap_alloc(allocator_holder&) noexcept {}
+};
+
+// 带分配器的批量构造，needs_allocator_construct 为false时和不带分配器的版本一样
+template<typename InputIter, typename ForwardIter, typename Alloc>
+MYSTL_CONSTEXPR20 ForwardIter __uninitialized_copy_a(InputIter first, InputIter last, ForwardIter result,
+                                                     Alloc&, std::false_type) {
+    return mystl::uninitialized_copy(first, last, result);
+}
+
+template<typename InputIter, typename ForwardIter, typename Alloc>
+ForwardIter __uninitialized_copy_a(InputIter first, InputIter last, ForwardIter result,
+                                   Alloc& alloc, std::true_type) {
+    ForwardIter cur = result;
+    try {
+        for(; first != last; ++first, ++cur) alloc.construct(&*cur, *first);
+    } catch(...) {
+        mystl::destory(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+template<typename InputIter, typename ForwardIter, typename Alloc>
+MYSTL_CONSTEXPR20 ForwardIter uninitialized_copy_a(InputIter first, InputIter last, ForwardIter result, Alloc&& alloc) {
+    typedef typename iterator_traits<ForwardIter>::value_type value_type;
+    typedef typename std::decay<Alloc>::type allocator_type;
+    return __uninitialized_copy_a(first, last, result, alloc,
+                                  std::integral_constant<bool, needs_allocator_construct<allocator_type, value_type>::value>());
+}
+
+template<typename ForwardIter, typename Size, typename T, typename Alloc>
+MYSTL_CONSTEXPR20 ForwardIter __uninitialized_fill_n_a(ForwardIter first, Size n, const T& value,
+                                                       Alloc&, std::false_type) {
+    return mystl::uninitialized_fill_n(first, n, value);
+}
+
+template<typename ForwardIter, typename Size, typename T, typename Alloc>
+ForwardIter __uninitialized_fill_n_a(ForwardIter first, Size n, const T& value,
+                                     Alloc& alloc, std::true_type) {
+    ForwardIter cur = first;
+    try {
+        for(; n > 0; --n, ++cur) alloc.construct(&*cur, value);
+    } catch(...) {
+        mystl::destory(first, cur);
+        throw;
+    }
+    return cur;
+}
+
+template<typename ForwardIter, typename Size, typename T, typename Alloc>
+MYSTL_CONSTEXPR20 ForwardIter uninitialized_fill_n_a(ForwardIter first, Size n, const T& value, Alloc&& alloc) {
+    typedef typename iterator_traits<ForwardIter>::value_type value_type;
+    typedef typename std::decay<Alloc>::type allocator_type;
+    return __uninitialized_fill_n_a(first, n, value, alloc,
+                                    std::integral_constant<bool, needs_allocator_construct<allocator_type, value_type>::value>());
+}
+
 } // end of namespace mystl
 
 #endif
\ No newline at end of file
@@ -0,0 +1,406 @@
+#ifndef BASIC_STRING_H
+#define BASIC_STRING_H
+
+// basic_string 带短字符串优化(SSO)的字符串，对象大小是3个指针(64位下24字节)
+// 长度不超过 smallCapacity(char 为23) 的字符串直接存放在对象内部，不申请堆内存
+// 对象内部不保存指向自身的指针，所以可以用memcpy搬移，见 is_trivially_relocatable
+
+#include "allocator.h"
+#include "algobase.h"
+#include "type_traits.h"
+#include "vector.h"
+
+#include <ostream>
+#include <assert.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "mystl::basic_string assumes a little-endian layout"
+#endif
+
+namespace mystl {
+
+template<typename CharT>
+class basic_string {
+public:
+    typedef mystl::allocator<CharT>                         data_allocator;
+    typedef CharT                                           valueType;
+    typedef CharT*                                          pointer;
+    typedef const CharT*                                    constPointer;
+    typedef CharT&                                          reference;
+    typedef const CharT&                                    constReference;
+    typedef size_t                                          sizeType;
+    typedef ptrdiff_t                                       differenceType;
+
+    typedef CharT*                                          iterator;
+    typedef const CharT*                                    constIterator;
+
+    static constexpr sizeType npos = static_cast<sizeType>(-1);
+
+private:
+    struct longRep {
+        CharT*      ptr;
+        sizeType    size;
+        sizeType    cap;        // 最高位是长字符串标记
+    };
+
+    static constexpr sizeType longFlag = sizeType(1) << (sizeof(sizeType) * 8 - 1);
+
+public:
+    // 短字符串最多能放的字符数，最后一个位置用来保存剩余容量(长度等于它时剩余容量0同时充当'\0')
+    static constexpr sizeType smallCapacity = sizeof(longRep) / sizeof(CharT) - 1;
+
+private:
+    union {
+        longRep     l;
+        CharT       s[smallCapacity + 1];
+    } rep;
+
+public:
+    // 构造
+    basic_string() noexcept { set_small_size(0); }
+    basic_string(const CharT* str) { init(str, length_of(str)); }
+    basic_string(const CharT* str, sizeType n) { init(str, n); }
+    basic_string(sizeType n, CharT c);
+    basic_string(const basic_string& rhs) { init(rhs.data(), rhs.size()); }
+    basic_string(const basic_string& rhs, sizeType pos, sizeType n = npos) {
+        assert(pos <= rhs.size());
+        init(rhs.data() + pos, std::min(n, rhs.size() - pos));
+    }
+    basic_string(basic_string&& rhs) noexcept {
+        rep = rhs.rep;
+        rhs.set_small_size(0);
+    }
+
+    ~basic_string() {
+        if(is_long()) data_allocator::deallocate(rep.l.ptr, long_capacity() + 1);
+    }
+
+    // 赋值
+    basic_string& operator=(const basic_string& rhs) {
+        if(this != &rhs) assign(rhs.data(), rhs.size());
+        return *this;
+    }
+    basic_string& operator=(basic_string&& rhs) noexcept {
+        if(this != &rhs) {
+            if(is_long()) data_allocator::deallocate(rep.l.ptr, long_capacity() + 1);
+            rep = rhs.rep;
+            rhs.set_small_size(0);
+        }
+        return *this;
+    }
+    basic_string& operator=(const CharT* str) { return assign(str, length_of(str)); }
+    basic_string& assign(const CharT*, sizeType);
+
+    // 容量
+    bool        empty()     const { return size() == 0; }
+    sizeType    size()      const { return is_long() ? rep.l.size : small_size(); }
+    sizeType    length()    const { return size(); }
+    sizeType    capacity()  const { return is_long() ? long_capacity() : smallCapacity; }
+    void        reserve(sizeType n) { if(n > capacity()) grow_to(n); }
+    void        resize(sizeType, CharT c = CharT());
+    void        shrink_to_fit();
+    void        clear() { set_size(0); }
+
+    // 元素访问
+    CharT*          data()       { return is_long() ? rep.l.ptr : rep.s; }
+    const CharT*    data()  const { return is_long() ? rep.l.ptr : rep.s; }
+    const CharT*    c_str() const { return data(); }
+    reference       operator[](sizeType n)       { return data()[n]; }
+    constReference  operator[](sizeType n) const { return data()[n]; }
+    reference       front()       { assert(!empty()); return data()[0]; }
+    constReference  front() const { assert(!empty()); return data()[0]; }
+    reference       back()        { assert(!empty()); return data()[size() - 1]; }
+    constReference  back()  const { assert(!empty()); return data()[size() - 1]; }
+
+    // 迭代器相关
+    iterator        begin()        { return data(); }
+    iterator        end()          { return data() + size(); }
+    constIterator   begin()  const { return data(); }
+    constIterator   end()    const { return data() + size(); }
+    constIterator   cbegin() const { return data(); }
+    constIterator   cend()   const { return data() + size(); }
+
+    // 修改
+    void push_back(CharT c);
+    void pop_back() { assert(!empty()); set_size(size() - 1); }
+    basic_string& append(const CharT*, sizeType);
+    basic_string& append(const CharT* str) { return append(str, length_of(str)); }
+    basic_string& append(const basic_string& str) { return append(str.data(), str.size()); }
+    basic_string& append(sizeType, CharT);
+    basic_string& operator+=(const basic_string& str) { return append(str.data(), str.size()); }
+    basic_string& operator+=(const CharT* str) { return append(str); }
+    basic_string& operator+=(CharT c) { push_back(c); return *this; }
+    basic_string& erase(sizeType pos = 0, sizeType n = npos);
+
+    basic_string substr(sizeType pos = 0, sizeType n = npos) const {
+        return basic_string(*this, pos, n);
+    }
+
+    // 查找，找不到返回npos
+    sizeType find(const CharT*, sizeType, sizeType) const;
+    sizeType find(const CharT* str, sizeType pos = 0) const { return find(str, pos, length_of(str)); }
+    sizeType find(const basic_string& str, sizeType pos = 0) const {
+        return find(str.data(), pos, str.size());
+    }
+    sizeType find(CharT, sizeType pos = 0) const;
+    sizeType rfind(CharT, sizeType pos = npos) const;
+
+    int compare(const basic_string& rhs) const {
+        return mystl::compare(data(), size(), rhs.data(), rhs.size());
+    }
+    int compare(const CharT* str) const {
+        return mystl::compare(data(), size(), str, length_of(str));
+    }
+
+    void swap(basic_string& rhs) noexcept {
+        auto temp = rep;
+        rep = rhs.rep;
+        rhs.rep = temp;
+    }
+
+private:
+    // helper function
+    static sizeType length_of(const CharT* str) {
+        sizeType n = 0;
+        while(str[n] != CharT()) ++n;
+        return n;
+    }
+    // 长字符串的cap最高位为1，小端序下它是整个对象的最后一个字节的最高位
+    // 短字符串的最后一个字符是剩余容量(<= smallCapacity)，最高位一定是0
+    bool is_long() const {
+        return reinterpret_cast<const unsigned char*>(&rep)[sizeof(rep) - 1] & 0x80;
+    }
+    sizeType small_size() const {
+        return smallCapacity - static_cast<sizeType>(rep.s[smallCapacity]);
+    }
+    sizeType long_capacity() const { return rep.l.cap & ~longFlag; }
+    void set_small_size(sizeType n) {
+        rep.s[n] = CharT();
+        rep.s[smallCapacity] = static_cast<CharT>(smallCapacity - n);
+    }
+    void set_size(sizeType n) {
+        if(is_long()) {
+            rep.l.size = n;
+            rep.l.ptr[n] = CharT();
+        } else {
+            set_small_size(n);
+        }
+    }
+    void init(const CharT*, sizeType);
+    void grow_to(sizeType);
+};
+
+template<typename CharT>
+constexpr typename basic_string<CharT>::sizeType basic_string<CharT>::npos;
+template<typename CharT>
+constexpr typename basic_string<CharT>::sizeType basic_string<CharT>::smallCapacity;
+
+template<typename CharT>
+basic_string<CharT>::basic_string(sizeType n, CharT c) {
+    set_small_size(0);
+    append(n, c);
+}
+
+template<typename CharT>
+basic_string<CharT>& basic_string<CharT>::assign(const CharT* str, sizeType n) {
+    if(n > capacity()) {
+        basic_string temp(str, n);
+        swap(temp);
+    } else {
+        mystl::copy(str, str + n, data());  // memmove，str可以是自身的一部分
+        set_size(n);
+    }
+    return *this;
+}
+
+template<typename CharT>
+void basic_string<CharT>::resize(sizeType n, CharT c) {
+    const sizeType len = size();
+    if(n > len) {
+        append(n - len, c);
+    } else {
+        set_size(n);
+    }
+}
+
+template<typename CharT>
+void basic_string<CharT>::shrink_to_fit() {
+    if(!is_long() || long_capacity() == size()) return;
+    basic_string temp(data(), size());
+    swap(temp);
+}
+
+template<typename CharT>
+void basic_string<CharT>::push_back(CharT c) {
+    const sizeType len = size();
+    if(len == capacity()) {
+        grow_to(vector_grow_capacity(capacity(), len + 1));
+    }
+    data()[len] = c;
+    set_size(len + 1);
+}
+
+template<typename CharT>
+basic_string<CharT>& basic_string<CharT>::append(const CharT* str, sizeType n) {
+    const sizeType len = size();
+    if(len + n > capacity()) {
+        // str 可能指向自身，先拷贝到新的空间，再释放旧的空间
+        const sizeType newCap = vector_grow_capacity(capacity(), len + n);
+        CharT* newData = data_allocator::allocate(newCap + 1);
+        mystl::copy(data(), data() + len, newData);
+        mystl::copy(str, str + n, newData + len);
+        if(is_long()) data_allocator::deallocate(rep.l.ptr, long_capacity() + 1);
+        rep.l.ptr = newData;
+        rep.l.cap = newCap | longFlag;
+    } else {
+        mystl::copy(str, str + n, data() + len);
+    }
+    set_size(len + n);
+    return *this;
+}
+
+template<typename CharT>
+basic_string<CharT>& basic_string<CharT>::append(sizeType n, CharT c) {
+    const sizeType len = size();
+    if(len + n > capacity()) {
+        grow_to(vector_grow_capacity(capacity(), len + n));
+    }
+    mystl::fill_n(data() + len, n, c);
+    set_size(len + n);
+    return *this;
+}
+
+template<typename CharT>
+basic_string<CharT>& basic_string<CharT>::erase(sizeType pos, sizeType n) {
+    const sizeType len = size();
+    assert(pos <= len);
+    n = std::min(n, len - pos);
+    CharT* p = data();
+    mystl::copy(p + pos + n, p + len, p + pos);
+    set_size(len - n);
+    return *this;
+}
+
+template<typename CharT>
+typename basic_string<CharT>::sizeType
+basic_string<CharT>::find(const CharT* str, sizeType pos, sizeType n) const {
+    const sizeType len = size();
+    if(pos > len || n > len - pos) return n == 0 && pos <= len ? pos : npos;
+    const CharT* first = data();
+    const CharT* p = mystl::search(first + pos, first + len, str, str + n);
+    return p == first + len && n != 0 ? npos : static_cast<sizeType>(p - first);
+}
+
+template<typename CharT>
+typename basic_string<CharT>::sizeType
+basic_string<CharT>::find(CharT c, sizeType pos) const {
+    const sizeType len = size();
+    if(pos >= len) return npos;
+    const CharT* first = data();
+    const CharT* p = mystl::find(first + pos, first + len, c);
+    return p == first + len ? npos : static_cast<sizeType>(p - first);
+}
+
+template<typename CharT>
+typename basic_string<CharT>::sizeType
+basic_string<CharT>::rfind(CharT c, sizeType pos) const {
+    const sizeType len = size();
+    if(len == 0) return npos;
+    const CharT* first = data();
+    for(sizeType i = std::min(pos, len - 1) + 1; i > 0; --i) {
+        if(first[i - 1] == c) return i - 1;
+    }
+    return npos;
+}
+
+/*************************************************************************************/
+// helper function                                                                    /
+/*************************************************************************************/
+template<typename CharT>
+void basic_string<CharT>::init(const CharT* str, sizeType n) {
+    if(n <= smallCapacity) {
+        mystl::copy(str, str + n, rep.s);
+        set_small_size(n);
+    } else {
+        CharT* p = data_allocator::allocate(n + 1);
+        mystl::copy(str, str + n, p);
+        p[n] = CharT();
+        rep.l.ptr = p;
+        rep.l.size = n;
+        rep.l.cap = n | longFlag;
+    }
+}
+
+// 扩容到能放下n个字符，之后一定是长字符串
+template<typename CharT>
+void basic_string<CharT>::grow_to(sizeType n) {
+    const sizeType len = size();
+    CharT* newData = data_allocator::allocate(n + 1);
+    mystl::copy(data(), data() + len + 1, newData);
+    if(is_long()) data_allocator::deallocate(rep.l.ptr, long_capacity() + 1);
+    rep.l.ptr = newData;
+    rep.l.size = len;
+    rep.l.cap = n | longFlag;
+}
+
+// 标记为可以平凡重定位，vector扩容时直接memcpy
+template<typename CharT>
+struct is_trivially_relocatable<basic_string<CharT>> : std::true_type {};
+
+// 比较
+template<typename CharT>
+bool operator==(const basic_string<CharT>& x, const basic_string<CharT>& y) {
+    return x.size() == y.size() && x.compare(y) == 0;
+}
+template<typename CharT>
+bool operator==(const basic_string<CharT>& x, const CharT* y) { return x.compare(y) == 0; }
+template<typename CharT>
+bool operator!=(const basic_string<CharT>& x, const basic_string<CharT>& y) { return !(x == y); }
+template<typename CharT>
+bool operator!=(const basic_string<CharT>& x, const CharT* y) { return !(x == y); }
+template<typename CharT>
+bool operator<(const basic_string<CharT>& x, const basic_string<CharT>& y) { return x.compare(y) < 0; }
+template<typename CharT>
+bool operator>(const basic_string<CharT>& x, const basic_string<CharT>& y) { return y < x; }
+template<typename CharT>
+bool operator<=(const basic_string<CharT>& x, const basic_string<CharT>& y) { return !(y < x); }
+template<typename CharT>
+bool operator>=(const basic_string<CharT>& x, const basic_string<CharT>& y) { return !(x < y); }
+
+// 拼接
+template<typename CharT>
+basic_string<CharT> operator+(const basic_string<CharT>& x, const basic_string<CharT>& y) {
+    basic_string<CharT> r;
+    r.reserve(x.size() + y.size());
+    r.append(x);
+    r.append(y);
+    return r;
+}
+template<typename CharT>
+basic_string<CharT> operator+(const basic_string<CharT>& x, const CharT* y) {
+    basic_string<CharT> r(x);
+    r.append(y);
+    return r;
+}
+template<typename CharT>
+basic_string<CharT> operator+(basic_string<CharT>&& x, const basic_string<CharT>& y) {
+    x.append(y);
+    return std::move(x);
+}
+
+template<typename CharT>
+std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, const basic_string<CharT>& str) {
+    return os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+template<typename CharT>
+void swap(basic_string<CharT>& x, basic_string<CharT>& y) {
+    x.swap(y);
+}
+
+typedef basic_string<char>      string;
+typedef basic_string<wchar_t>   wstring;
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,935 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+// btree_map / btree_set 基于B+树的有序关联容器
+// 每个结点的大小是 BTREE_NODE_BYTES(默认4条cache line)，一个结点里放几十个key，
+// key在结点内连续存放(map的value单独放一个数组)，结点内查找是对连续key数组的无分支计数，
+// 比红黑树每个元素一个结点、三个指针的开销小得多；所有元素都在叶子上，叶子之间用双向链表相连，
+// 区间遍历只是顺序扫描叶子
+//
+// 删除时叶子变空就释放，叶子元素太少时和同一父结点下的相邻叶子合并，内部结点不做再平衡
+// 插入和删除会使所有迭代器失效
+
+#include "allocator.h"
+#include "type_traits.h"
+#include "vector.h"
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <string.h>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef BTREE_NODE_BYTES
+#define BTREE_NODE_BYTES 256
+#endif
+
+// btree_set 的"value"，不占空间
+struct btreeEmpty {};
+
+// 把[first, first + n)搬到result，两段可以重叠，搬完之后源位置视为未初始化
+template<typename T>
+void __btree_relocate(T* first, size_t n, T* result, std::true_type) {
+    if(n) memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+}
+
+template<typename T>
+void __btree_relocate(T* first, size_t n, T* result, std::false_type) {
+    if(result < first) {
+        for(size_t i = 0; i < n; ++i) {
+            mystl::construct(result + i, std::move(first[i]));
+            mystl::destory(first + i);
+        }
+    } else {
+        for(size_t i = n; i > 0; --i) {
+            mystl::construct(result + i - 1, std::move(first[i - 1]));
+            mystl::destory(first + i - 1);
+        }
+    }
+}
+
+template<typename T>
+void btree_relocate(T* first, size_t n, T* result) {
+    __btree_relocate(first, n, result,
+                     std::integral_constant<bool, is_trivially_relocatable<T>::value>());
+}
+
+constexpr inline size_t btree_clamp_slots(size_t n) {
+    return n < 4 ? 4 : (n > 1024 ? 1024 : n);
+}
+
+// 结点的容量，由key和value的大小决定
+template<typename Key, typename Mapped>
+struct btreeParams {
+    static constexpr size_t mappedSize = std::is_same<Mapped, btreeEmpty>::value ? 0 : sizeof(Mapped);
+    static constexpr size_t leafHeader = 4 * sizeof(void*);
+    static constexpr size_t innerHeader = 2 * sizeof(void*);
+
+    static constexpr size_t leafSlots =
+        btree_clamp_slots((BTREE_NODE_BYTES - leafHeader) / (sizeof(Key) + mappedSize));
+    static constexpr size_t innerSlots =
+        btree_clamp_slots((BTREE_NODE_BYTES - innerHeader - sizeof(void*)) / (sizeof(Key) + sizeof(void*)));
+};
+
+// 未初始化的数组
+template<typename T, size_t N>
+struct btreeArray {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[N];
+
+    T*       data()       { return reinterpret_cast<T*>(buf); }
+    const T* data() const { return reinterpret_cast<const T*>(buf); }
+};
+
+template<size_t N>
+struct btreeArray<btreeEmpty, N> {
+    btreeEmpty*       data()       { return nullptr; }
+    const btreeEmpty* data() const { return nullptr; }
+};
+
+template<typename Key, typename Mapped> struct btreeInner;
+
+template<typename Key, typename Mapped>
+struct btreeNodeBase {
+    btreeInner<Key, Mapped>*    parent;
+    unsigned short              count;      // 叶子是元素个数，内部结点是key的个数(孩子数 - 1)
+    unsigned short              slot;       // 在父结点中是第几个孩子
+    bool                        isLeaf;
+};
+
+template<typename Key, typename Mapped>
+struct btreeInner : public btreeNodeBase<Key, Mapped> {
+    typedef btreeParams<Key, Mapped>    params;
+    typedef btreeNodeBase<Key, Mapped>  nodeBase;
+
+    btreeArray<Key, params::innerSlots>     keys;
+    nodeBase*                               child[params::innerSlots + 1];
+
+    Key* key() { return keys.data(); }
+};
+
+template<typename Key, typename Mapped>
+struct btreeLeaf : public btreeNodeBase<Key, Mapped> {
+    typedef btreeParams<Key, Mapped>    params;
+
+    btreeLeaf*                              prev;
+    btreeLeaf*                              next;
+    btreeArray<Key, params::leafSlots>      keys;
+    btreeArray<Mapped, params::leafSlots>   vals;
+
+    Key*          key()       { return keys.data(); }
+    const Key*    key() const { return keys.data(); }
+    Mapped*       val()       { return vals.data(); }
+    const Mapped* val() const { return vals.data(); }
+};
+
+// map 的迭代器解引用得到 (key, value) 的代理，key和value不在一起存放
+template<typename Key, typename T>
+struct btreeMapRef {
+    const Key&  first;
+    T&          second;
+
+    btreeMapRef(const Key& k, T& v) : first(k), second(v) {}
+    operator std::pair<Key, typename std::remove_const<T>::type>() const {
+        return std::pair<Key, typename std::remove_const<T>::type>(first, second);
+    }
+    const btreeMapRef* operator->() const { return this; }
+};
+
+template<typename Key, typename Mapped, bool Const>
+struct btreeRefTraits {
+    typedef typename std::conditional<Const, const Mapped, Mapped>::type    mappedType;
+    typedef btreeMapRef<Key, mappedType>                                    reference;
+    typedef reference                                                       pointer;
+    typedef btreeLeaf<Key, Mapped>                                          leafType;
+
+    static reference get(leafType* leaf, size_t i) { return reference(leaf->key()[i], leaf->val()[i]); }
+};
+
+template<typename Key, bool Const>
+struct btreeRefTraits<Key, btreeEmpty, Const> {
+    typedef const Key&                      reference;
+    typedef const Key*                      pointer;
+    typedef btreeLeaf<Key, btreeEmpty>      leafType;
+
+    static reference get(leafType* leaf, size_t i) { return leaf->key()[i]; }
+};
+
+/**
+ * @brief B+树的迭代器，双向迭代器，保存叶子和叶子中的下标
+ *        end() 是最右叶子的 count 位置，空树是 (nullptr, 0)
+ */
+template<typename Key, typename Mapped, bool Const>
+struct btreeIterator {
+    typedef bidirectional_iterator_tag                              iterator_category;
+    typedef btreeIterator<Key, Mapped, false>                       iterator;
+    typedef btreeIterator                                           self;
+    typedef btreeRefTraits<Key, Mapped, Const>                      traits;
+    typedef btreeLeaf<Key, Mapped>                                  leafType;
+
+    typedef typename std::conditional<std::is_same<Mapped, btreeEmpty>::value,
+                Key, std::pair<const Key, Mapped>>::type            value_type;
+    typedef typename traits::reference                              reference;
+    typedef typename traits::pointer                                pointer;
+    typedef ptrdiff_t                                               difference_type;
+    typedef size_t                                                  sizeType;
+
+    leafType*   leaf;
+    sizeType    index;
+
+    btreeIterator() noexcept : leaf(nullptr), index(0) {}
+    btreeIterator(leafType* l, sizeType i) noexcept : leaf(l), index(i) {}
+    btreeIterator(const iterator& it) noexcept : leaf(it.leaf), index(it.index) {}
+
+    btreeIterator& operator=(const btreeIterator&) = default;
+
+    reference operator*()  const { return traits::get(leaf, index); }
+    pointer   operator->() const { return arrow(std::is_same<Mapped, btreeEmpty>()); }
+    const Key& key()       const { return leaf->key()[index]; }
+
+    self& operator++() {
+        ++index;
+        if(index == leaf->count && leaf->next != nullptr) {
+            leaf = leaf->next;
+            index = 0;
+        }
+        return *this;
+    }
+    self& operator--() {
+        if(index == 0) {
+            leaf = leaf->prev;
+            index = leaf->count;
+        }
+        --index;
+        return *this;
+    }
+    self operator++(int) { self temp = *this; ++*this; return temp; }
+    self operator--(int) { self temp = *this; --*this; return temp; }
+
+    bool operator==(const self& x) const { return leaf == x.leaf && index == x.index; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+
+private:
+    pointer arrow(std::true_type)  const { return &leaf->key()[index]; }
+    pointer arrow(std::false_type) const { return traits::get(leaf, index); }
+};
+
+/**
+ * @brief B+树，key唯一；Mapped 为 btreeEmpty 时是set
+ *        内部结点的第i个key是第i+1个孩子子树中最小key的副本(或者更小)，
+ *        等于key的元素在key右边的子树中
+ *
+ * @tparam Key
+ * @tparam Mapped
+ * @tparam Compare
+ */
+template<typename Key, typename Mapped, typename Compare>
+class btree {
+public:
+    typedef Key                                         keyType;
+    typedef Mapped                                      mappedType;
+    typedef Compare                                     keyCompare;
+    typedef size_t                                      sizeType;
+    typedef ptrdiff_t                                   differenceType;
+
+    typedef btreeIterator<Key, Mapped, false>           iterator;
+    typedef btreeIterator<Key, Mapped, true>            constIterator;
+
+    typedef btreeParams<Key, Mapped>                    params;
+
+    static constexpr sizeType leaf_slots()  { return params::leafSlots; }
+    static constexpr sizeType inner_slots() { return params::innerSlots; }
+
+protected:
+    typedef btreeNodeBase<Key, Mapped>                  nodeBase;
+    typedef btreeInner<Key, Mapped>                     innerType;
+    typedef btreeLeaf<Key, Mapped>                      leafType;
+    typedef mystl::allocator<innerType>                 inner_allocator;
+    typedef mystl::allocator<leafType>                  leaf_allocator;
+
+    static constexpr bool isSet = std::is_same<Mapped, btreeEmpty>::value;
+
+    nodeBase*   root;
+    leafType*   leftmost;
+    leafType*   rightmost;
+    sizeType    nsize;
+    sizeType    nleaves;
+    sizeType    ninners;
+    Compare     comp;
+
+public:
+    btree() noexcept
+    : root(nullptr), leftmost(nullptr), rightmost(nullptr),
+      nsize(0), nleaves(0), ninners(0), comp() {}
+    explicit btree(const Compare& c)
+    : root(nullptr), leftmost(nullptr), rightmost(nullptr),
+      nsize(0), nleaves(0), ninners(0), comp(c) {}
+    // 委托构造，拷贝元素抛出异常时析构函数释放已经建好的叶子
+    btree(const btree& rhs) : btree(rhs.comp) { copy_from(rhs); }
+    btree(btree&& rhs) noexcept
+    : root(rhs.root), leftmost(rhs.leftmost), rightmost(rhs.rightmost),
+      nsize(rhs.nsize), nleaves(rhs.nleaves), ninners(rhs.ninners), comp(rhs.comp) {
+        rhs.root = nullptr;
+        rhs.leftmost = rhs.rightmost = nullptr;
+        rhs.nsize = rhs.nleaves = rhs.ninners = 0;
+    }
+    ~btree() { clear(); }
+
+    btree& operator=(const btree& rhs) {
+        if(this != &rhs) {
+            btree temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+    btree& operator=(btree&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    // 迭代器相关
+    iterator        begin()       { return iterator(leftmost, 0); }
+    iterator        end()         { return iterator(rightmost, rightmost ? rightmost->count : 0); }
+    constIterator   begin() const { return constIterator(leftmost, 0); }
+    constIterator   end()   const { return constIterator(rightmost, rightmost ? rightmost->count : 0); }
+
+    // 容量
+    bool        empty() const { return nsize == 0; }
+    sizeType    size()  const { return nsize; }
+    sizeType    leaf_count()  const { return nleaves; }
+    sizeType    inner_count() const { return ninners; }
+    sizeType    height() const {
+        sizeType h = 0;
+        for(nodeBase* node = root; node != nullptr; ++h) {
+            node = node->isLeaf ? nullptr : static_cast<innerType*>(node)->child[0];
+        }
+        return h;
+    }
+    // 结点占用的字节数
+    sizeType    memory_usage() const {
+        return nleaves * sizeof(leafType) + ninners * sizeof(innerType);
+    }
+
+    // 查找
+    iterator find(const Key& k) {
+        iterator it = lower_bound(k);
+        return (it != end() && !comp(k, it.key())) ? it : end();
+    }
+    constIterator find(const Key& k) const { return const_cast<btree*>(this)->find(k); }
+    sizeType count(const Key& k) const { return find(k) != end() ? 1 : 0; }
+    bool contains(const Key& k) const { return find(k) != end(); }
+
+    iterator lower_bound(const Key& k) {
+        if(root == nullptr) return end();
+        leafType* leaf = find_leaf(k);
+        return make_iterator(leaf, lower_index(leaf->key(), leaf->count, k));
+    }
+    iterator upper_bound(const Key& k) {
+        if(root == nullptr) return end();
+        leafType* leaf = find_leaf(k);
+        return make_iterator(leaf, upper_index(leaf->key(), leaf->count, k));
+    }
+    constIterator lower_bound(const Key& k) const { return const_cast<btree*>(this)->lower_bound(k); }
+    constIterator upper_bound(const Key& k) const { return const_cast<btree*>(this)->upper_bound(k); }
+
+    // 删除
+    sizeType erase(const Key&);
+    iterator erase(iterator pos) {
+        assert(pos != end());
+        Key k(pos.key());
+        erase(k);
+        return lower_bound(k);
+    }
+    void clear() noexcept;
+
+    void swap(btree& rhs) noexcept {
+        std::swap(root, rhs.root);
+        std::swap(leftmost, rhs.leftmost);
+        std::swap(rightmost, rhs.rightmost);
+        std::swap(nsize, rhs.nsize);
+        std::swap(nleaves, rhs.nleaves);
+        std::swap(ninners, rhs.ninners);
+        std::swap(comp, rhs.comp);
+    }
+
+protected:
+    // 插入key，key已经存在时返回已有元素，args用来构造value
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> insert_unique(K&& k, Args&&... args);
+
+    // 批量构建：按非递减的顺序追加元素，叶子全部填满，最后调用 build_inner 建立内部结点
+    // 只能在空树上使用，比前一个key小时抛出 invalid_argument，出错后调用 clear 释放已经追加的元素
+    template<typename K, typename... Args>
+    void append_sorted(K&& k, Args&&... args) {
+        if(rightmost != nullptr && !comp(rightmost->key()[rightmost->count - 1], k)) {
+            if(comp(k, rightmost->key()[rightmost->count - 1]))
+                throw std::invalid_argument("btree: bulk load input is not sorted");
+            return;     // 重复的key，保留第一个
+        }
+        if(rightmost == nullptr || rightmost->count == params::leafSlots) {
+            leafType* leaf = create_leaf();
+            leaf->prev = rightmost;
+            if(rightmost) rightmost->next = leaf;
+            else leftmost = leaf;
+            rightmost = leaf;
+        }
+        construct_entry(rightmost, rightmost->count, std::forward<K>(k), std::forward<Args>(args)...);
+        ++rightmost->count;
+        ++nsize;
+    }
+    void build_inner();
+
+    void copy_from(const btree& rhs) {
+        for(leafType* leaf = rhs.leftmost; leaf != nullptr; leaf = leaf->next) {
+            for(sizeType i = 0; i < leaf->count; ++i) copy_entry(leaf, i);
+        }
+        build_inner();
+    }
+
+private:
+    // 结点内查找，算术类型的key用无分支的计数(编译器可以向量化)，其他类型用二分
+    sizeType lower_index(const Key* keys, sizeType n, const Key& k) const {
+        return search_index(keys, n, k, std::integral_constant<bool, std::is_arithmetic<Key>::value>(),
+                            std::false_type());
+    }
+    sizeType upper_index(const Key* keys, sizeType n, const Key& k) const {
+        return search_index(keys, n, k, std::integral_constant<bool, std::is_arithmetic<Key>::value>(),
+                            std::true_type());
+    }
+    // 第一个 >= k (Upper为false) 或 > k (Upper为true) 的位置
+    template<bool Upper>
+    sizeType search_index(const Key* keys, sizeType n, const Key& k, std::true_type,
+                          std::integral_constant<bool, Upper>) const {
+        sizeType r = 0;
+        for(sizeType i = 0; i < n; ++i) {
+            r += Upper ? !comp(k, keys[i]) : comp(keys[i], k);
+        }
+        return r;
+    }
+    template<bool Upper>
+    sizeType search_index(const Key* keys, sizeType n, const Key& k, std::false_type,
+                          std::integral_constant<bool, Upper>) const {
+        sizeType lo = 0, hi = n;
+        while(lo < hi) {
+            const sizeType mid = (lo + hi) / 2;
+            const bool right = Upper ? !comp(k, keys[mid]) : comp(keys[mid], k);
+            if(right) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    leafType* find_leaf(const Key& k) const {
+        nodeBase* node = root;
+        while(!node->isLeaf) {
+            innerType* inner = static_cast<innerType*>(node);
+            node = inner->child[upper_index(inner->key(), inner->count, k)];
+        }
+        return static_cast<leafType*>(node);
+    }
+
+    // 叶子末尾的位置转到下一个叶子的开头
+    iterator make_iterator(leafType* leaf, sizeType i) {
+        if(i == leaf->count && leaf->next != nullptr) return iterator(leaf->next, 0);
+        return iterator(leaf, i);
+    }
+
+    // 元素的构造、析构和搬移，set没有value
+    template<typename K, typename... Args>
+    void construct_entry(leafType* leaf, sizeType i, K&& k, Args&&... args) {
+        mystl::construct(leaf->key() + i, std::forward<K>(k));
+        try {
+            construct_value(leaf, i, std::integral_constant<bool, isSet>(), std::forward<Args>(args)...);
+        } catch(...) {
+            mystl::destory(leaf->key() + i);
+            throw;
+        }
+    }
+    template<typename... Args>
+    void construct_value(leafType*, sizeType, std::true_type, Args&&...) {}
+    template<typename... Args>
+    void construct_value(leafType* leaf, sizeType i, std::false_type, Args&&... args) {
+        mystl::construct(leaf->val() + i, std::forward<Args>(args)...);
+    }
+    void copy_entry(leafType* leaf, sizeType i) { copy_entry(leaf, i, std::integral_constant<bool, isSet>()); }
+    void copy_entry(leafType* leaf, sizeType i, std::true_type)  { append_sorted(leaf->key()[i]); }
+    void copy_entry(leafType* leaf, sizeType i, std::false_type) { append_sorted(leaf->key()[i], leaf->val()[i]); }
+
+    void destroy_entries(leafType* leaf, sizeType first, sizeType last) {
+        mystl::destory(leaf->key() + first, leaf->key() + last);
+        destroy_values(leaf, first, last, std::integral_constant<bool, isSet>());
+    }
+    void destroy_values(leafType*, sizeType, sizeType, std::true_type) {}
+    void destroy_values(leafType* leaf, sizeType first, sizeType last, std::false_type) {
+        mystl::destory(leaf->val() + first, leaf->val() + last);
+    }
+
+    // 把from的[first, first + n)搬到to的pos位置，to和from可以是同一个叶子
+    void relocate_entries(leafType* from, sizeType first, sizeType n, leafType* to, sizeType pos) {
+        btree_relocate(from->key() + first, n, to->key() + pos);
+        relocate_values(from, first, n, to, pos, std::integral_constant<bool, isSet>());
+    }
+    void relocate_values(leafType*, sizeType, sizeType, leafType*, sizeType, std::true_type) {}
+    void relocate_values(leafType* from, sizeType first, sizeType n, leafType* to, sizeType pos,
+                         std::false_type) {
+        btree_relocate(from->val() + first, n, to->val() + pos);
+    }
+
+    // 结点的申请和释放
+    leafType* create_leaf() {
+        leafType* leaf = leaf_allocator::allocate();
+        leaf->parent = nullptr;
+        leaf->count = 0;
+        leaf->slot = 0;
+        leaf->isLeaf = true;
+        leaf->prev = leaf->next = nullptr;
+        ++nleaves;
+        return leaf;
+    }
+    innerType* create_inner() {
+        innerType* inner = inner_allocator::allocate();
+        inner->parent = nullptr;
+        inner->count = 0;
+        inner->slot = 0;
+        inner->isLeaf = false;
+        ++ninners;
+        return inner;
+    }
+    void free_leaf(leafType* leaf) {
+        leaf_allocator::deallocate(leaf);
+        --nleaves;
+    }
+    void free_inner(innerType* inner) {
+        inner_allocator::deallocate(inner);
+        --ninners;
+    }
+    void set_child(innerType* inner, sizeType i, nodeBase* node) {
+        inner->child[i] = node;
+        node->parent = inner;
+        node->slot = static_cast<unsigned short>(i);
+    }
+
+    // node 是否在它这一层的最右边
+    bool on_right_edge(nodeBase* node) const {
+        for(; node != root; node = node->parent) {
+            if(node->slot != node->parent->count) return false;
+        }
+        return true;
+    }
+
+    void insert_into_parent(nodeBase* left, const Key& sep, nodeBase* right);
+    void insert_inner_at(innerType* inner, sizeType pos, const Key& sep, nodeBase* right);
+    void remove_child(innerType* inner, sizeType i);
+    void remove_leaf(leafType* leaf);
+    void destroy_subtree(nodeBase* node) noexcept;
+};
+
+template<typename Key, typename Mapped, typename Compare>
+constexpr bool btree<Key, Mapped, Compare>::isSet;
+
+template<typename Key, typename Mapped, typename Compare>
+template<typename K, typename... Args>
+std::pair<typename btree<Key, Mapped, Compare>::iterator, bool>
+btree<Key, Mapped, Compare>::insert_unique(K&& k, Args&&... args) {
+    if(root == nullptr) {
+        leafType* leaf = create_leaf();
+        root = leftmost = rightmost = leaf;
+    }
+    leafType* leaf = find_leaf(k);
+    sizeType i = lower_index(leaf->key(), leaf->count, k);
+    if(i < leaf->count && !comp(k, leaf->key()[i])) {
+        return std::make_pair(iterator(leaf, i), false);
+    }
+
+    if(leaf->count < params::leafSlots) {
+        relocate_entries(leaf, i, leaf->count - i, leaf, i + 1);
+        try {
+            construct_entry(leaf, i, std::forward<K>(k), std::forward<Args>(args)...);
+        } catch(...) {
+            relocate_entries(leaf, i + 1, leaf->count - i, leaf, i);
+            throw;
+        }
+        ++leaf->count;
+        ++nsize;
+        return std::make_pair(iterator(leaf, i), true);
+    }
+
+    // 叶子已满，分裂
+    // 在最右叶子的末尾插入(按顺序追加)时不搬移元素，新叶子只放新元素，叶子保持全满
+    leafType* right = create_leaf();
+    const sizeType mid = (i == leaf->count && leaf->next == nullptr) ? leaf->count : leaf->count / 2;
+    relocate_entries(leaf, mid, leaf->count - mid, right, 0);
+    right->count = static_cast<unsigned short>(leaf->count - mid);
+    leaf->count = static_cast<unsigned short>(mid);
+    right->next = leaf->next;
+    right->prev = leaf;
+    if(leaf->next) leaf->next->prev = right;
+    else rightmost = right;
+    leaf->next = right;
+
+    leafType* target = leaf;
+    if(i >= mid) {
+        target = right;
+        i -= mid;
+    }
+    try {
+        relocate_entries(target, i, target->count - i, target, i + 1);
+        try {
+            construct_entry(target, i, std::forward<K>(k), std::forward<Args>(args)...);
+        } catch(...) {
+            relocate_entries(target, i + 1, target->count - i, target, i);
+            throw;
+        }
+    } catch(...) {
+        // 撤销分裂
+        relocate_entries(right, 0, right->count, leaf, leaf->count);
+        leaf->count = static_cast<unsigned short>(leaf->count + right->count);
+        leaf->next = right->next;
+        if(right->next) right->next->prev = leaf;
+        else rightmost = leaf;
+        free_leaf(right);
+        throw;
+    }
+    ++target->count;
+    ++nsize;
+    insert_into_parent(leaf, right->key()[0], right);
+    return std::make_pair(iterator(target, i), true);
+}
+
+// right 是 left 分裂出来的新结点，sep 是 right 中最小的key
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::insert_into_parent(nodeBase* left, const Key& sep, nodeBase* right) {
+    if(left == root) {
+        innerType* newRoot = create_inner();
+        mystl::construct(newRoot->key(), sep);
+        newRoot->count = 1;
+        set_child(newRoot, 0, left);
+        set_child(newRoot, 1, right);
+        root = newRoot;
+        return;
+    }
+    innerType* parent = left->parent;
+    const sizeType pos = left->slot;
+    if(parent->count < params::innerSlots) {
+        insert_inner_at(parent, pos, sep, right);
+        return;
+    }
+
+    // 父结点已满，分裂
+    innerType* sibling = create_inner();
+    if(pos == parent->count && on_right_edge(parent)) {
+        // 按顺序追加，父结点保持全满，新结点只有right一个孩子，sep上移
+        set_child(sibling, 0, right);
+        insert_into_parent(parent, sep, sibling);
+        return;
+    }
+    // keys[mid] 上移，[0, mid) 留下，(mid, count) 移到新结点
+    const sizeType mid = parent->count / 2;
+    const sizeType moved = parent->count - mid - 1;
+    btree_relocate(parent->key() + mid + 1, moved, sibling->key());
+    for(sizeType j = 0; j <= moved; ++j) set_child(sibling, j, parent->child[mid + 1 + j]);
+    sibling->count = static_cast<unsigned short>(moved);
+    Key up(std::move(parent->key()[mid]));
+    mystl::destory(parent->key() + mid);
+    parent->count = static_cast<unsigned short>(mid);
+
+    if(pos <= mid) insert_inner_at(parent, pos, sep, right);
+    else insert_inner_at(sibling, pos - mid - 1, sep, right);
+    insert_into_parent(parent, up, sibling);
+}
+
+// 在pos号孩子之后插入孩子right，分隔key为sep
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::insert_inner_at(innerType* inner, sizeType pos,
+                                                  const Key& sep, nodeBase* right) {
+    const sizeType n = inner->count;
+    btree_relocate(inner->key() + pos, n - pos, inner->key() + pos + 1);
+    mystl::construct(inner->key() + pos, sep);
+    for(sizeType j = n + 1; j > pos + 1; --j) set_child(inner, j, inner->child[j - 1]);
+    set_child(inner, pos + 1, right);
+    inner->count = static_cast<unsigned short>(n + 1);
+}
+
+template<typename Key, typename Mapped, typename Compare>
+typename btree<Key, Mapped, Compare>::sizeType btree<Key, Mapped, Compare>::erase(const Key& k) {
+    if(root == nullptr) return 0;
+    leafType* leaf = find_leaf(k);
+    const sizeType i = lower_index(leaf->key(), leaf->count, k);
+    if(i == leaf->count || comp(k, leaf->key()[i])) return 0;
+
+    destroy_entries(leaf, i, i + 1);
+    relocate_entries(leaf, i + 1, leaf->count - i - 1, leaf, i);
+    --leaf->count;
+    --nsize;
+
+    if(leaf->count == 0) {
+        remove_leaf(leaf);
+        return 1;
+    }
+    // 元素太少时和同一父结点下的相邻叶子合并
+    if(leaf == root || leaf->count >= params::leafSlots / 4) return 1;
+    leafType* next = leaf->next;
+    leafType* prev = leaf->prev;
+    if(next != nullptr && next->parent == leaf->parent &&
+       leaf->count + next->count <= params::leafSlots / 2) {
+        relocate_entries(next, 0, next->count, leaf, leaf->count);
+        leaf->count = static_cast<unsigned short>(leaf->count + next->count);
+        next->count = 0;
+        remove_leaf(next);
+    } else if(prev != nullptr && prev->parent == leaf->parent &&
+              leaf->count + prev->count <= params::leafSlots / 2) {
+        relocate_entries(leaf, 0, leaf->count, prev, prev->count);
+        prev->count = static_cast<unsigned short>(prev->count + leaf->count);
+        leaf->count = 0;
+        remove_leaf(leaf);
+    }
+    return 1;
+}
+
+// 释放一个空叶子
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::remove_leaf(leafType* leaf) {
+    if(leaf->prev) leaf->prev->next = leaf->next;
+    else leftmost = leaf->next;
+    if(leaf->next) leaf->next->prev = leaf->prev;
+    else rightmost = leaf->prev;
+    innerType* parent = leaf->parent;
+    const sizeType slot = leaf->slot;
+    free_leaf(leaf);
+    if(parent == nullptr) root = nullptr;
+    else remove_child(parent, slot);
+}
+
+// 删除第i个孩子(已经释放)以及它左边的分隔key(i为0时删除右边的)
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::remove_child(innerType* inner, sizeType i) {
+    if(inner->count == 0) {
+        // 唯一的孩子被删除，结点本身也删除
+        innerType* parent = inner->parent;
+        const sizeType slot = inner->slot;
+        free_inner(inner);
+        if(parent == nullptr) root = nullptr;
+        else remove_child(parent, slot);
+        return;
+    }
+    const sizeType n = inner->count;
+    const sizeType ki = i > 0 ? i - 1 : 0;
+    mystl::destory(inner->key() + ki);
+    btree_relocate(inner->key() + ki + 1, n - ki - 1, inner->key() + ki);
+    for(sizeType j = i; j < n; ++j) set_child(inner, j, inner->child[j + 1]);
+    inner->count = static_cast<unsigned short>(n - 1);
+
+    // 根只剩一个孩子时降低树高
+    while(root == inner && inner->count == 0) {
+        root = inner->child[0];
+        root->parent = nullptr;
+        root->slot = 0;
+        free_inner(inner);
+        if(root->isLeaf) break;
+        inner = static_cast<innerType*>(root);
+    }
+}
+
+// 叶子已经通过 append_sorted 建好，自底向上建立内部结点
+// 抛出异常时释放已经建立的内部结点，叶子保持原样，由 clear 释放
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::build_inner() {
+    if(leftmost == nullptr) {
+        root = nullptr;
+        return;
+    }
+    // 当前层的结点和每个结点子树中最小的key
+    mystl::vector<nodeBase*> level;
+    mystl::vector<const Key*> mins;
+    // 每个内部结点至少有两个孩子，内部结点数少于叶子数，事先reserve之后记录不会失败
+    mystl::vector<innerType*> inners;
+    inners.reserve(nleaves);
+    for(leafType* leaf = leftmost; leaf != nullptr; leaf = leaf->next) {
+        level.push_back(leaf);
+        mins.push_back(leaf->key());
+    }
+    const sizeType fanout = params::innerSlots + 1;
+    try {
+        while(level.size() > 1) {
+            mystl::vector<nodeBase*> upper;
+            mystl::vector<const Key*> upperMins;
+            const sizeType n = level.size();
+            for(sizeType first = 0; first < n; ) {
+                sizeType cnt = n - first < fanout ? n - first : fanout;
+                // 避免最后一个结点只有一个孩子
+                if(n - first - cnt == 1) --cnt;
+                innerType* inner = create_inner();
+                inners.push_back(inner);
+                for(sizeType j = 0; j < cnt; ++j) {
+                    set_child(inner, j, level[first + j]);
+                    if(j > 0) {
+                        mystl::construct(inner->key() + j - 1, *mins[first + j]);
+                        inner->count = static_cast<unsigned short>(j);
+                    }
+                }
+                upper.push_back(inner);
+                upperMins.push_back(mins[first]);
+                first += cnt;
+            }
+            level.swap(upper);
+            mins.swap(upperMins);
+        }
+    } catch(...) {
+        for(sizeType i = 0; i < inners.size(); ++i) {
+            mystl::destory(inners[i]->key(), inners[i]->key() + inners[i]->count);
+            free_inner(inners[i]);
+        }
+        throw;
+    }
+    root = level[0];
+    root->parent = nullptr;
+    root->slot = 0;
+}
+
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::clear() noexcept {
+    if(root != nullptr) destroy_subtree(root);
+    else {
+        // 批量构建还没有建立内部结点
+        while(leftmost != nullptr) {
+            leafType* next = leftmost->next;
+            destroy_entries(leftmost, 0, leftmost->count);
+            free_leaf(leftmost);
+            leftmost = next;
+        }
+    }
+    root = nullptr;
+    leftmost = rightmost = nullptr;
+    nsize = 0;
+}
+
+template<typename Key, typename Mapped, typename Compare>
+void btree<Key, Mapped, Compare>::destroy_subtree(nodeBase* node) noexcept {
+    if(node->isLeaf) {
+        leafType* leaf = static_cast<leafType*>(node);
+        destroy_entries(leaf, 0, leaf->count);
+        free_leaf(leaf);
+        return;
+    }
+    innerType* inner = static_cast<innerType*>(node);
+    for(sizeType j = 0; j <= inner->count; ++j) destroy_subtree(inner->child[j]);
+    mystl::destory(inner->key(), inner->key() + inner->count);
+    free_inner(inner);
+}
+
+/**
+ * @brief 有序map，key唯一
+ *        迭代器解引用得到 btreeMapRef，它有 first(const Key&) 和 second(T&) 两个成员
+ */
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class btree_map : public btree<Key, T, Compare> {
+    typedef btree<Key, T, Compare>                      base;
+
+public:
+    typedef typename base::iterator                     iterator;
+    typedef typename base::constIterator                constIterator;
+    typedef typename base::sizeType                     sizeType;
+    typedef std::pair<Key, T>                           valueType;
+
+    btree_map() = default;
+    explicit btree_map(const Compare& c) : base(c) {}
+    // 从按key非递减的数组批量构建，重复的key只保留第一个，O(n)
+    // key没有排好序时抛出 invalid_argument
+    explicit btree_map(const mystl::vector<valueType>& sorted, const Compare& c = Compare())
+    : base(c) {
+        bulk_load(sorted.begin(), sorted.end());
+    }
+
+    template<typename Iter>
+    void bulk_load(Iter first, Iter last) {
+        this->clear();
+        try {
+            for(; first != last; ++first) this->append_sorted((*first).first, (*first).second);
+            this->build_inner();
+        } catch(...) {
+            this->clear();
+            throw;
+        }
+    }
+
+    std::pair<iterator, bool> insert(const valueType& x) { return this->insert_unique(x.first, x.second); }
+    std::pair<iterator, bool> insert(const Key& k, const T& v) { return this->insert_unique(k, v); }
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const Key& k, Args&&... args) {
+        return this->insert_unique(k, std::forward<Args>(args)...);
+    }
+    // key存在时覆盖value
+    std::pair<iterator, bool> insert_or_assign(const Key& k, const T& v) {
+        std::pair<iterator, bool> r = this->insert_unique(k, v);
+        if(!r.second) (*r.first).second = v;
+        return r;
+    }
+
+    T& operator[](const Key& k) { return (*this->insert_unique(k).first).second; }
+    T& at(const Key& k) {
+        iterator it = this->find(k);
+        if(it == this->end()) throw std::out_of_range("btree_map::at");
+        return (*it).second;
+    }
+    const T& at(const Key& k) const {
+        constIterator it = this->find(k);
+        if(it == this->end()) throw std::out_of_range("btree_map::at");
+        return (*it).second;
+    }
+};
+
+/**
+ * @brief 有序set，key唯一
+ */
+template<typename Key, typename Compare = std::less<Key>>
+class btree_set : public btree<Key, btreeEmpty, Compare> {
+    typedef btree<Key, btreeEmpty, Compare>             base;
+
+public:
+    typedef typename base::iterator                     iterator;
+    typedef typename base::constIterator                constIterator;
+    typedef typename base::sizeType                     sizeType;
+    typedef Key                                         valueType;
+
+    btree_set() = default;
+    explicit btree_set(const Compare& c) : base(c) {}
+    // 从非递减的数组批量构建，重复的key只保留第一个，O(n)
+    // 没有排好序时抛出 invalid_argument
+    explicit btree_set(const mystl::vector<Key>& sorted, const Compare& c = Compare())
+    : base(c) {
+        bulk_load(sorted.begin(), sorted.end());
+    }
+
+    template<typename Iter>
+    void bulk_load(Iter first, Iter last) {
+        this->clear();
+        try {
+            for(; first != last; ++first) this->append_sorted(*first);
+            this->build_inner();
+        } catch(...) {
+            this->clear();
+            throw;
+        }
+    }
+
+    std::pair<iterator, bool> insert(const Key& k) { return this->insert_unique(k); }
+    std::pair<iterator, bool> insert(Key&& k) { return this->insert_unique(std::move(k)); }
+};
+
+template<typename Key, typename T, typename Compare>
+void swap(btree_map<Key, T, Compare>& x, btree_map<Key, T, Compare>& y) {
+    x.swap(y);
+}
+
+template<typename Key, typename Compare>
+void swap(btree_set<Key, Compare>& x, btree_set<Key, Compare>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,364 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+// concurrent_vector 多个线程可以同时追加元素、同时按下标读取，元素的地址永远不变
+// 和deque一样用一张表管理分段的存储，但段的大小按几何级数增长：
+// 第0段有 CONCURRENT_VECTOR_FIRST_SEGMENT 个元素，之后第k段有 FIRST << (k-1) 个，
+// 下标所在的段用一次bit scan算出，operator[] 仍然是O(1)，段一旦申请就不会移动，所以不需要重新分配
+// push_back/grow_by 先用原子的fetch_add预留下标，再构造元素，全程不加锁；
+// 第一次用到某一段的线程申请这一段，用CAS发布，竞争失败的一方释放自己申请的空间
+// 每个元素有一个构造标志，构造完成后以release写入，其他线程用 ready(i) 判断是否可以读取
+
+#include "construct.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef CONCURRENT_VECTOR_FIRST_SEGMENT
+#define CONCURRENT_VECTOR_FIRST_SEGMENT 16
+#endif
+
+static_assert(CONCURRENT_VECTOR_FIRST_SEGMENT >= 2 &&
+              (CONCURRENT_VECTOR_FIRST_SEGMENT & (CONCURRENT_VECTOR_FIRST_SEGMENT - 1)) == 0,
+              "CONCURRENT_VECTOR_FIRST_SEGMENT must be a power of two");
+
+// 元素的构造状态
+enum concurrentSlotState : unsigned char {
+    cv_slot_empty = 0,          // 已经预留，还没构造完
+    cv_slot_ready = 1,          // 构造完成，可以读取
+    cv_slot_broken = 2          // 构造时抛出了异常，这个位置永远不可用
+};
+
+template<typename T>
+class concurrent_vector {
+public:
+    typedef T                   value_type;
+    typedef T*                  pointer;
+    typedef const T*            constPointer;
+    typedef T&                  reference;
+    typedef const T&            constReference;
+    typedef size_t              sizeType;
+    typedef ptrdiff_t           differenceType;
+
+    typedef std::atomic<unsigned char> slotFlag;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "concurrent_vector does not support over-aligned types");
+
+private:
+    static constexpr sizeType firstSegment = CONCURRENT_VECTOR_FIRST_SEGMENT;
+    static constexpr sizeType maxSegments = sizeof(sizeType) * 8;
+
+    // 每一段是一块内存：前面是元素，后面紧跟着每个元素的构造标志
+    std::atomic<pointer>    segments[maxSegments];
+    std::atomic<sizeType>   reserved;       // 已经预留出去的下标个数
+
+public:
+    concurrent_vector() noexcept : reserved(0) {
+        for(sizeType k = 0; k < maxSegments; ++k) segments[k].store(nullptr, std::memory_order_relaxed);
+    }
+    explicit concurrent_vector(sizeType n) : concurrent_vector() { grow_by(n); }
+    concurrent_vector(sizeType n, const value_type& value) : concurrent_vector() { grow_by(n, value); }
+    // 元素可能正在被其他线程构造，不支持拷贝和移动
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+    ~concurrent_vector();
+
+    // 段的划分
+    static sizeType segment_index(sizeType i) {
+        return static_cast<sizeType>(63 - __builtin_clzll(
+                   static_cast<unsigned long long>(i | (firstSegment - 1)))) -
+               log2_first() + 1;
+    }
+    static sizeType segment_base(sizeType k) { return k == 0 ? 0 : firstSegment << (k - 1); }
+    static sizeType segment_size(sizeType k) { return k == 0 ? firstSegment : firstSegment << (k - 1); }
+
+    // 容量，并发追加时size()包括正在构造的元素
+    sizeType size() const { return reserved.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    sizeType capacity() const;
+    // 提前申请能放下n个元素的所有段，可以和追加并发
+    void reserve(sizeType n);
+
+    // 元素访问，下标i必须已经构造完成(自己追加的，或者ready(i)为true)
+    reference operator[](sizeType i) { return *slot(i); }
+    constReference operator[](sizeType i) const { return *slot(i); }
+    reference at(sizeType i);
+    constReference at(sizeType i) const;
+    bool ready(sizeType i) const;
+
+    // 追加，返回新元素的下标
+    sizeType push_back(const value_type& value) { return emplace_back(value); }
+    sizeType push_back(value_type&& value) { return emplace_back(std::move(value)); }
+    template<typename... Args>
+    sizeType emplace_back(Args&&... args);
+
+    // 一次预留n个连续的下标并构造，返回第一个下标
+    sizeType grow_by(sizeType n);
+    sizeType grow_by(sizeType n, const value_type& value);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    sizeType grow_by(Iter first, Iter last);
+    // 保证至少有n个元素，不够的用value补上，返回调用前的size(或者n，已经足够时)
+    sizeType grow_to_at_least(sizeType n, const value_type& value = value_type());
+
+    // 以下操作不能和其他操作并发
+    void clear();
+    // 按段遍历已经构造的连续元素 f(pointer, count)
+    template<typename F>
+    void for_each_segment(F f);
+
+private:
+    static constexpr sizeType log2_first() {
+        return __builtin_ctzll(static_cast<unsigned long long>(firstSegment));
+    }
+    pointer slot(sizeType i) const {
+        const sizeType k = segment_index(i);
+        return segments[k].load(std::memory_order_acquire) + (i - segment_base(k));
+    }
+    static slotFlag* flags_of(pointer seg, sizeType k) {
+        return reinterpret_cast<slotFlag*>(reinterpret_cast<char*>(seg) + segment_size(k) * sizeof(T));
+    }
+    slotFlag& flag(sizeType i) const {
+        const sizeType k = segment_index(i);
+        return flags_of(segments[k].load(std::memory_order_acquire), k)[i - segment_base(k)];
+    }
+    pointer ensure_segment(sizeType);
+    void ensure_range(sizeType, sizeType);
+    static pointer allocate_segment(sizeType);
+    static void deallocate_segment(pointer, sizeType);
+    template<typename F>
+    sizeType grow_with(sizeType, F);
+};
+
+template<typename T>
+constexpr typename concurrent_vector<T>::sizeType concurrent_vector<T>::firstSegment;
+template<typename T>
+constexpr typename concurrent_vector<T>::sizeType concurrent_vector<T>::maxSegments;
+
+template<typename T>
+concurrent_vector<T>::~concurrent_vector() {
+    clear();
+    for(sizeType k = 0; k < maxSegments; ++k) {
+        pointer seg = segments[k].load(std::memory_order_relaxed);
+        if(seg) deallocate_segment(seg, k);
+    }
+}
+
+template<typename T>
+typename concurrent_vector<T>::sizeType concurrent_vector<T>::capacity() const {
+    // 段是按顺序用到的，但并发申请时后面的段可能先于前面的段发布，只统计连续的部分
+    sizeType k = 0;
+    while(k < maxSegments && segments[k].load(std::memory_order_acquire)) ++k;
+    return k == 0 ? 0 : segment_base(k - 1) + segment_size(k - 1);
+}
+
+template<typename T>
+void concurrent_vector<T>::reserve(sizeType n) {
+    if(n) ensure_range(0, n);
+}
+
+template<typename T>
+bool concurrent_vector<T>::ready(sizeType i) const {
+    if(i >= size()) return false;
+    const sizeType k = segment_index(i);
+    pointer seg = segments[k].load(std::memory_order_acquire);
+    return seg && flags_of(seg, k)[i - segment_base(k)].load(std::memory_order_acquire) == cv_slot_ready;
+}
+
+template<typename T>
+typename concurrent_vector<T>::reference concurrent_vector<T>::at(sizeType i) {
+    if(!ready(i)) throw std::out_of_range("concurrent_vector::at");
+    return *slot(i);
+}
+
+template<typename T>
+typename concurrent_vector<T>::constReference concurrent_vector<T>::at(sizeType i) const {
+    if(!ready(i)) throw std::out_of_range("concurrent_vector::at");
+    return *slot(i);
+}
+
+template<typename T>
+template<typename... Args>
+typename concurrent_vector<T>::sizeType concurrent_vector<T>::emplace_back(Args&&... args) {
+    const sizeType i = reserved.fetch_add(1, std::memory_order_acq_rel);
+    const sizeType k = segment_index(i);
+    pointer seg = ensure_segment(k);
+    slotFlag& f = flags_of(seg, k)[i - segment_base(k)];
+    try {
+        mystl::construct(seg + (i - segment_base(k)), std::forward<Args>(args)...);
+    } catch(...) {
+        f.store(cv_slot_broken, std::memory_order_release);
+        throw;
+    }
+    f.store(cv_slot_ready, std::memory_order_release);
+    return i;
+}
+
+template<typename T>
+typename concurrent_vector<T>::sizeType concurrent_vector<T>::grow_by(sizeType n) {
+    return grow_with(n, [](pointer p, sizeType) { mystl::construct(p); });
+}
+
+template<typename T>
+typename concurrent_vector<T>::sizeType
+concurrent_vector<T>::grow_by(sizeType n, const value_type& value) {
+    return grow_with(n, [&value](pointer p, sizeType) { mystl::construct(p, value); });
+}
+
+// 前向迭代器先算出个数一次预留；输入迭代器只能逐个追加，下标不保证连续
+template<typename T>
+template<typename Iter, typename>
+typename concurrent_vector<T>::sizeType concurrent_vector<T>::grow_by(Iter first, Iter last) {
+    if(!is_forward_iterator<Iter>::value) {
+        sizeType start = size();
+        bool firstElem = true;
+        for(; first != last; ++first) {
+            sizeType i = emplace_back(*first);
+            if(firstElem) start = i;
+            firstElem = false;
+        }
+        return start;
+    }
+    const sizeType n = static_cast<sizeType>(mystl::distance(first, last));
+    return grow_with(n, [&first](pointer p, sizeType) { mystl::construct(p, *first); ++first; });
+}
+
+template<typename T>
+typename concurrent_vector<T>::sizeType
+concurrent_vector<T>::grow_to_at_least(sizeType n, const value_type& value) {
+    sizeType cur = reserved.load(std::memory_order_acquire);
+    while(cur < n) {
+        if(reserved.compare_exchange_weak(cur, n, std::memory_order_acq_rel)) {
+            // [cur, n) 已经归本线程所有，和grow_with一样逐个构造
+            ensure_range(cur, n);
+            for(sizeType i = cur; i < n; ++i) {
+                const sizeType k = segment_index(i);
+                pointer seg = segments[k].load(std::memory_order_acquire);
+                slotFlag& f = flags_of(seg, k)[i - segment_base(k)];
+                try {
+                    mystl::construct(seg + (i - segment_base(k)), value);
+                } catch(...) {
+                    for(; i < n; ++i) flag(i).store(cv_slot_broken, std::memory_order_release);
+                    throw;
+                }
+                f.store(cv_slot_ready, std::memory_order_release);
+            }
+            return cur;
+        }
+    }
+    return n;
+}
+
+// 预留[start, start + n)，按顺序用 build(p, i) 构造，出错时剩下的位置都标记为不可用
+template<typename T>
+template<typename F>
+typename concurrent_vector<T>::sizeType concurrent_vector<T>::grow_with(sizeType n, F build) {
+    const sizeType start = reserved.fetch_add(n, std::memory_order_acq_rel);
+    if(n == 0) return start;
+    ensure_range(start, start + n);
+    sizeType i = start;
+    try {
+        while(i != start + n) {
+            // 一次处理一段中连续的部分
+            const sizeType k = segment_index(i);
+            pointer seg = segments[k].load(std::memory_order_acquire);
+            slotFlag* flags = flags_of(seg, k);
+            const sizeType base = segment_base(k);
+            const sizeType end = std::min(start + n, base + segment_size(k));
+            for(; i != end; ++i) {
+                build(seg + (i - base), i);
+                flags[i - base].store(cv_slot_ready, std::memory_order_release);
+            }
+        }
+    } catch(...) {
+        for(; i != start + n; ++i) flag(i).store(cv_slot_broken, std::memory_order_release);
+        throw;
+    }
+    return start;
+}
+
+template<typename T>
+void concurrent_vector<T>::clear() {
+    const sizeType n = reserved.load(std::memory_order_relaxed);
+    for(sizeType k = 0; k < maxSegments && segment_base(k) < n; ++k) {
+        pointer seg = segments[k].load(std::memory_order_relaxed);
+        if(seg == nullptr) continue;
+        slotFlag* flags = flags_of(seg, k);
+        const sizeType count = std::min(segment_size(k), n - segment_base(k));
+        for(sizeType j = 0; j < count; ++j) {
+            if(flags[j].load(std::memory_order_relaxed) == cv_slot_ready) mystl::destory(seg + j);
+            flags[j].store(cv_slot_empty, std::memory_order_relaxed);
+        }
+    }
+    reserved.store(0, std::memory_order_release);
+}
+
+template<typename T>
+template<typename F>
+void concurrent_vector<T>::for_each_segment(F f) {
+    const sizeType n = size();
+    for(sizeType k = 0; k < maxSegments && segment_base(k) < n; ++k) {
+        pointer seg = segments[k].load(std::memory_order_acquire);
+        if(seg == nullptr) continue;    // 申请这一段时失败了
+        const sizeType count = std::min(segment_size(k), n - segment_base(k));
+        slotFlag* flags = flags_of(seg, k);
+        // 跳过构造失败的位置，把连续构造好的部分交给f
+        sizeType j = 0;
+        while(j < count) {
+            while(j < count && flags[j].load(std::memory_order_acquire) != cv_slot_ready) ++j;
+            sizeType runStart = j;
+            while(j < count && flags[j].load(std::memory_order_acquire) == cv_slot_ready) ++j;
+            if(j > runStart) f(seg + runStart, j - runStart);
+        }
+    }
+}
+
+/*************************************************************************************/
+// helper function                                                                    /
+/*************************************************************************************/
+template<typename T>
+typename concurrent_vector<T>::pointer concurrent_vector<T>::allocate_segment(sizeType k) {
+    const sizeType n = segment_size(k);
+    pointer seg = static_cast<pointer>(::operator new(n * sizeof(T) + n * sizeof(slotFlag)));
+    slotFlag* flags = flags_of(seg, k);
+    for(sizeType j = 0; j < n; ++j) new(flags + j) slotFlag(cv_slot_empty);
+    return seg;
+}
+
+template<typename T>
+void concurrent_vector<T>::deallocate_segment(pointer seg, sizeType) {
+    ::operator delete(seg);
+}
+
+// 第k段还没有时申请并用CAS发布，多个线程同时申请时只有一个成功
+template<typename T>
+typename concurrent_vector<T>::pointer concurrent_vector<T>::ensure_segment(sizeType k) {
+    pointer seg = segments[k].load(std::memory_order_acquire);
+    if(seg) return seg;
+    pointer fresh = allocate_segment(k);
+    if(segments[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+        return fresh;
+    }
+    deallocate_segment(fresh, k);
+    return seg;
+}
+
+// 保证下标[first, last)所在的段都已经申请
+template<typename T>
+void concurrent_vector<T>::ensure_range(sizeType first, sizeType last) {
+    const sizeType lastSeg = segment_index(last - 1);
+    for(sizeType k = segment_index(first); k <= lastSeg; ++k) ensure_segment(k);
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -2,59 +2,72 @@
 #define CONSTRUCT_H
 
 #include <new>
+#include <utility>
+#include <memory>
 
 #include "iterator.h"
+#include "type_traits.h"
 
 namespace mystl {
 
+// 常量求值中不能用placement new，c++20 下改用 std::construct_at
+template<typename T, typename... Args>
+MYSTL_CONSTEXPR20 T* construct_at(T* ptr, Args&&... args) {
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+    return std::construct_at(ptr, std::forward<Args>(args)...);
+#else
+    return ::new(static_cast<void*>(ptr)) T(std::forward<Args>(args)...);
+#endif
+}
+
 // construct
 template<typename T>
-void construct(T* ptr) {
-    new(ptr) T();
+MYSTL_CONSTEXPR20 void construct(T* ptr) {
+    mystl::construct_at(ptr);
 }
 
 template<typename T>
-void construct(T* ptr, const T& t) {
-    new(ptr) T(t);
+MYSTL_CONSTEXPR20 void construct(T* ptr, const T& t) {
+    mystl::construct_at(ptr, t);
 }
 
 template<typename T>
-void construct(T* ptr, T&& t) {
-    new(ptr) T(std::forward<T>(t));
+MYSTL_CONSTEXPR20 void construct(T* ptr, T&& t) {
+    mystl::construct_at(ptr, std::forward<T>(t));
 }
 
 template<typename T, typename... Args>
-void construct(T* ptr, Args&&... args) {
-    new(ptr) T(std::forward<Args>(args)...);
+MYSTL_CONSTEXPR20 void construct(T* ptr, Args&&... args) {
+    mystl::construct_at(ptr, std::forward<Args>(args)...);
 }
 
 // destory
 template<typename _Tp>
-void __destory(_Tp, std::true_type) {}
+MYSTL_CONSTEXPR20 void __destory(_Tp, std::true_type) {}
 
 template<typename _Tp>
-void __destory(_Tp* ptr, std::false_type) {
+MYSTL_CONSTEXPR20 void __destory(_Tp* ptr, std::false_type) {
     ptr->~_Tp();
 }
 
 template<typename _Tp>
-void destory(_Tp* ptr) {
+MYSTL_CONSTEXPR20 void destory(_Tp* ptr) {
     __destory(ptr, std::is_trivially_destructible<_Tp>());
 }
 
 template<typename ForwardIterator>
-void __destory_aux(ForwardIterator, ForwardIterator, std::true_type) {}
+MYSTL_CONSTEXPR20 void __destory_aux(ForwardIterator, ForwardIterator, std::true_type) {}
 
 template<typename ForwardIterator>
-void __destory_aux(ForwardIterator first, ForwardIterator last,
-                   std::false_type) {
+MYSTL_CONSTEXPR20 void __destory_aux(ForwardIterator first, ForwardIterator last,
+                                     std::false_type) {
     for(; first != last; first++) {
         destory(&*first);
     }
 }
 
 template<typename ForwardIterator>
-void destory(ForwardIterator first, ForwardIterator last) {
+MYSTL_CONSTEXPR20 void destory(ForwardIterator first, ForwardIterator last) {
     typedef typename iterator_traits<ForwardIterator>::value_type value_type;
     __destory_aux(first, last, 
                  std::is_trivially_destructible<value_type>());
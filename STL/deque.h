@@ -4,8 +4,10 @@
 // deque 允许常数时间内对头端或尾端进行元素的插入或移除操作
 
 #include "allocator.h"
+#include "aligned_allocator.h"
 #include "algobase.h"
 #include "uninitialized.h"
+#include "stats.h"
 
 #include <memory>
 #include <assert.h>
@@ -14,6 +16,16 @@
 #define DEQUE_MAP_SIZE 8
 #endif
 
+// 为1时，deque在释放缓冲区后如果map的使用率低于 1/DEQUE_SHRINK_FACTOR 就自动收缩map并释放空闲的缓冲区
+// 收缩会使所有迭代器失效(元素的地址不变)，所以默认关闭，也可以随时手动调用shrink_to_fit
+#ifndef DEQUE_AUTO_SHRINK
+#define DEQUE_AUTO_SHRINK 0
+#endif
+
+#ifndef DEQUE_SHRINK_FACTOR
+#define DEQUE_SHRINK_FACTOR 4
+#endif
+
 
 namespace mystl {
 
@@ -32,6 +44,15 @@ constexpr inline size_t deque_buf_size(size_t __size) {
             ? size_t(DEQUE_BUF_SIZE / __size) : size_t(1));
 }
 
+// 缓冲区的对齐字节数，0 表示按 alignof(T)，用法同 VECTOR_ALIGNMENT
+// 缓冲区长度会补齐到对齐的整数倍，按页对齐时最好把 DEQUE_BUF_SIZE 也设成页大小
+#ifndef DEQUE_BUF_ALIGNMENT
+#define DEQUE_BUF_ALIGNMENT 0
+#endif
+
+template<typename T>
+struct deque_buf_alignment : std::integral_constant<size_t, DEQUE_BUF_ALIGNMENT> {};
+
 /**
  * @brief deque的迭代器
  * 
@@ -104,7 +125,7 @@ struct dequeIterator : public iterator<random_access_iterator_tag, T> {
         return temp;
     }
 
-    reference operator[](differenceType n) { return *(*this + n); }
+    reference operator[](differenceType n) const { return *(*this + n); }
 
 
     // 重载 += + -= -
@@ -164,12 +185,14 @@ struct dequeIterator : public iterator<random_access_iterator_tag, T> {
  * 
  * @tparam T 
  */
-template<typename T>
-class deque {
+template<typename T,
+         typename Alloc = typename aligned_allocator_for<T, deque_buf_alignment<T>::value>::type>
+class deque : private allocator_holder<Alloc> {
 public:
-    // deque 型别定义
-    typedef mystl::allocator<T>                             data_allocator;
-    typedef mystl::allocator<T*>                            map_allocator;
+    // deque 型别定义，map 和缓冲区来自同一个分配器
+    typedef Alloc                                           data_allocator;
+    typedef Alloc                                           allocator_type;
+    typedef typename Alloc::template rebind<T*>::other      map_allocator;
     typedef typename data_allocator::value_type             valueType;
     typedef typename data_allocator::pointer                pointer;
     typedef typename data_allocator::constPointer           constPointer;
@@ -194,22 +217,66 @@ private:
 
 public:
     // 普通构造函数
-    deque() { fill_init(0, valueType()); }
+    deque() { map_init(0); }
+    explicit deque(const allocator_type& alloc) : allocator_holder<Alloc>(alloc) { map_init(0); }
     // explicit阻止了参数 n 向deque的隐式转化
-    explicit deque(sizeType n) { fill_init(0, valueType()); }
+    explicit deque(sizeType n) { map_init(0); resize(n); }
     deque(sizeType n, const valueType& value) { fill_init(n, value); }
+    deque(sizeType n, const valueType& value, const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc) { fill_init(n, value); }
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    deque(Iter first, Iter last) { map_init(0); append(first, last); }
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    deque(Iter first, Iter last, const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc) { map_init(0); append(first, last); }
+
+    // 拷贝构造,拷贝赋值，分配器的规则同vector：拷贝构造由 select_on_container_copy_construction 决定，赋值不改变分配器
+    deque(const deque& rhs)
+        : allocator_holder<Alloc>(mystl::alloc_select_on_copy(rhs.alloc())) { copy_init(rhs.start, rhs.finish); }
+    deque(const deque& rhs, const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc) { copy_init(rhs.start, rhs.finish); }
+    deque& operator=(const deque& rhs) {
+        if(this != &rhs) assign(rhs.begin(), rhs.end());
+        return *this;
+    }
 
-    // 拷贝构造,拷贝赋值
-    deque(const deque& rhs) { copy_init(rhs.start, rhs.finish); }
-    deque& operator=(const deque&);
+    // 移动接管map和缓冲区，不申请内存；被移动的deque没有map，第一次插入时再申请
+    // 分配器不相等时不能接管对方的缓冲区，只能逐个移动元素，规则同vector
+    deque(deque&& rhs) noexcept
+        : allocator_holder<Alloc>(rhs.alloc()), start(rhs.start), finish(rhs.finish),
+          __map(rhs.__map), mapSize(rhs.mapSize) {
+        rhs.reset_map();
+    }
+    deque(deque&& rhs, const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc), __map(nullptr), mapSize(0) {
+        if(this->alloc() == rhs.alloc()) {
+            take_map(rhs);
+        } else {
+            map_init(0);
+            append(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+        }
+    }
+    deque& operator=(deque&& rhs) noexcept(std::is_empty<Alloc>::value) {
+        if(this == &rhs) return *this;
+        if(this->alloc() == rhs.alloc()) {
+            deque temp(std::move(*this));
+            take_map(rhs);
+        } else {
+            range_assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()),
+                         forward_iterator_tag());
+        }
+        return *this;
+    }
 
     // 析构
     ~deque() {
         if(__map) {
             clear();
-            data_allocator::deallocate(start.first, buffer_size());
-            *__map = nullptr;
-            map_allocator::deallocate(__map, mapSize);
+            // 包括头部保留的缓冲区和预留的空闲缓冲区
+            deallocate_buffer(__map, __map + mapSize);
+            map_alloc().deallocate(__map, mapSize);
             mapSize = 0;
             __map = nullptr;
         }
@@ -225,15 +292,38 @@ public:
     // 容量
     bool        empty()            const { return start == finish; }
     sizeType    size()             const { return finish - start; }
+    // map 中指针的个数，以及已经申请的缓冲区个数(包括空闲的)
+    sizeType    map_capacity()     const { return mapSize; }
+    sizeType    block_count()      const { return __map ? last_block() - first_block() + 1 : 0; }
+    // 释放空闲的缓冲区，把map缩小到刚好放下正在使用的缓冲区，所有迭代器失效
+    void        shrink_to_fit();
 
     // 元素访问 不判断越界
     reference operator[](sizeType n) { return start[static_cast<differenceType>(n)]; }
     // TODO Q:这个函数声明为const只是为了重载嘛？
     constReference operator[](sizeType n) const{ return start[static_cast<differenceType>(n)]; }
 
-    // push_back / push_front
-    void push_back(const valueType&);
-    void push_front(const valueType&);
+    // push_back / push_front / emplace_back / emplace_front
+    void push_back(const valueType& value)  { emplace_back(value); }
+    void push_back(valueType&& value)       { emplace_back(std::move(value)); }
+    void push_front(const valueType& value) { emplace_front(value); }
+    void push_front(valueType&& value)      { emplace_front(std::move(value)); }
+    template<typename... Args>
+    void emplace_back(Args&&...);
+    template<typename... Args>
+    void emplace_front(Args&&...);
+
+    // insert / emplace，元素往离pos近的一端移动
+    template<typename... Args>
+    iterator emplace(iterator, Args&&...);
+    iterator insert(iterator pos, const valueType& value) { return emplace(pos, value); }
+    iterator insert(iterator pos, valueType&& value)      { return emplace(pos, std::move(value)); }
+    iterator insert(iterator, sizeType, const valueType&);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    iterator insert(iterator pos, Iter first, Iter last) {
+        return range_insert(pos, first, last, mystl::iterator_category(first));
+    }
 
     // pop_back / pop_front 
     void pop_back();
@@ -244,8 +334,41 @@ public:
     iterator erase(iterator, iterator);
     void     clear();
 
-    void swap(const deque& rhs) noexcept {
+    // 只改变元素个数，新增的元素不初始化，只用于平凡类型(比如反序列化时直接read进缓冲区)
+    void resize_for_overwrite(sizeType);
+    void resize(sizeType);
+    void resize(sizeType, const valueType&);
+
+    // 预先申请好map和缓冲区，之后的n次push_back/push_front不会再申请内存
+    void reserve_back(sizeType n)  { reserve_elements_at_back(n); }
+    void reserve_front(sizeType n) { reserve_elements_at_front(n); }
+
+    // 批量追加/在头部插入，一次申请好所有缓冲区，再按缓冲区整块构造(平凡可拷贝的类型是memcpy)
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    void append(Iter first, Iter last)  { insert(finish, first, last); }
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    void prepend(Iter first, Iter last) { insert(start, first, last); }
+
+    // assign，先覆盖已有的元素，多出来的删除，不够的追加
+    void assign(sizeType, const valueType&);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    void assign(Iter first, Iter last) { range_assign(first, last, mystl::iterator_category(first)); }
+
+    // 按缓冲区依次访问元素，f(pointer, count) 每次拿到一段连续的元素
+    template<typename Function>
+    void for_each_segment(Function f);
+    template<typename Function>
+    void for_each_segment(Function f) const;
+
+    allocator_type get_allocator() const { return this->alloc(); }
+
+    // 分配器跟着map和缓冲区一起交换
+    void swap(deque& rhs) noexcept {
         using std::swap;
+        this->swap_alloc(rhs);
         swap(start, rhs.start);
         swap(finish, rhs.finish);
         swap(__map, rhs.__map);
@@ -254,6 +377,20 @@ public:
 
 private:
     // helper function
+    // 被移动之后的状态：没有map，迭代器都是空的
+    void                           reset_map() noexcept {
+        start = finish = iterator();
+        __map = nullptr;
+        mapSize = 0;
+    }
+    // 接管rhs的map和缓冲区，调用前自己没有map
+    void                           take_map(deque& rhs) noexcept {
+        start = rhs.start;
+        finish = rhs.finish;
+        __map = rhs.__map;
+        mapSize = rhs.mapSize;
+        rhs.reset_map();
+    }
     void                           fill_init(sizeType, const valueType&);
     void                           copy_init(iterator, iterator);
     mapPointer                     allocate_map(size_t);
@@ -261,14 +398,52 @@ private:
     void                           deallocate_buffer(mapPointer, mapPointer);
     void                           map_init(sizeType);
     void                           reallocate_map(sizeType, bool); 
+    void                           resize_map(sizeType);
+    void                           maybe_shrink_map();
+    mapPointer                     first_block() const;
+    mapPointer                     last_block() const;
     void                           reserve_map_at_back(sizeType nodeToAdd = 1);
     void                           reserve_map_at_front(sizeType nodeToAdd = 1);  
+    iterator                       reserve_elements_at_back(sizeType);
+    iterator                       reserve_elements_at_front(sizeType);
+    // 移动构造不抛出异常(或者可以平凡重定位)时整段搬移元素，否则只往 [start, finish) 之外构造，已有元素之间用赋值
+    typedef std::integral_constant<bool, is_trivially_relocatable<T>::value ||
+                                         std::is_nothrow_move_constructible<T>::value>    nothrowRelocate;
+    typedef typename std::conditional<std::is_copy_constructible<T>::value,
+                                      iterator, std::move_iterator<iterator>>::type       copyOrMoveIter;
+    iterator                       make_gap(iterator pos, sizeType n) { return make_gap(pos, n, nothrowRelocate()); }
+    void                           close_gap(iterator pos, sizeType n) { close_gap(pos, n, nothrowRelocate()); }
+    iterator                       make_gap(iterator, sizeType, std::true_type);
+    iterator                       make_gap(iterator, sizeType, std::false_type);
+    void                           close_gap(iterator, sizeType, std::true_type);
+    void                           close_gap(iterator, sizeType, std::false_type);
+    iterator                       erase_middle(iterator, iterator, std::true_type);
+    iterator                       erase_middle(iterator, iterator, std::false_type);
+    static void                    relocate_forward(iterator, iterator, iterator);
+    static void                    relocate_backward(iterator, iterator, iterator);
+    static void                    relocate_chunk_backward(pointer, pointer, pointer);
+    template<typename Iter>
+    iterator                       range_insert(iterator, Iter, Iter, input_iterator_tag);
+    template<typename Iter>
+    iterator                       range_insert(iterator, Iter, Iter, forward_iterator_tag);
+    template<typename Iter>
+    void                           range_assign(Iter, Iter, input_iterator_tag);
+    template<typename Iter>
+    void                           range_assign(Iter, Iter, forward_iterator_tag);
+    template<typename Iter>
+    Iter                           uninitialized_copy_into(iterator, Iter, sizeType);
+    void                           uninitialized_fill_into(iterator, sizeType, const valueType&);
+    template<typename Iter>
+    static Iter                    copy_into(iterator, Iter, sizeType);
+    void                           release_back_blocks(mapPointer, mapPointer);
+    void                           release_front_blocks(mapPointer, mapPointer);
+    map_allocator                  map_alloc() const { return map_allocator(this->alloc()); }
 
 };
 
 // 拷贝赋值
 // template<typename T>
-// deque<T>& deque<T>::operator=(const deque& rhs) {
+// deque<T, Alloc>& deque<T, Alloc>::operator=(const deque& rhs) {
 //     if(this != &rhs) {
 //         const sizeType len = size();
 //         if(len >= rhs.size()) {
@@ -280,134 +455,366 @@ private:
 //     return *this;
 // }
 
-template<typename T>
-void deque<T>::push_back(const valueType& value) {
+template<typename T, typename Alloc>
+template<typename... Args>
+void deque<T, Alloc>::emplace_back(Args&&... args) {
     // 最后一个缓冲区至少有两个元素备用空间
-    if(finish.cur != finish.last - 1) {
-        data_allocator::construct(finish.cur, value);
+    if(finish.last - finish.cur > 1) {
+        this->alloc().construct(finish.cur, std::forward<Args>(args)...);
         ++finish.cur;
+    } else if(!__map) {
+        map_init(0);
+        emplace_back(std::forward<Args>(args)...);
     } else {
-        // 默认增加一个缓冲区
+        // 默认增加一个缓冲区，reserve_back预留过的就直接使用
         reserve_map_at_back();
-        *(finish.node + 1) = data_allocator::allocate(buffer_size());
-        try {
-            data_allocator::construct(finish.cur, value);
-            finish.set_node(finish.node + 1);
-            finish.cur = finish.first;
-        } catch(...) {
-            data_allocator::deallocate(*(finish.node + 1), buffer_size());
-            throw;
-        }
+        allocate_buffer(finish.node + 1, finish.node + 2);
+        this->alloc().construct(finish.cur, std::forward<Args>(args)...);
+        finish.set_node(finish.node + 1);
+        finish.cur = finish.first;
     }
 }
 
-template<typename T>
-void deque<T>::push_front(const valueType& value) {
+template<typename T, typename Alloc>
+template<typename... Args>
+void deque<T, Alloc>::emplace_front(Args&&... args) {
     // 第一个缓冲区至少一个元素的备用空间
     if(start.first != start.cur) {
         // ！！！注意start的cur指向的是缓冲区第一个元素，和finish的cur不一样
-        data_allocator::construct(start.cur - 1, value);
+        this->alloc().construct(start.cur - 1, std::forward<Args>(args)...);
         --start.cur;
+    } else if(!__map) {
+        map_init(0);
+        emplace_front(std::forward<Args>(args)...);
     } else {
+        // 构造失败时新申请的缓冲区留在map里当作预留的空闲缓冲区，不会泄漏
         reserve_map_at_front();
-        *(start.node - 1) = data_allocator::allocate(buffer_size());
-        try {
-            start.set_node(start.node - 1);
-            start.cur = start.last - 1;
-            data_allocator::construct(start.cur, value);
-        } catch(...) {
-            ++start;
-            data_allocator::deallocate(*(start.node - 1), buffer_size());
-            throw;
-        }
+        allocate_buffer(start.node - 1, start.node);
+        this->alloc().construct(*(start.node - 1) + buffer_size() - 1, std::forward<Args>(args)...);
+        start.set_node(start.node - 1);
+        start.cur = start.last - 1;
     }
 }
 
-template<typename T>
-void deque<T>::pop_back() {
+// 先构造出新元素再空出位置，args 可以引用deque里的元素
+template<typename T, typename Alloc>
+template<typename... Args>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(iterator pos, Args&&... args) {
+    if(pos.cur == start.cur) {
+        emplace_front(std::forward<Args>(args)...);
+        return start;
+    } else if(pos.cur == finish.cur) {
+        emplace_back(std::forward<Args>(args)...);
+        return finish - 1;
+    }
+    valueType temp(std::forward<Args>(args)...);
+    iterator gap = make_gap(pos, 1);
+    this->alloc().construct(gap.cur, std::move(temp));
+    return gap;
+}
+
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(iterator pos, sizeType n, const valueType& value) {
+    if(n == 0) return pos;
+    const valueType temp(value);
+    iterator gap = make_gap(pos, n);
+    try {
+        uninitialized_fill_into(gap, n, temp);
+    } catch(...) {
+        close_gap(gap, n);
+        throw;
+    }
+    return gap;
+}
+
+// 输入迭代器不知道有多少个元素，先放进一个临时的deque再整体移动进来
+template<typename T, typename Alloc>
+template<typename Iter>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::range_insert(iterator pos, Iter first, Iter last, input_iterator_tag) {
+    deque temp(this->alloc());
+    for(; first != last; ++first) temp.emplace_back(*first);
+    return range_insert(pos, std::make_move_iterator(temp.begin()),
+                        std::make_move_iterator(temp.end()), forward_iterator_tag());
+}
+
+// 算出个数后一次把需要的map和缓冲区申请好，再构造到空出的位置
+template<typename T, typename Alloc>
+template<typename Iter>
+typename deque<T, Alloc>::iterator
+deque<T, Alloc>::range_insert(iterator pos, Iter first, Iter last, forward_iterator_tag) {
+    const sizeType n = static_cast<sizeType>(mystl::distance(first, last));
+    if(n == 0) return pos;
+    iterator gap = make_gap(pos, n);
+    try {
+        uninitialized_copy_into(gap, first, n);
+    } catch(...) {
+        close_gap(gap, n);
+        throw;
+    }
+    return gap;
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::pop_back() {
     // 缓冲区如果有一个元素则不会释放，因为cur=first说明缓冲区没有元素
     if(finish.cur != finish.first) {
-        data_allocator::destory(--finish.cur);
+        this->alloc().destory(--finish.cur);
     } else {
-        data_allocator::deallocate(*(finish.node), buffer_size());
-        // TODO Q: 这句话有必要吗？ 是否可以把deallocate和nullptr封装为一个non member？
-        *(finish.node) = nullptr;
+        release_back_blocks(finish.node, finish.node + 1);
         finish.set_node(finish.node - 1);
         finish.cur = finish.last - 1;
-        data_allocator::destory(finish.cur);
+        this->alloc().destory(finish.cur);
+        maybe_shrink_map();
     }
 }
 
-template<typename T>
-void deque<T>::pop_front() {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::pop_front() {
    if(start.cur != start.last - 1) {
-       data_allocator::destory(start.cur++);
+       this->alloc().destory(start.cur++);
    } else {
-        data_allocator::destory(start.cur);
-        data_allocator::deallocate(*(start.node), buffer_size());
-        *(start.node) = nullptr;
+        this->alloc().destory(start.cur);
+        release_front_blocks(start.node, start.node + 1);
         start.set_node(start.node + 1);
         start.cur = start.first;
+        maybe_shrink_map();
    }
 }
 
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(iterator pos) {
+    return erase(pos, pos + 1);
+}
+
 // 删除[first, last)
 // 为了保证效率尽可能的高，就判断删除的位置是中间偏后还是中间偏前来进行移动
-template<typename T>
-typename deque<T>::iterator deque<T>::erase(iterator first, iterator last) {
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(iterator first, iterator last) {
     if(first == last) {
         return first;
     } else if(first == start && last == finish) {
         clear();
         return finish;
     } else {
-        const differenceType len = last - first;
-        const differenceType elemsBefore = first - start;
-        if(elemsBefore < (static_cast<differenceType>(size()) - len) / 2) {
-            // 只移动前面的
-             if(first != start) {
-                 // 这里直接copy不会造成内存泄漏，因为会调用T的拷贝赋值，T的拷贝赋值保证了不会内存泄漏
-                 mystl::copy_backward(start, first, last);  // libstd 用了move
-             }
-             iterator newStart = start + len;
-             data_allocator::destory(start.cur, newStart.cur);
-             start = newStart;
-        } else {
-            // 只移动后面的
-            if(last != finish) {
-                std::copy(last, finish, first);
-            }
-            iterator newFinish = finish - len;
-            data_allocator::destory(newFinish.cur, finish.cur);
-            finish = newFinish;
-        }
-        return start + elemsBefore;
+        return erase_middle(first, last, nothrowRelocate());
+    }
+}
+
+// 先析构再把少的一边搬过来
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::erase_middle(iterator first, iterator last, std::true_type) {
+    const differenceType elemsBefore = first - start;
+    mystl::destory(first, last);
+    close_gap(first, static_cast<sizeType>(last - first));
+    return start + elemsBefore;
+}
+
+// 移动可能抛出异常时不留下未构造的位置：先移动赋值，再析构多出来的一端，出错时所有元素仍然是构造好的
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::erase_middle(iterator first, iterator last, std::false_type) {
+    const differenceType elemsBefore = first - start;
+    const differenceType elemsAfter = finish - last;
+    const differenceType len = last - first;
+    MYSTL_STAT_ADD(deque_elements_shifted, std::min(elemsBefore, elemsAfter));
+    if(elemsBefore < elemsAfter) {
+        std::move_backward(start, first, last);
+        iterator newStart = start + len;
+        mystl::destory(start, newStart);
+        release_front_blocks(start.node, newStart.node);
+        start = newStart;
+    } else {
+        std::move(last, finish, first);
+        iterator newFinish = finish - len;
+        mystl::destory(newFinish, finish);
+        release_back_blocks(newFinish.node + 1, finish.node + 1);
+        finish = newFinish;
     }
+    maybe_shrink_map();
+    return start + elemsBefore;
 }
 
 // clear,deque在无任何元素时会有一个缓冲区，clear后也应保留一个缓冲区(头部)
 // clear只是释放缓冲区空间，但并没有释放map空间
-template<typename T>
-void deque<T>::clear() {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::clear() {
+    if(!__map) return;
     // 先删除(start, finish)之间的
     // ！！！这里的条件不能用 !=
     for(auto cur = start.node + 1; cur < finish.node; ++cur) {
-        data_allocator::destory(*cur, *cur + buffer_size());
-        data_allocator::deallocate(*cur, buffer_size());
-        *cur = nullptr;
+        this->alloc().destory(*cur, *cur + buffer_size());
     }
     // 考虑只有一个缓冲区的情况
     if(start.node != finish.node) {
-        data_allocator::destory(start.cur, start.last);     // 这里说明deque是从两边扩展
-        data_allocator::destory(finish.first, finish.cur);
-        // 只释放finish缓冲区，保留头部缓冲区
-        data_allocator::deallocate(finish.first, buffer_size());
-        *(finish.node) = nullptr;
+        this->alloc().destory(start.cur, start.last);     // 这里说明deque是从两边扩展
+        this->alloc().destory(finish.first, finish.cur);
     } else {
-        data_allocator::destory(start.first, start.cur);
+        this->alloc().destory(start.cur, finish.cur);
     }
-    // TODO 好像没有修改start.cur ?
+    // 保留头部缓冲区，其余的释放
+    release_back_blocks(start.node + 1, finish.node + 1);
     finish = start;
+    maybe_shrink_map();
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::resize_for_overwrite(sizeType n) {
+    static_assert(std::is_trivially_default_constructible<T>::value &&
+                  std::is_trivially_destructible<T>::value,
+                  "resize_for_overwrite requires a trivial T");
+    const sizeType len = size();
+    if(n <= len) {
+        // 平凡类型不需要析构，只释放多出来的缓冲区
+        iterator newFinish = start + static_cast<differenceType>(n);
+        release_back_blocks(newFinish.node + 1, finish.node + 1);
+        finish = newFinish;
+        return;
+    }
+    // 一次把需要的map和缓冲区都申请好
+    finish = reserve_elements_at_back(n - len);
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::resize(sizeType n) {
+    const sizeType len = size();
+    if(n <= len) {
+        erase(start + static_cast<differenceType>(n), finish);
+        return;
+    }
+    iterator newFinish = reserve_elements_at_back(n - len);
+    iterator cur = finish;
+    try {
+        for(; cur != newFinish; ++cur) this->alloc().construct(cur.cur);
+    } catch(...) {
+        mystl::destory(finish, cur);
+        throw;
+    }
+    finish = newFinish;
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::resize(sizeType n, const valueType& value) {
+    const sizeType len = size();
+    if(n <= len) erase(start + static_cast<differenceType>(n), finish);
+    else insert(finish, n - len, value);
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::assign(sizeType n, const valueType& value) {
+    const sizeType len = size();
+    if(n <= len) {
+        std::fill(start, start + static_cast<differenceType>(n), value);
+        erase(start + static_cast<differenceType>(n), finish);
+    } else {
+        const valueType temp(value);
+        std::fill(start, finish, temp);
+        insert(finish, n - len, temp);
+    }
+}
+
+template<typename T, typename Alloc>
+template<typename Iter>
+void deque<T, Alloc>::range_assign(Iter first, Iter last, input_iterator_tag) {
+    iterator cur = start;
+    for(; first != last && cur != finish; ++first, ++cur) *cur = *first;
+    if(first == last) erase(cur, finish);
+    else append(first, last);
+}
+
+template<typename T, typename Alloc>
+template<typename Iter>
+void deque<T, Alloc>::range_assign(Iter first, Iter last, forward_iterator_tag) {
+    const sizeType n = static_cast<sizeType>(mystl::distance(first, last));
+    const sizeType len = size();
+    if(n <= len) {
+        copy_into(start, first, n);
+        erase(start + static_cast<differenceType>(n), finish);
+    } else {
+        Iter mid = copy_into(start, first, len);
+        append(mid, last);
+    }
+}
+
+// 下面三个函数按缓冲区分段处理[dest, dest + n)，每段调用一次针对连续内存的算法
+// 源是指针且T平凡可拷贝时，mystl::uninitialized_copy / mystl::copy 直接memmove
+// 最后一段处理完之后不再移动dest，避免越过已经申请的缓冲区
+template<typename T, typename Alloc>
+template<typename Iter>
+Iter deque<T, Alloc>::uninitialized_copy_into(iterator dest, Iter first, sizeType n) {
+    iterator cur = dest;
+    sizeType done = 0;
+    try {
+        while(done < n) {
+            const sizeType k = std::min(n - done, static_cast<sizeType>(cur.last - cur.cur));
+            Iter mid = first;
+            mystl::advance(mid, k);
+            mystl::uninitialized_copy_a(first, mid, cur.cur, this->alloc());
+            first = mid;
+            done += k;
+            if(done == n) break;
+            cur += static_cast<differenceType>(k);
+        }
+    } catch(...) {
+        mystl::destory(dest, dest + static_cast<differenceType>(done));
+        throw;
+    }
+    return first;
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::uninitialized_fill_into(iterator dest, sizeType n, const valueType& value) {
+    iterator cur = dest;
+    sizeType done = 0;
+    try {
+        while(done < n) {
+            const sizeType k = std::min(n - done, static_cast<sizeType>(cur.last - cur.cur));
+            mystl::uninitialized_fill_n_a(cur.cur, k, value, this->alloc());
+            done += k;
+            if(done == n) break;
+            cur += static_cast<differenceType>(k);
+        }
+    } catch(...) {
+        mystl::destory(dest, dest + static_cast<differenceType>(done));
+        throw;
+    }
+}
+
+template<typename T, typename Alloc>
+template<typename Iter>
+Iter deque<T, Alloc>::copy_into(iterator dest, Iter first, sizeType n) {
+    while(n > 0) {
+        const sizeType k = std::min(n, static_cast<sizeType>(dest.last - dest.cur));
+        Iter mid = first;
+        mystl::advance(mid, k);
+        mystl::copy(first, mid, dest.cur);
+        first = mid;
+        n -= k;
+        if(n == 0) break;
+        dest += static_cast<differenceType>(k);
+    }
+    return first;
+}
+
+template<typename T, typename Alloc>
+template<typename Function>
+void deque<T, Alloc>::for_each_segment(Function f) {
+    if(!__map) return;
+    for(mapPointer node = start.node; node <= finish.node; ++node) {
+        pointer first = node == start.node ? start.cur : *node;
+        pointer last = node == finish.node ? finish.cur : *node + buffer_size();
+        if(first != last) f(first, static_cast<sizeType>(last - first));
+    }
+}
+
+template<typename T, typename Alloc>
+template<typename Function>
+void deque<T, Alloc>::for_each_segment(Function f) const {
+    if(!__map) return;
+    for(mapPointer node = start.node; node <= finish.node; ++node) {
+        constPointer first = node == start.node ? start.cur : *node;
+        constPointer last = node == finish.node ? finish.cur : *node + buffer_size();
+        if(first != last) f(first, static_cast<sizeType>(last - first));
+    }
 }
 
 /***********************************************************************
@@ -416,9 +823,9 @@ void deque<T>::clear() {
  *                                                                     |
  **********************************************************************/
 // allocate_map只是分配了map 的空间
-template<typename T>
-typename deque<T>::mapPointer deque<T>::allocate_map(size_t n) {
-   mapPointer mp = map_allocator::allocate(n);
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::mapPointer deque<T, Alloc>::allocate_map(size_t n) {
+   mapPointer mp = map_alloc().allocate(n);
    // 将所有的指针(指向每个缓冲区的开始)置null
    for(size_t i = 0; i < n; ++i) {
        *(mp + i) = nullptr;
@@ -426,31 +833,50 @@ typename deque<T>::mapPointer deque<T>::allocate_map(size_t n) {
    return mp;
 }
 
-template<typename T>
-void deque<T>::deallocate_buffer(mapPointer nstart, mapPointer nfinish) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::deallocate_buffer(mapPointer nstart, mapPointer nfinish) {
     mapPointer cur = nfinish;
     while(cur != nstart) {
-        data_allocator::deallocate(*(--cur), buffer_size());
+        if(*(--cur) == nullptr) continue;
+        this->alloc().deallocate(*cur, buffer_size());
         *cur = nullptr;
+        MYSTL_STAT_ADD(deque_block_frees, 1);
     }
 }
 
-template<typename T>
-void deque<T>::allocate_buffer(mapPointer nstart, mapPointer nfinish) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::allocate_buffer(mapPointer nstart, mapPointer nfinish) {
+    // 已经有缓冲区(预留的)的位置直接使用，它们和已申请的缓冲区相连，一定在区间的一端
     mapPointer cur = nstart;
+    mapPointer allocated = nullptr;     // 本次申请的第一个位置
     try {
         for(; cur != nfinish; ++cur) {
-            *cur = data_allocator::allocate(buffer_size());
+            if(*cur != nullptr) continue;
+            *cur = this->alloc().allocate(buffer_size());
+            if(allocated == nullptr) allocated = cur;
+            MYSTL_STAT_ADD(deque_block_allocs, 1);
         }
     } catch(...) {
-        deallocate_buffer(nstart, cur);
+        if(allocated) deallocate_buffer(allocated, cur);
         throw;
     }
 }
 
+// 释放finish之后不再使用的缓冲区[first, last)
+// 外侧还有预留的缓冲区时不释放，当作空闲缓冲区保留，保证已申请的缓冲区在map中是连续的
+template<typename T, typename Alloc>
+void deque<T, Alloc>::release_back_blocks(mapPointer first, mapPointer last) {
+    if(last == __map + mapSize || *last == nullptr) deallocate_buffer(first, last);
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::release_front_blocks(mapPointer first, mapPointer last) {
+    if(first == __map || *(first - 1) == nullptr) deallocate_buffer(first, last);
+}
+
 // 申请map的空间以及每个缓冲区的空间
-template<typename T>
-void deque<T>::map_init(sizeType nElem) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::map_init(sizeType nElem) {
     const size_t numNodes = nElem / buffer_size() + 1;
     mapSize = std::max(static_cast<size_t>(DEQUE_MAP_SIZE), numNodes + 2);
     __map = allocate_map(mapSize);
@@ -464,7 +890,7 @@ void deque<T>::map_init(sizeType nElem) {
         // 也就是说finish.node后面的结点指向的缓冲区还没申请空间
         allocate_buffer(nstart, nfinish);
     } catch(...) {
-        map_allocator::deallocate(__map, mapSize);
+        map_alloc().deallocate(__map, mapSize);
         __map = nullptr;
         mapSize = 0;    //  记住mapSize也要置0 (指针 + size)
         throw;
@@ -476,90 +902,367 @@ void deque<T>::map_init(sizeType nElem) {
     finish.cur = finish.first + nElem % buffer_size();
 }
 
-template<typename T>
-void deque<T>::fill_init(sizeType n, const valueType& value) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::fill_init(sizeType n, const valueType& value) {
     map_init(n);
-    // 这里不用try的原因是std::uninitialized_fill已经保证了异常回滚
+    // 这里不用try的原因是uninitialized_fill_n_a已经保证了异常回滚
     for(auto cur = start.node; cur != finish.node; ++cur) {
-        std::uninitialized_fill(*cur, *cur + buffer_size(), value);
+        mystl::uninitialized_fill_n_a(*cur, buffer_size(), value, this->alloc());
     }
-    std::uninitialized_fill(finish.first, finish.cur, value);
+    mystl::uninitialized_fill_n_a(finish.first, finish.cur - finish.first, value, this->alloc());
 }
 
-template<typename T>
-void deque<T>::copy_init(iterator first, iterator last) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::copy_init(iterator first, iterator last) {
     sizeType n = mystl::distance(first, last);
     map_init(n);
     for(auto cur = start.node; cur != finish.node; ++cur) {
         auto next = first;
         mystl::advance(next, buffer_size());
-        std::uninitialized_copy(first, next, *cur);
+        mystl::uninitialized_copy_a(first, next, *cur, this->alloc());
         first = next;
     }
-    std::uninitialized_copy(first, last, finish.first);
+    mystl::uninitialized_copy_a(first, last, finish.first, this->alloc());
 }
 
-template<typename T>
-void deque<T>::reallocate_map(sizeType nodeToAdd, bool frontFlag) {
-    const sizeType oldNumNode = finish.node - start.node + 1;
+// map 中已经申请的缓冲区是连续的一段 [first_block(), last_block()]，包含[start.node, finish.node]
+// 这段以外的指针都是nullptr
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::mapPointer deque<T, Alloc>::first_block() const {
+    mapPointer node = start.node;
+    while(node != __map && *(node - 1) != nullptr) --node;
+    return node;
+}
+
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::mapPointer deque<T, Alloc>::last_block() const {
+    mapPointer node = finish.node;
+    while(node + 1 != __map + mapSize && *(node + 1) != nullptr) ++node;
+    return node;
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::reallocate_map(sizeType nodeToAdd, bool frontFlag) {
+    // 空闲的缓冲区也要一起搬过去
+    mapPointer firstNode = first_block();
+    mapPointer lastNode = last_block();
+    const sizeType oldNumNode = lastNode - firstNode + 1;
     const sizeType newNumNode = oldNumNode + nodeToAdd;
     mapPointer newNStart;
     if(mapSize > 2 * newNumNode) {
         newNStart = __map + ((mapSize - newNumNode) >> 1) +
                              (frontFlag ? nodeToAdd: 0);
-        if(newNStart < start.node) {
+        if(newNStart < firstNode) {
             // 这里只是拷贝缓冲区的结点，并没有做到深拷贝,实际上只需要拷贝map就可以
-            std::copy(start.node, finish.node + 1, newNStart);
+            std::copy(firstNode, lastNode + 1, newNStart);
         } else {
-            mystl::copy_backward(start.node,
-                                 finish.node + 1, newNStart + oldNumNode);
+            mystl::copy_backward(firstNode, lastNode + 1, newNStart + oldNumNode);
         }
+        // 原来位置上留下的指针清空
+        std::fill(__map, newNStart, nullptr);
+        std::fill(newNStart + oldNumNode, __map + mapSize, nullptr);
     } else {
         /**
          * @brief 实际上只需要拷贝map就可以
          * 
          */
         const sizeType newMapSize = mapSize + std::max(mapSize, nodeToAdd) + 2;
-        mapPointer __newMap = map_allocator::allocate(newMapSize);
-        mapPointer newNStart = __newMap + ((newMapSize - newNumNode) >> 1) +
-                               (frontFlag ? nodeToAdd : 0);
-        std::copy(start.node, finish.node, newNStart);
-        map_allocator::deallocate(__map, mapSize);
+        mapPointer __newMap = allocate_map(newMapSize);
+        newNStart = __newMap + ((newMapSize - newNumNode) >> 1) +
+                    (frontFlag ? nodeToAdd : 0);
+        std::copy(firstNode, lastNode + 1, newNStart);
+        map_alloc().deallocate(__map, mapSize);
         __map = __newMap;
         mapSize = newMapSize;      
     }
     // 还需要重新设置迭代器已经失效了
+    const differenceType startOffset = start.node - firstNode;
+    const differenceType finishOffset = finish.node - firstNode;
+    start.set_node(newNStart + startOffset);
+    finish.set_node(newNStart + finishOffset);
+    MYSTL_STAT_ADD(deque_map_reallocations, 1);
+    MYSTL_STAT_ADD(deque_map_slots, mapSize);
+}
+
+// 换成大小为newMapSize的map，只放正在使用的缓冲区[start.node, finish.node]并居中，空闲缓冲区必须已经释放
+template<typename T, typename Alloc>
+void deque<T, Alloc>::resize_map(sizeType newMapSize) {
+    const sizeType numNodes = finish.node - start.node + 1;
+    assert(newMapSize >= numNodes);
+    mapPointer __newMap = allocate_map(newMapSize);
+    mapPointer newNStart = __newMap + (newMapSize - numNodes) / 2;
+    std::copy(start.node, finish.node + 1, newNStart);
+    map_alloc().deallocate(__map, mapSize);
+    __map = __newMap;
+    mapSize = newMapSize;
     start.set_node(newNStart);
-    finish.set_node(newNStart + oldNumNode - 1);
+    finish.set_node(newNStart + numNodes - 1);
+    MYSTL_STAT_ADD(deque_map_reallocations, 1);
+    MYSTL_STAT_ADD(deque_map_slots, mapSize);
 }
 
-template<typename T>
-void deque<T>::reserve_map_at_back(sizeType nodeToAdd) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::shrink_to_fit() {
+    if(!__map) return;
+    deallocate_buffer(__map, start.node);
+    deallocate_buffer(finish.node + 1, __map + mapSize);
+    const sizeType numNodes = finish.node - start.node + 1;
+    const sizeType newMapSize = std::max(static_cast<sizeType>(DEQUE_MAP_SIZE), numNodes + 2);
+    if(newMapSize < mapSize) resize_map(newMapSize);
+}
+
+// 释放缓冲区之后调用，使用率低于阈值时收缩，收缩的代价可以均摊
+// 新的map要比使用的缓冲区多一倍以上，否则队列式的使用(尾进头出)重新居中时放不下，又会扩大map
+template<typename T, typename Alloc>
+void deque<T, Alloc>::maybe_shrink_map() {
+#if DEQUE_AUTO_SHRINK
+    static_assert(DEQUE_SHRINK_FACTOR >= 3, "DEQUE_SHRINK_FACTOR must be at least 3");
+    const sizeType numNodes = finish.node - start.node + 1;
+    const sizeType newMapSize = 2 * numNodes + DEQUE_MAP_SIZE;
+    if(mapSize > DEQUE_SHRINK_FACTOR * numNodes && newMapSize < mapSize) {
+        deallocate_buffer(__map, start.node);
+        deallocate_buffer(finish.node + 1, __map + mapSize);
+        resize_map(newMapSize);
+    }
+#endif
+}
+
+template<typename T, typename Alloc>
+void deque<T, Alloc>::reserve_map_at_back(sizeType nodeToAdd) {
     // 类的成员函数的参数表在声明时默认参数位于参数表右部但在它定义的时候则不能加默认参数
     if(nodeToAdd > (mapSize - (finish.node - __map + 1)))
         reallocate_map(nodeToAdd, false);
 }
 
-template<typename T>
-void deque<T>::reserve_map_at_front(sizeType nodeToAdd) {
+template<typename T, typename Alloc>
+void deque<T, Alloc>::reserve_map_at_front(sizeType nodeToAdd) {
     if(nodeToAdd > start.node - __map){
         reallocate_map(nodeToAdd, true);
     }
 }
 
-template<typename T>
-bool operator==(const deque<T>& x, const deque<T>& y) {
+// 在尾部一次申请好n个元素需要的缓冲区，返回finish + n，不改变finish
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::reserve_elements_at_back(sizeType n) {
+    if(!__map) map_init(0);
+    // finish.cur 所在的缓冲区要留一个位置，所以备用空间要减一
+    const sizeType vacancies = static_cast<sizeType>(finish.last - finish.cur) - 1;
+    if(n > vacancies) {
+        const sizeType newNodes = (n - vacancies + buffer_size() - 1) / buffer_size();
+        reserve_map_at_back(newNodes);
+        allocate_buffer(finish.node + 1, finish.node + 1 + newNodes);
+    }
+    return finish + static_cast<differenceType>(n);
+}
+
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::reserve_elements_at_front(sizeType n) {
+    if(!__map) map_init(0);
+    const sizeType vacancies = static_cast<sizeType>(start.cur - start.first);
+    if(n > vacancies) {
+        const sizeType newNodes = (n - vacancies + buffer_size() - 1) / buffer_size();
+        reserve_map_at_front(newNodes);
+        allocate_buffer(start.node - newNodes, start.node);
+    }
+    return start - static_cast<differenceType>(n);
+}
+
+// 在pos处空出n个未构造的位置，pos前后哪边元素少就搬哪边，返回空出的第一个位置
+// 元素是搬过去的(移动构造再析构，可平凡重定位的类型直接memmove)，不会拷贝
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::make_gap(iterator pos, sizeType n, std::true_type) {
+    // reserve 可能重新分配map，pos会失效，先记下下标
+    const differenceType elemsBefore = pos - start;
+    const differenceType elemsAfter = static_cast<differenceType>(size()) - elemsBefore;
+    MYSTL_STAT_ADD(deque_elements_shifted, std::min(elemsBefore, elemsAfter));
+    if(elemsBefore < elemsAfter) {
+        iterator newStart = reserve_elements_at_front(n);
+        relocate_forward(start, start + elemsBefore, newStart);
+        start = newStart;
+    } else {
+        iterator newFinish = reserve_elements_at_back(n);
+        iterator gap = start + elemsBefore;
+        relocate_backward(gap, finish, newFinish);
+        finish = newFinish;
+    }
+    return start + elemsBefore;
+}
+
+// make_gap 的逆操作：[pos, pos + n) 是未构造的位置，把少的一边搬过来填上并释放空出的缓冲区
+template<typename T, typename Alloc>
+void deque<T, Alloc>::close_gap(iterator pos, sizeType n, std::true_type) {
+    const differenceType elemsBefore = pos - start;
+    const differenceType elemsAfter = finish - pos - static_cast<differenceType>(n);
+    MYSTL_STAT_ADD(deque_elements_shifted, std::min(elemsBefore, elemsAfter));
+    if(elemsBefore < elemsAfter) {
+        iterator newStart = start + static_cast<differenceType>(n);
+        relocate_backward(start, pos, pos + static_cast<differenceType>(n));
+        release_front_blocks(start.node, newStart.node);
+        start = newStart;
+    } else {
+        iterator newFinish = finish - static_cast<differenceType>(n);
+        relocate_forward(pos + static_cast<differenceType>(n), finish, pos);
+        release_back_blocks(newFinish.node + 1, finish.node + 1);
+        finish = newFinish;
+    }
+    maybe_shrink_map();
+}
+
+// 移动可能抛出异常的类型：靠边的k个元素构造(能拷贝时拷贝)到 [start, finish) 外面的空位，
+// 其余的在已构造的位置之间移动赋值，最后析构空出来的位置
+// 构造出错时deque不变，赋值出错时所有元素仍然是构造好的
+template<typename T, typename Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::make_gap(iterator pos, sizeType n, std::false_type) {
+    const differenceType elemsBefore = pos - start;
+    const differenceType elemsAfter = static_cast<differenceType>(size()) - elemsBefore;
+    const differenceType len = static_cast<differenceType>(n);
+    MYSTL_STAT_ADD(deque_elements_shifted, std::min(elemsBefore, elemsAfter));
+    if(elemsBefore < elemsAfter) {
+        iterator newStart = reserve_elements_at_front(n);
+        iterator oldStart = start;
+        const differenceType k = std::min(elemsBefore, len);
+        uninitialized_copy_into(newStart, copyOrMoveIter(oldStart), static_cast<sizeType>(k));
+        start = newStart;
+        if(elemsBefore <= len) {
+            mystl::destory(oldStart, oldStart + elemsBefore);
+        } else {
+            std::move(oldStart + len, oldStart + elemsBefore, oldStart);
+            mystl::destory(oldStart + (elemsBefore - len), oldStart + elemsBefore);
+        }
+    } else {
+        iterator newFinish = reserve_elements_at_back(n);
+        iterator oldFinish = finish;
+        iterator gap = start + elemsBefore;
+        const differenceType k = std::min(elemsAfter, len);
+        uninitialized_copy_into(newFinish - k, copyOrMoveIter(oldFinish - k), static_cast<sizeType>(k));
+        finish = newFinish;
+        if(elemsAfter <= len) {
+            mystl::destory(gap, oldFinish);
+        } else {
+            std::move_backward(gap, oldFinish - len, oldFinish);
+            mystl::destory(gap, gap + len);
+        }
+    }
+    return start + elemsBefore;
+}
+
+// 同上，用少的一边填上 [pos, pos + n)；构造出错时放弃这一边的元素，保证 [start, finish) 里没有未构造的位置
+template<typename T, typename Alloc>
+void deque<T, Alloc>::close_gap(iterator pos, sizeType n, std::false_type) {
+    const differenceType elemsBefore = pos - start;
+    const differenceType len = static_cast<differenceType>(n);
+    const differenceType elemsAfter = finish - pos - len;
+    MYSTL_STAT_ADD(deque_elements_shifted, std::min(elemsBefore, elemsAfter));
+    if(elemsBefore < elemsAfter) {
+        iterator newStart = start + len;
+        const differenceType k = std::min(elemsBefore, len);
+        try {
+            uninitialized_copy_into(pos + (len - k), copyOrMoveIter(pos - k), static_cast<sizeType>(k));
+        } catch(...) {
+            mystl::destory(start, pos);
+            iterator afterGap = pos + len;
+            release_front_blocks(start.node, afterGap.node);
+            start = afterGap;
+            throw;
+        }
+        if(elemsBefore <= len) {
+            mystl::destory(start, pos);
+        } else {
+            std::move_backward(start, pos - len, pos);
+            mystl::destory(start, newStart);
+        }
+        release_front_blocks(start.node, newStart.node);
+        start = newStart;
+    } else {
+        iterator newFinish = finish - len;
+        iterator afterGap = pos + len;
+        const differenceType k = std::min(elemsAfter, len);
+        try {
+            uninitialized_copy_into(pos, copyOrMoveIter(afterGap), static_cast<sizeType>(k));
+        } catch(...) {
+            mystl::destory(afterGap, finish);
+            release_back_blocks(pos.node + 1, finish.node + 1);
+            finish = pos;
+            throw;
+        }
+        if(elemsAfter <= len) {
+            mystl::destory(afterGap, finish);
+        } else {
+            std::move(afterGap + len, finish, afterGap);
+            mystl::destory(newFinish, finish);
+        }
+        release_back_blocks(newFinish.node + 1, finish.node + 1);
+        finish = newFinish;
+    }
+    maybe_shrink_map();
+}
+
+// 把[first, last)往前搬到result，result在first之前，按缓冲区分段处理
+// 最后一段搬完之后不再移动迭代器，避免越过已经申请的缓冲区
+template<typename T, typename Alloc>
+void deque<T, Alloc>::relocate_forward(iterator first, iterator last, iterator result) {
+    differenceType n = last - first;
+    while(n > 0) {
+        differenceType k = std::min(n, std::min<differenceType>(first.last - first.cur,
+                                                                result.last - result.cur));
+        mystl::uninitialized_relocate(first.cur, first.cur + k, result.cur);
+        n -= k;
+        if(n == 0) break;
+        first += k;
+        result += k;
+    }
+}
+
+// 把[first, last)往后搬到以resultLast结尾的位置，从后往前处理
+template<typename T, typename Alloc>
+void deque<T, Alloc>::relocate_backward(iterator first, iterator last, iterator resultLast) {
+    differenceType n = last - first;
+    while(n > 0) {
+        if(last.cur == last.first) {
+            last.set_node(last.node - 1);
+            last.cur = last.last;
+        }
+        if(resultLast.cur == resultLast.first) {
+            resultLast.set_node(resultLast.node - 1);
+            resultLast.cur = resultLast.last;
+        }
+        differenceType k = std::min(n, std::min<differenceType>(last.cur - last.first,
+                                                                resultLast.cur - resultLast.first));
+        relocate_chunk_backward(last.cur - k, last.cur, resultLast.cur);
+        last.cur -= k;
+        resultLast.cur -= k;
+        n -= k;
+    }
+}
+
+// 同一个缓冲区里往后搬时区间会重叠，非平凡类型要从后往前逐个搬
+template<typename T, typename Alloc>
+void deque<T, Alloc>::relocate_chunk_backward(pointer first, pointer last, pointer resultLast) {
+    if(is_trivially_relocatable<T>::value) {
+        mystl::uninitialized_relocate(first, last, resultLast - (last - first));
+    } else {
+        while(last != first) {
+            --last;
+            --resultLast;
+            mystl::construct(resultLast, std::move(*last));
+            mystl::destory(last);
+        }
+    }
+}
+
+template<typename T, typename Alloc>
+bool operator==(const deque<T, Alloc>& x, const deque<T, Alloc>& y) {
     return x.size() == y.size() && mystl::equal(x.begin(), x.end(), y.begin());
 }
 
-template<typename T>
-bool operator!= (const deque<T>& x, const deque<T>& y) {
+template<typename T, typename Alloc>
+bool operator!= (const deque<T, Alloc>& x, const deque<T, Alloc>& y) {
     return !(x == y);
 }
 
 // non-member swap， 如果不是class template 特化std::swap
-template<typename T>
-void swap(const deque<T>& x, const deque<T>& y) {
+template<typename T, typename Alloc>
+void swap(deque<T, Alloc>& x, deque<T, Alloc>& y) {
     x.swap(y);
 }
 }   //  end of namespace mystl
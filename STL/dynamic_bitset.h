@@ -0,0 +1,454 @@
+#ifndef DYNAMIC_BITSET_H
+#define DYNAMIC_BITSET_H
+
+// dynamic_bitset 按位存储的bool序列，每个元素只占1 bit
+// 底层是一段连续的64位字，批量运算按字进行，循环写成编译器可以自动向量化的形式
+
+#include "allocator.h"
+#include "vector.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef BITSET_SUPERBLOCK_WORDS
+#define BITSET_SUPERBLOCK_WORDS 8       // rank索引每个超级块的字数，8个字正好是一条cache line
+#endif
+
+// 字级别的位运算
+inline size_t bitset_popcount(uint64_t w) {
+    return static_cast<size_t>(__builtin_popcountll(w));
+}
+
+inline size_t bitset_ctz(uint64_t w) {
+    return static_cast<size_t>(__builtin_ctzll(w));
+}
+
+// 返回w中第k个(从0开始)为1的位的下标，调用者保证 k < popcount(w)
+inline size_t bitset_select_word(uint64_t w, size_t k) {
+    for(; k > 0; --k) {
+        w &= w - 1;     // 清除最低位的1
+    }
+    return bitset_ctz(w);
+}
+
+class dynamic_bitset {
+public:
+    typedef uint64_t                                    wordType;
+    typedef mystl::allocator<wordType>                  data_allocator;
+    typedef size_t                                      sizeType;
+    typedef ptrdiff_t                                   differenceType;
+
+    static constexpr sizeType bitsPerWord = 64;
+    static constexpr sizeType npos = static_cast<sizeType>(-1);
+
+private:
+    wordType*               words;
+    sizeType                nbits;
+    sizeType                nwords;         // 已分配的字数(容量)
+    mystl::vector<sizeType> rankIndex;      // 每个超级块之前1的个数，build_rank_index后有效
+    bool                    rankValid;
+
+public:
+    // 构造
+    dynamic_bitset() noexcept
+    : words(nullptr), nbits(0), nwords(0), rankValid(false) {}
+    explicit dynamic_bitset(sizeType n, bool value = false);
+
+    // 拷贝
+    dynamic_bitset(const dynamic_bitset&);
+    dynamic_bitset& operator=(const dynamic_bitset&);
+
+    // 移动
+    dynamic_bitset(dynamic_bitset&&) noexcept;
+    dynamic_bitset& operator=(dynamic_bitset&&) noexcept;
+
+    ~dynamic_bitset() { data_allocator::deallocate(words, nwords); }
+
+    // 容量
+    bool            empty()     const { return nbits == 0; }
+    sizeType        size()      const { return nbits; }
+    sizeType        num_words() const { return word_count(nbits); }
+    sizeType        capacity()  const { return nwords * bitsPerWord; }
+    wordType*       data()            { return words; }
+    const wordType* data()      const { return words; }
+
+    void resize(sizeType, bool value = false);
+    void push_back(bool);
+    void clear() { nbits = 0; rankValid = false; }
+
+    // 单个位的操作，不检查越界
+    bool test(sizeType pos) const {
+        assert(pos < nbits);
+        return (words[pos / bitsPerWord] >> (pos % bitsPerWord)) & 1;
+    }
+    bool operator[](sizeType pos) const { return test(pos); }
+    dynamic_bitset& set(sizeType pos) {
+        assert(pos < nbits);
+        words[pos / bitsPerWord] |= wordType(1) << (pos % bitsPerWord);
+        rankValid = false;
+        return *this;
+    }
+    dynamic_bitset& set(sizeType pos, bool value) {
+        return value ? set(pos) : reset(pos);
+    }
+    dynamic_bitset& reset(sizeType pos) {
+        assert(pos < nbits);
+        words[pos / bitsPerWord] &= ~(wordType(1) << (pos % bitsPerWord));
+        rankValid = false;
+        return *this;
+    }
+    dynamic_bitset& flip(sizeType pos) {
+        assert(pos < nbits);
+        words[pos / bitsPerWord] ^= wordType(1) << (pos % bitsPerWord);
+        rankValid = false;
+        return *this;
+    }
+
+    // 全部位的操作
+    dynamic_bitset& set();
+    dynamic_bitset& reset();
+    dynamic_bitset& flip();
+
+    // 批量位运算，两个bitset的size必须相同
+    dynamic_bitset& operator&=(const dynamic_bitset&);
+    dynamic_bitset& operator|=(const dynamic_bitset&);
+    dynamic_bitset& operator^=(const dynamic_bitset&);
+    // *this &= ~rhs
+    dynamic_bitset& andnot(const dynamic_bitset&);
+
+    // 统计
+    sizeType count() const;
+    bool     any()   const { return find_first() != npos; }
+    bool     none()  const { return !any(); }
+    bool     all()   const { return count() == nbits; }
+
+    // 查找为1的位，找不到返回npos
+    sizeType find_first() const { return find_from(0); }
+    sizeType find_next(sizeType pos) const {
+        return pos + 1 >= nbits ? npos : find_from(pos + 1);
+    }
+
+    // 按从小到大的顺序对每个为1的位调用f(pos)，比反复find_next少了每次重新定位字的开销
+    template<typename F>
+    void for_each_set(F f) const {
+        const sizeType n = num_words();
+        for(sizeType i = 0; i < n; ++i) {
+            for(wordType w = words[i]; w != 0; w &= w - 1) {
+                f(i * bitsPerWord + bitset_ctz(w));
+            }
+        }
+    }
+
+    // rank/select 需要先调用build_rank_index，修改bitset后索引失效
+    void     build_rank_index();
+    // [0, pos) 中1的个数
+    sizeType rank(sizeType pos) const;
+    // 第k个(从0开始)1的位置，不存在返回npos
+    sizeType select(sizeType k) const;
+
+    void swap(dynamic_bitset& rhs) noexcept {
+        using std::swap;
+        swap(words, rhs.words);
+        swap(nbits, rhs.nbits);
+        swap(nwords, rhs.nwords);
+        rankIndex.swap(rhs.rankIndex);
+        swap(rankValid, rhs.rankValid);
+    }
+
+    friend bool operator==(const dynamic_bitset&, const dynamic_bitset&);
+
+private:
+    // helper function
+    static sizeType word_count(sizeType n) { return (n + bitsPerWord - 1) / bitsPerWord; }
+    void     reserve_words(sizeType);
+    void     sanitize();
+    sizeType find_from(sizeType) const;
+};
+
+/*************************************************************************************/
+// 构造、拷贝、移动                                                                    /
+/*************************************************************************************/
+inline dynamic_bitset::dynamic_bitset(sizeType n, bool value)
+: words(nullptr), nbits(0), nwords(0), rankValid(false) {
+    resize(n, value);
+}
+
+inline dynamic_bitset::dynamic_bitset(const dynamic_bitset& rhs)
+: words(nullptr), nbits(0), nwords(0), rankValid(false) {
+    reserve_words(rhs.num_words());
+    if(rhs.num_words()) {
+        memcpy(words, rhs.words, rhs.num_words() * sizeof(wordType));
+    }
+    nbits = rhs.nbits;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator=(const dynamic_bitset& rhs) {
+    if(this != &rhs) {
+        dynamic_bitset temp(rhs);
+        swap(temp);
+    }
+    return *this;
+}
+
+inline dynamic_bitset::dynamic_bitset(dynamic_bitset&& rhs) noexcept
+: words(rhs.words), nbits(rhs.nbits), nwords(rhs.nwords), rankValid(false) {
+    rhs.words = nullptr;
+    rhs.nbits = 0;
+    rhs.nwords = 0;
+    rhs.rankValid = false;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator=(dynamic_bitset&& rhs) noexcept {
+    if(this != &rhs) {
+        data_allocator::deallocate(words, nwords);
+        words = rhs.words;
+        nbits = rhs.nbits;
+        nwords = rhs.nwords;
+        rankValid = false;
+        rhs.words = nullptr;
+        rhs.nbits = 0;
+        rhs.nwords = 0;
+        rhs.rankValid = false;
+    }
+    return *this;
+}
+
+/*************************************************************************************/
+// 容量                                                                               /
+/*************************************************************************************/
+inline void dynamic_bitset::resize(sizeType n, bool value) {
+    const sizeType oldWords = num_words();
+    const sizeType newWords = word_count(n);
+    if(newWords > nwords) {
+        reserve_words(std::max(newWords, nwords * 2));
+    }
+    if(n > nbits) {
+        // 最后一个字中多余的位始终为0，新增的位只需要在value为1时置位
+        if(value) {
+            if(nbits % bitsPerWord) {
+                words[oldWords - 1] |= ~wordType(0) << (nbits % bitsPerWord);
+            }
+            memset(words + oldWords, 0xff, (newWords - oldWords) * sizeof(wordType));
+        } else {
+            memset(words + oldWords, 0, (newWords - oldWords) * sizeof(wordType));
+        }
+    }
+    nbits = n;
+    sanitize();
+    rankValid = false;
+}
+
+inline void dynamic_bitset::push_back(bool value) {
+    if(nbits == capacity()) {
+        reserve_words(nwords ? nwords * 2 : 1);
+    }
+    if(nbits % bitsPerWord == 0) {
+        words[nbits / bitsPerWord] = 0;
+    }
+    ++nbits;
+    set(nbits - 1, value);
+}
+
+/*************************************************************************************/
+// 全部位的操作与批量位运算                                                            /
+/*************************************************************************************/
+inline dynamic_bitset& dynamic_bitset::set() {
+    memset(words, 0xff, num_words() * sizeof(wordType));
+    sanitize();
+    rankValid = false;
+    return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::reset() {
+    memset(words, 0, num_words() * sizeof(wordType));
+    rankValid = false;
+    return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::flip() {
+    wordType* w = words;
+    const sizeType n = num_words();
+    for(sizeType i = 0; i < n; ++i) w[i] = ~w[i];
+    sanitize();
+    rankValid = false;
+    return *this;
+}
+
+// 以下循环都是简单的逐字运算，没有分支，-O2/-O3下会被编译成SIMD指令
+inline dynamic_bitset& dynamic_bitset::operator&=(const dynamic_bitset& rhs) {
+    assert(nbits == rhs.nbits);
+    wordType* w = words;
+    const wordType* r = rhs.words;
+    const sizeType n = num_words();
+    for(sizeType i = 0; i < n; ++i) w[i] &= r[i];
+    rankValid = false;
+    return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator|=(const dynamic_bitset& rhs) {
+    assert(nbits == rhs.nbits);
+    wordType* w = words;
+    const wordType* r = rhs.words;
+    const sizeType n = num_words();
+    for(sizeType i = 0; i < n; ++i) w[i] |= r[i];
+    rankValid = false;
+    return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::operator^=(const dynamic_bitset& rhs) {
+    assert(nbits == rhs.nbits);
+    wordType* w = words;
+    const wordType* r = rhs.words;
+    const sizeType n = num_words();
+    for(sizeType i = 0; i < n; ++i) w[i] ^= r[i];
+    rankValid = false;
+    return *this;
+}
+
+inline dynamic_bitset& dynamic_bitset::andnot(const dynamic_bitset& rhs) {
+    assert(nbits == rhs.nbits);
+    wordType* w = words;
+    const wordType* r = rhs.words;
+    const sizeType n = num_words();
+    for(sizeType i = 0; i < n; ++i) w[i] &= ~r[i];
+    rankValid = false;
+    return *this;
+}
+
+/*************************************************************************************/
+// 统计与查找                                                                         /
+/*************************************************************************************/
+inline dynamic_bitset::sizeType dynamic_bitset::count() const {
+    // 4路累加打断依赖链，方便编译器展开和向量化
+    const wordType* w = words;
+    const sizeType n = num_words();
+    sizeType c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    sizeType i = 0;
+    for(; i + 4 <= n; i += 4) {
+        c0 += bitset_popcount(w[i]);
+        c1 += bitset_popcount(w[i + 1]);
+        c2 += bitset_popcount(w[i + 2]);
+        c3 += bitset_popcount(w[i + 3]);
+    }
+    for(; i < n; ++i) c0 += bitset_popcount(w[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+inline void dynamic_bitset::build_rank_index() {
+    const sizeType n = num_words();
+    const sizeType blocks = n / BITSET_SUPERBLOCK_WORDS + 1;
+    rankIndex = mystl::vector<sizeType>(blocks, 0);
+    sizeType ones = 0;
+    for(sizeType b = 0; b < blocks; ++b) {
+        rankIndex[b] = ones;
+        const sizeType first = b * BITSET_SUPERBLOCK_WORDS;
+        const sizeType last = std::min(n, first + BITSET_SUPERBLOCK_WORDS);
+        for(sizeType i = first; i < last; ++i) ones += bitset_popcount(words[i]);
+    }
+    rankValid = true;
+}
+
+inline dynamic_bitset::sizeType dynamic_bitset::rank(sizeType pos) const {
+    assert(rankValid && pos <= nbits);
+    const sizeType wordIdx = pos / bitsPerWord;
+    const sizeType block = wordIdx / BITSET_SUPERBLOCK_WORDS;
+    sizeType ones = rankIndex[block];
+    for(sizeType i = block * BITSET_SUPERBLOCK_WORDS; i < wordIdx; ++i) {
+        ones += bitset_popcount(words[i]);
+    }
+    if(pos % bitsPerWord) {
+        ones += bitset_popcount(words[wordIdx] & ((wordType(1) << (pos % bitsPerWord)) - 1));
+    }
+    return ones;
+}
+
+inline dynamic_bitset::sizeType dynamic_bitset::select(sizeType k) const {
+    assert(rankValid);
+    const sizeType blocks = rankIndex.size();
+    // 二分找到最后一个 rankIndex[b] <= k 的超级块
+    sizeType lo = 0, hi = blocks;
+    while(hi - lo > 1) {
+        const sizeType mid = lo + (hi - lo) / 2;
+        if(rankIndex[mid] <= k) lo = mid;
+        else hi = mid;
+    }
+    k -= rankIndex[lo];
+    const sizeType n = num_words();
+    for(sizeType i = lo * BITSET_SUPERBLOCK_WORDS; i < n; ++i) {
+        const sizeType c = bitset_popcount(words[i]);
+        if(k < c) {
+            return i * bitsPerWord + bitset_select_word(words[i], k);
+        }
+        k -= c;
+    }
+    return npos;
+}
+
+inline bool operator==(const dynamic_bitset& x, const dynamic_bitset& y) {
+    return x.nbits == y.nbits &&
+           (x.nbits == 0 ||
+            memcmp(x.words, y.words, x.num_words() * sizeof(dynamic_bitset::wordType)) == 0);
+}
+
+inline bool operator!=(const dynamic_bitset& x, const dynamic_bitset& y) {
+    return !(x == y);
+}
+
+inline dynamic_bitset operator&(const dynamic_bitset& x, const dynamic_bitset& y) {
+    dynamic_bitset r(x);
+    return std::move(r &= y);
+}
+
+inline dynamic_bitset operator|(const dynamic_bitset& x, const dynamic_bitset& y) {
+    dynamic_bitset r(x);
+    return std::move(r |= y);
+}
+
+inline dynamic_bitset operator^(const dynamic_bitset& x, const dynamic_bitset& y) {
+    dynamic_bitset r(x);
+    return std::move(r ^= y);
+}
+
+inline void swap(dynamic_bitset& x, dynamic_bitset& y) {
+    x.swap(y);
+}
+
+/*************************************************************************************/
+// helper function                                                                    /
+/*************************************************************************************/
+inline void dynamic_bitset::reserve_words(sizeType n) {
+    if(n <= nwords) return;
+    wordType* newWords = data_allocator::allocate(n);
+    if(num_words()) {
+        memcpy(newWords, words, num_words() * sizeof(wordType));
+    }
+    data_allocator::deallocate(words, nwords);
+    words = newWords;
+    nwords = n;
+}
+
+// 保证最后一个字中超出size的位为0，count/find/==都依赖这一点
+inline void dynamic_bitset::sanitize() {
+    if(nbits % bitsPerWord) {
+        words[nbits / bitsPerWord] &= (wordType(1) << (nbits % bitsPerWord)) - 1;
+    }
+}
+
+inline dynamic_bitset::sizeType dynamic_bitset::find_from(sizeType pos) const {
+    if(pos >= nbits) return npos;
+    sizeType i = pos / bitsPerWord;
+    wordType w = words[i] & (~wordType(0) << (pos % bitsPerWord));
+    const sizeType n = num_words();
+    while(w == 0) {
+        if(++i == n) return npos;
+        w = words[i];
+    }
+    return i * bitsPerWord + bitset_ctz(w);
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef FIXED_VECTOR_H
+#define FIXED_VECTOR_H
+
+// fixed_vector 容量在编译期固定的vector，元素直接放在对象里面，不申请内存
+// T 可以平凡析构时是字面值类型，可以声明成 static constexpr：
+// 在常量求值中用 mystl::vector 算出查找表，再拷贝进 fixed_vector，表格就放在.rodata中，
+// 启动时不需要计算，也不会产生脏页，多个进程共享同一份物理页
+// 所有位置(包括还没使用的)都是构造好的对象，所以T必须可以默认构造
+
+#include "type_traits.h"
+#include "iterator.h"
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <assert.h>
+
+namespace mystl {
+
+template<typename T, size_t N>
+class fixed_vector {
+public:
+    typedef T                   value_type;
+    typedef T*                  pointer;
+    typedef const T*            constPointer;
+    typedef T&                  reference;
+    typedef const T&            constReference;
+    typedef size_t              sizeType;
+    typedef ptrdiff_t           differenceType;
+
+    typedef value_type*         iterator;
+    typedef const value_type*   constIterator;
+
+private:
+    value_type  elems[N ? N : 1];
+    sizeType    count;
+
+public:
+    // 构造
+    constexpr fixed_vector() : elems(), count(0) {}
+    MYSTL_CONSTEXPR14 fixed_vector(sizeType n, const value_type& value) : elems(), count(0) {
+        assign(n, value);
+    }
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    MYSTL_CONSTEXPR14 fixed_vector(Iter first, Iter last) : elems(), count(0) {
+        assign(first, last);
+    }
+    MYSTL_CONSTEXPR14 fixed_vector(std::initializer_list<T> il) : elems(), count(0) {
+        assign(il.begin(), il.end());
+    }
+
+    // 容量
+    static constexpr sizeType capacity() { return N; }
+    constexpr sizeType size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr bool full() const { return count == N; }
+
+    // 元素访问
+    MYSTL_CONSTEXPR14 reference operator[](sizeType n) { return elems[n]; }
+    constexpr constReference operator[](sizeType n) const { return elems[n]; }
+    MYSTL_CONSTEXPR14 reference at(sizeType n) {
+        if(n >= count) throw std::out_of_range("fixed_vector::at");
+        return elems[n];
+    }
+    constexpr constReference at(sizeType n) const {
+        return n < count ? elems[n] : (throw std::out_of_range("fixed_vector::at"), elems[0]);
+    }
+    MYSTL_CONSTEXPR14 reference front() { assert(count); return elems[0]; }
+    constexpr constReference front() const { return elems[0]; }
+    MYSTL_CONSTEXPR14 reference back() { assert(count); return elems[count - 1]; }
+    constexpr constReference back() const { return elems[count - 1]; }
+    MYSTL_CONSTEXPR14 pointer data() { return elems; }
+    constexpr constPointer data() const { return elems; }
+
+    // 迭代器
+    MYSTL_CONSTEXPR14 iterator begin() { return elems; }
+    MYSTL_CONSTEXPR14 iterator end() { return elems + count; }
+    constexpr constIterator begin() const { return elems; }
+    constexpr constIterator end() const { return elems + count; }
+    constexpr constIterator cbegin() const { return elems; }
+    constexpr constIterator cend() const { return elems + count; }
+
+    // 修改，超过容量时抛出 length_error(常量求值中就是编译错误)
+    MYSTL_CONSTEXPR14 void push_back(const value_type& value) {
+        check_room(1);
+        elems[count++] = value;
+    }
+    MYSTL_CONSTEXPR14 void push_back(value_type&& value) {
+        check_room(1);
+        elems[count++] = std::move(value);
+    }
+    template<typename... Args>
+    MYSTL_CONSTEXPR14 reference emplace_back(Args&&... args) {
+        check_room(1);
+        elems[count] = value_type(std::forward<Args>(args)...);
+        return elems[count++];
+    }
+    // 弹出的位置恢复成默认值，保证相同内容的fixed_vector逐字节相同
+    MYSTL_CONSTEXPR14 void pop_back() {
+        assert(count);
+        elems[--count] = value_type();
+    }
+    MYSTL_CONSTEXPR14 void clear() {
+        while(count) elems[--count] = value_type();
+    }
+    MYSTL_CONSTEXPR14 void resize(sizeType n) { resize(n, value_type()); }
+    MYSTL_CONSTEXPR14 void resize(sizeType n, const value_type& value) {
+        if(n > N) throw std::length_error("fixed_vector::resize");
+        while(count < n) elems[count++] = value;
+        while(count > n) elems[--count] = value_type();
+    }
+    MYSTL_CONSTEXPR14 void assign(sizeType n, const value_type& value) {
+        clear();
+        resize(n, value);
+    }
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    MYSTL_CONSTEXPR14 void assign(Iter first, Iter last) {
+        clear();
+        for(; first != last; ++first) push_back(*first);
+    }
+
+private:
+    MYSTL_CONSTEXPR14 void check_room(sizeType n) const {
+        if(N - count < n) throw std::length_error("fixed_vector is full");
+    }
+};
+
+template<typename T, size_t N>
+MYSTL_CONSTEXPR14 bool operator==(const fixed_vector<T, N>& lhs, const fixed_vector<T, N>& rhs) {
+    if(lhs.size() != rhs.size()) return false;
+    for(size_t i = 0; i < lhs.size(); ++i) {
+        if(!(lhs[i] == rhs[i])) return false;
+    }
+    return true;
+}
+
+template<typename T, size_t N>
+MYSTL_CONSTEXPR14 bool operator!=(const fixed_vector<T, N>& lhs, const fixed_vector<T, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+/**
+ * @brief 调用 build() 得到一个容器(一般是常量求值中的 mystl::vector)，把元素拷贝进容量为N的fixed_vector
+ *        编译期申请的内存不能留到运行期，所以结果要先"物化"成fixed_vector：
+ *        static constexpr auto table = mystl::make_fixed_vector<256>(build_table);
+ * @tparam N 容量，必须不小于 build() 返回的元素个数
+ */
+template<size_t N, typename Builder>
+MYSTL_CONSTEXPR14 auto make_fixed_vector(Builder build)
+    -> fixed_vector<typename std::decay<decltype(*build().begin())>::type, N> {
+    typedef typename std::decay<decltype(*build().begin())>::type value_type;
+    const auto& elems = build();
+    return fixed_vector<value_type, N>(elems.begin(), elems.end());
+}
+
+}   // end of namespace mystl
+
+#endif
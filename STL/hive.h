@@ -0,0 +1,518 @@
+#ifndef HIVE_H
+#define HIVE_H
+
+// hive(colony) 插入和删除都是O(1)，元素的地址和迭代器在其他元素插入删除时保持不变
+// 和deque一样把元素放在固定大小的缓冲区(块)里，块的大小沿用 deque_buf_size
+// 每个块带有一个跳跃计数的skipfield，遍历时直接跳过被删除的连续空位
+// 被删除的空位按"连续段"组成块内的空闲链表，插入时优先复用；空块会被释放
+
+#include "allocator.h"
+#include "deque.h"
+
+#include <memory>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef HIVE_MIN_BLOCK_SIZE
+#define HIVE_MIN_BLOCK_SIZE 16
+#endif
+
+typedef unsigned short hiveIndex;                   // 块内下标，块大小不超过 HIVE_NIL
+constexpr hiveIndex HIVE_NIL = static_cast<hiveIndex>(-1);
+
+// 空闲段的链表结点直接放在被删除元素的存储空间里
+struct hiveFreeLink {
+    hiveIndex prev;
+    hiveIndex next;
+};
+
+template<typename T>
+struct hiveSlot {
+    typename std::aligned_storage<
+        (sizeof(T) > sizeof(hiveFreeLink) ? sizeof(T) : sizeof(hiveFreeLink)),
+        (alignof(T) > alignof(hiveFreeLink) ? alignof(T) : alignof(hiveFreeLink))>::type storage;
+
+    T*            value() { return reinterpret_cast<T*>(&storage); }
+    hiveFreeLink* link()  { return reinterpret_cast<hiveFreeLink*>(&storage); }
+};
+
+/**
+ * @brief hive的块
+ *        skip[i] == 0 表示第i个位置上有元素
+ *        长度为L的连续空位段，段首和段尾的skip都是L，段内其他位置的值没有意义
+ *        skip[capacity] 是哨兵，永远为0
+ */
+template<typename T>
+struct hiveBlock {
+    hiveSlot<T>*    elems;
+    hiveIndex*      skip;
+    size_t          capacity;
+    size_t          used;           // [0, used) 中的位置被使用过，used之后的从没构造过
+    size_t          live;           // 块中的元素个数
+    hiveIndex       freeHead;       // 第一个空闲段的段首
+    hiveBlock*      prev;           // 所有块组成的双向链表
+    hiveBlock*      next;
+    hiveBlock*      prevFree;       // 有空闲段的块组成的双向链表
+    hiveBlock*      nextFree;
+};
+
+template<typename T>
+constexpr inline size_t hive_block_size() {
+    return deque_buf_size(sizeof(hiveSlot<T>)) < HIVE_MIN_BLOCK_SIZE
+           ? size_t(HIVE_MIN_BLOCK_SIZE) : deque_buf_size(sizeof(hiveSlot<T>));
+}
+
+/**
+ * @brief hive的迭代器，双向迭代器
+ *        块被释放不会影响指向其他块的迭代器，所以迭代器直接保存块指针而不是map中的位置
+ */
+template<typename T, typename Ref, typename Ptr>
+struct hiveIterator : public iterator<bidirectional_iterator_tag, T> {
+    typedef hiveIterator<T, T&, T*>                 iterator;
+    typedef hiveIterator<T, const T&, const T*>     constIterator;
+    typedef hiveIterator                            self;
+
+    typedef T                                       value_type;
+    typedef Ptr                                     pointer;
+    typedef Ref                                     reference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+    typedef hiveBlock<T>*                           blockPointer;
+
+    blockPointer                                    block;
+    sizeType                                        index;
+
+    hiveIterator() noexcept : block(nullptr), index(0) {}
+    hiveIterator(blockPointer b, sizeType i) noexcept : block(b), index(i) {}
+    hiveIterator(const iterator& hi) : block(hi.block), index(hi.index) {}
+
+    hiveIterator& operator=(const hiveIterator&) = default;
+
+    reference operator*() const { return *block->elems[index].value(); }
+    pointer operator->() const { return block->elems[index].value(); }
+
+    self& operator++() {
+        ++index;
+        // 从有元素的位置前进一步，落点要么有元素，要么是空闲段的段首
+        if(index < block->used) index += block->skip[index];
+        if(index >= block->used && block->next != nullptr) {
+            block = block->next;
+            index = block->skip[0];
+        }
+        return *this;
+    }
+
+    self& operator--() {
+        for(;;) {
+            if(index == 0) {
+                block = block->prev;
+                index = block->used;
+            }
+            --index;
+            const sizeType len = block->skip[index];
+            if(len == 0) break;
+            // index 是空闲段的段尾，段首是 index - len + 1
+            if(len > index) {
+                index = 0;
+            } else {
+                index -= len;
+                break;
+            }
+        }
+        return *this;
+    }
+
+    self operator++(int) {
+        self temp = *this;
+        ++*this;
+        return temp;
+    }
+    self operator--(int) {
+        self temp = *this;
+        --*this;
+        return temp;
+    }
+
+    bool operator==(const self& rhs) const {
+        return block == rhs.block && index == rhs.index;
+    }
+    bool operator!=(const self& rhs) const { return !(*this == rhs); }
+};
+
+/**
+ * @brief hive 模板类
+ *        元素没有固定的顺序，插入的元素可能出现在任意一个空位上
+ *
+ * @tparam T
+ */
+template<typename T>
+class hive {
+public:
+    typedef mystl::allocator<T>                             data_allocator;
+    typedef mystl::allocator<hiveSlot<T>>                   slot_allocator;
+    typedef mystl::allocator<hiveIndex>                     skip_allocator;
+    typedef mystl::allocator<hiveBlock<T>>                  block_allocator;
+    typedef typename data_allocator::value_type             valueType;
+    typedef typename data_allocator::pointer                pointer;
+    typedef typename data_allocator::constPointer           constPointer;
+    typedef typename data_allocator::reference              reference;
+    typedef typename data_allocator::constReference         constReference;
+    typedef typename data_allocator::sizeType               sizeType;
+    typedef typename data_allocator::differenceType         differenceType;
+    typedef hiveBlock<T>*                                   blockPointer;
+
+    typedef hiveIterator<T, T&, T*>                         iterator;
+    typedef hiveIterator<T, const T&, const T*>             constIterator;
+
+    static constexpr sizeType block_size() { return hive_block_size<T>(); }
+    static_assert(hive_block_size<T>() < HIVE_NIL, "hive block is too large");
+
+private:
+    blockPointer    firstBlock;
+    blockPointer    lastBlock;
+    blockPointer    freeBlocks;     // 有空闲段的块
+    blockPointer    spareBlock;     // 缓存一个空块，避免在块边界反复插入删除时频繁申请释放
+    sizeType        nsize;
+    sizeType        nblocks;
+
+public:
+    // 构造
+    hive() noexcept
+    : firstBlock(nullptr), lastBlock(nullptr), freeBlocks(nullptr),
+      spareBlock(nullptr), nsize(0), nblocks(0) {}
+    hive(sizeType n, const valueType& value) : hive() {
+        for(sizeType i = 0; i < n; ++i) insert(value);
+    }
+
+    // 拷贝
+    hive(const hive& rhs) : hive() {
+        try {
+            for(auto it = rhs.begin(); it != rhs.end(); ++it) insert(*it);
+        } catch(...) {
+            clear();
+            throw;
+        }
+    }
+    hive& operator=(const hive& rhs) {
+        if(this != &rhs) {
+            hive temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    // 移动
+    hive(hive&& rhs) noexcept : hive() { swap(rhs); }
+    hive& operator=(hive&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~hive() { clear(); }
+
+    // 迭代器相关
+    iterator begin() const {
+        return firstBlock ? iterator(firstBlock, firstBlock->skip[0]) : iterator();
+    }
+    iterator end() const {
+        return lastBlock ? iterator(lastBlock, lastBlock->used) : iterator();
+    }
+    constIterator cbegin() const { return begin(); }
+    constIterator cend()   const { return end(); }
+
+    // 容量
+    bool        empty()         const { return nsize == 0; }
+    sizeType    size()          const { return nsize; }
+    sizeType    block_count()   const { return nblocks; }
+    sizeType    capacity()      const { return nblocks * block_size(); }
+
+    // insert / emplace，O(1)
+    iterator insert(const valueType& value) { return emplace(value); }
+    iterator insert(valueType&& value) { return emplace(std::move(value)); }
+    template<typename... Args>
+    iterator emplace(Args&&...);
+
+    // erase，O(1)，返回下一个元素的迭代器
+    iterator erase(constIterator);
+    iterator erase(constIterator, constIterator);
+    void     clear() noexcept;
+
+    // 由元素的地址得到迭代器，O(块数)；p 不是活着的元素(不在hive里或者已经删除)时返回end()
+    iterator get_iterator(constPointer) const;
+
+    void swap(hive& rhs) noexcept {
+        using std::swap;
+        swap(firstBlock, rhs.firstBlock);
+        swap(lastBlock, rhs.lastBlock);
+        swap(freeBlocks, rhs.freeBlocks);
+        swap(spareBlock, rhs.spareBlock);
+        swap(nsize, rhs.nsize);
+        swap(nblocks, rhs.nblocks);
+    }
+
+private:
+    // helper function
+    blockPointer    allocate_block();
+    void            deallocate_block(blockPointer) noexcept;
+    void            release_block(blockPointer) noexcept;
+    void            link_free_block(blockPointer) noexcept;
+    void            unlink_free_block(blockPointer) noexcept;
+    static void     replace_free_run(blockPointer, const hiveFreeLink&, sizeType) noexcept;
+    static void     remove_free_run(blockPointer, const hiveFreeLink&) noexcept;
+};
+
+template<typename T>
+template<typename... Args>
+typename hive<T>::iterator hive<T>::emplace(Args&&... args) {
+    if(freeBlocks != nullptr) {
+        // 复用第一个空闲段的段首
+        blockPointer blk = freeBlocks;
+        const sizeType pos = blk->freeHead;
+        const sizeType len = blk->skip[pos];
+        const hiveFreeLink link = *blk->elems[pos].link();
+        try {
+            data_allocator::construct(blk->elems[pos].value(), std::forward<Args>(args)...);
+        } catch(...) {
+            *blk->elems[pos].link() = link;
+            throw;
+        }
+        blk->skip[pos] = 0;
+        if(len > 1) {
+            // 段首后移一位，链表结点也跟着移动
+            blk->skip[pos + 1] = blk->skip[pos + len - 1] = static_cast<hiveIndex>(len - 1);
+            *blk->elems[pos + 1].link() = link;
+            replace_free_run(blk, link, pos + 1);
+        } else {
+            remove_free_run(blk, link);
+            if(blk->freeHead == HIVE_NIL) unlink_free_block(blk);
+        }
+        ++blk->live;
+        ++nsize;
+        return iterator(blk, pos);
+    }
+    if(lastBlock == nullptr || lastBlock->used == lastBlock->capacity) {
+        blockPointer blk = allocate_block();
+        try {
+            data_allocator::construct(blk->elems[0].value(), std::forward<Args>(args)...);
+        } catch(...) {
+            deallocate_block(blk);
+            throw;
+        }
+        blk->prev = lastBlock;
+        if(lastBlock) lastBlock->next = blk;
+        else firstBlock = blk;
+        lastBlock = blk;
+        blk->used = blk->live = 1;
+        ++nblocks;
+        ++nsize;
+        return iterator(blk, 0);
+    }
+    const sizeType pos = lastBlock->used;
+    data_allocator::construct(lastBlock->elems[pos].value(), std::forward<Args>(args)...);
+    ++lastBlock->used;
+    ++lastBlock->live;
+    ++nsize;
+    return iterator(lastBlock, pos);
+}
+
+template<typename T>
+typename hive<T>::iterator hive<T>::erase(constIterator cpos) {
+    blockPointer blk = cpos.block;
+    const sizeType pos = cpos.index;
+    assert(blk != nullptr && pos < blk->used && blk->skip[pos] == 0);
+    data_allocator::destory(blk->elems[pos].value());
+    --nsize;
+    if(--blk->live == 0) {
+        // 块已经空了，释放整个块
+        blockPointer next = blk->next;
+        release_block(blk);
+        if(next) return iterator(next, next->skip[0]);
+        return end();
+    }
+
+    const bool hadFree = blk->freeHead != HIVE_NIL;
+    const sizeType left = pos > 0 ? blk->skip[pos - 1] : 0;
+    const sizeType right = blk->skip[pos + 1];
+    if(left == 0 && right == 0) {
+        // 新的空闲段，插入链表头
+        blk->skip[pos] = 1;
+        hiveFreeLink* link = blk->elems[pos].link();
+        link->prev = HIVE_NIL;
+        link->next = blk->freeHead;
+        if(blk->freeHead != HIVE_NIL) blk->elems[blk->freeHead].link()->prev = static_cast<hiveIndex>(pos);
+        blk->freeHead = static_cast<hiveIndex>(pos);
+    } else if(right == 0) {
+        // 接在左边段的后面，段首不变
+        blk->skip[pos - left] = blk->skip[pos] = static_cast<hiveIndex>(left + 1);
+    } else if(left == 0) {
+        // 接在右边段的前面，段首前移一位
+        blk->skip[pos] = blk->skip[pos + right] = static_cast<hiveIndex>(right + 1);
+        const hiveFreeLink link = *blk->elems[pos + 1].link();
+        *blk->elems[pos].link() = link;
+        replace_free_run(blk, link, pos);
+    } else {
+        // 把左右两段连起来，右边段从链表中删除
+        blk->skip[pos - left] = blk->skip[pos + right] = static_cast<hiveIndex>(left + right + 1);
+        remove_free_run(blk, *blk->elems[pos + 1].link());
+    }
+    if(!hadFree) link_free_block(blk);
+
+    iterator next(blk, pos + right + 1);
+    if(next.index >= blk->used && blk->next) {
+        next.block = blk->next;
+        next.index = next.block->skip[0];
+    }
+    return next;
+}
+
+template<typename T>
+typename hive<T>::iterator hive<T>::erase(constIterator first, constIterator last) {
+    // last指向元素时它所在的块不会被释放；last是end()时，最后一个块可能被释放，end()需要重新取
+    iterator cur(first.block, first.index);
+    const iterator stop(last.block, last.index);
+    if(stop == end()) {
+        while(cur != end()) cur = erase(cur);
+    } else {
+        while(cur != stop) cur = erase(cur);
+    }
+    return cur;
+}
+
+template<typename T>
+void hive<T>::clear() noexcept {
+    blockPointer blk = firstBlock;
+    while(blk) {
+        blockPointer next = blk->next;
+        if(blk->live) {
+            iterator it(blk, blk->skip[0]);
+            while(it.block == blk && it.index < blk->used) {
+                data_allocator::destory(&*it);
+                ++it;
+            }
+        }
+        deallocate_block(blk);
+        blk = next;
+    }
+    if(spareBlock) deallocate_block(spareBlock);
+    firstBlock = lastBlock = freeBlocks = spareBlock = nullptr;
+    nsize = nblocks = 0;
+}
+
+template<typename T>
+typename hive<T>::iterator hive<T>::get_iterator(constPointer p) const {
+    for(blockPointer blk = firstBlock; blk; blk = blk->next) {
+        const hiveSlot<T>* slot = reinterpret_cast<const hiveSlot<T>*>(p);
+        if(slot >= blk->elems && slot < blk->elems + blk->used) {
+            // 被删除的位置skip不为0
+            const sizeType pos = static_cast<sizeType>(slot - blk->elems);
+            return blk->skip[pos] == 0 ? iterator(blk, pos) : end();
+        }
+    }
+    return end();
+}
+
+/***********************************************************************
+ *                                                                     |
+ * helper function                                                     |
+ *                                                                     |
+ **********************************************************************/
+template<typename T>
+typename hive<T>::blockPointer hive<T>::allocate_block() {
+    if(spareBlock) {
+        blockPointer blk = spareBlock;
+        spareBlock = nullptr;
+        return blk;
+    }
+    blockPointer blk = block_allocator::allocate();
+    try {
+        blk->elems = slot_allocator::allocate(block_size());
+        try {
+            blk->skip = skip_allocator::allocate(block_size() + 1);
+        } catch(...) {
+            slot_allocator::deallocate(blk->elems, block_size());
+            throw;
+        }
+    } catch(...) {
+        block_allocator::deallocate(blk);
+        throw;
+    }
+    for(sizeType i = 0; i <= block_size(); ++i) blk->skip[i] = 0;
+    blk->capacity = block_size();
+    blk->used = blk->live = 0;
+    blk->freeHead = HIVE_NIL;
+    blk->prev = blk->next = blk->prevFree = blk->nextFree = nullptr;
+    return blk;
+}
+
+template<typename T>
+void hive<T>::deallocate_block(blockPointer blk) noexcept {
+    skip_allocator::deallocate(blk->skip, block_size() + 1);
+    slot_allocator::deallocate(blk->elems, block_size());
+    block_allocator::deallocate(blk);
+}
+
+// 把空块从链表中取下，留作备用或者释放
+template<typename T>
+void hive<T>::release_block(blockPointer blk) noexcept {
+    if(blk->freeHead != HIVE_NIL) unlink_free_block(blk);
+    if(blk->prev) blk->prev->next = blk->next;
+    else firstBlock = blk->next;
+    if(blk->next) blk->next->prev = blk->prev;
+    else lastBlock = blk->prev;
+    --nblocks;
+
+    if(spareBlock == nullptr) {
+        for(sizeType i = 0; i < blk->used; ++i) blk->skip[i] = 0;
+        blk->used = 0;
+        blk->freeHead = HIVE_NIL;
+        blk->prev = blk->next = blk->prevFree = blk->nextFree = nullptr;
+        spareBlock = blk;
+    } else {
+        deallocate_block(blk);
+    }
+}
+
+template<typename T>
+void hive<T>::link_free_block(blockPointer blk) noexcept {
+    blk->prevFree = nullptr;
+    blk->nextFree = freeBlocks;
+    if(freeBlocks) freeBlocks->prevFree = blk;
+    freeBlocks = blk;
+}
+
+template<typename T>
+void hive<T>::unlink_free_block(blockPointer blk) noexcept {
+    if(blk->prevFree) blk->prevFree->nextFree = blk->nextFree;
+    else freeBlocks = blk->nextFree;
+    if(blk->nextFree) blk->nextFree->prevFree = blk->prevFree;
+    blk->prevFree = blk->nextFree = nullptr;
+}
+
+// 空闲段的段首移动到to，link是原来段首的链表结点，让前后结点改为指向to
+template<typename T>
+void hive<T>::replace_free_run(blockPointer blk, const hiveFreeLink& link, sizeType to) noexcept {
+    if(link.prev != HIVE_NIL) blk->elems[link.prev].link()->next = static_cast<hiveIndex>(to);
+    else blk->freeHead = static_cast<hiveIndex>(to);
+    if(link.next != HIVE_NIL) blk->elems[link.next].link()->prev = static_cast<hiveIndex>(to);
+}
+
+// 把link所在的空闲段从链表中删除，link要在调用前拷贝出来(段首的存储空间可能已经被元素占用)
+template<typename T>
+void hive<T>::remove_free_run(blockPointer blk, const hiveFreeLink& link) noexcept {
+    if(link.prev != HIVE_NIL) blk->elems[link.prev].link()->next = link.next;
+    else blk->freeHead = link.next;
+    if(link.next != HIVE_NIL) blk->elems[link.next].link()->prev = link.prev;
+}
+
+template<typename T>
+void swap(hive<T>& x, hive<T>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
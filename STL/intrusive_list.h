@@ -0,0 +1,288 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+// intrusive_list 侵入式双向链表，链表指针(list_hook)嵌在元素对象里
+// 链表不拥有元素，也不申请任何内存；已知元素对象就能O(1)把它从链表中摘下
+// 元素可以继承 list_hook(base_hook)，也可以把 list_hook 作为成员(member_hook)
+
+#include "iterator.h"
+
+#include <cstddef>
+#include <functional>
+#include <assert.h>
+
+namespace mystl {
+
+// 链表指针，不在链表中时 prev == next == nullptr
+struct list_hook {
+    list_hook* prev;
+    list_hook* next;
+
+    list_hook() noexcept : prev(nullptr), next(nullptr) {}
+    // 复制对象不复制链表关系
+    list_hook(const list_hook&) noexcept : prev(nullptr), next(nullptr) {}
+    list_hook& operator=(const list_hook&) noexcept { return *this; }
+
+    bool is_linked() const { return next != nullptr; }
+
+    // 直接从所在的链表摘下，不会更新链表的size，一般用 intrusive_list::erase
+    void unlink() noexcept {
+        prev->next = next;
+        next->prev = prev;
+        prev = next = nullptr;
+    }
+};
+
+// T 继承 list_hook
+template<typename T>
+struct base_hook {
+    static list_hook*       to_hook(T* p)                { return static_cast<list_hook*>(p); }
+    static const list_hook* to_hook(const T* p)          { return static_cast<const list_hook*>(p); }
+    static T*               to_value(list_hook* h)       { return static_cast<T*>(h); }
+    static const T*         to_value(const list_hook* h) { return static_cast<const T*>(h); }
+};
+
+// list_hook 是 T 的成员 Member，一个对象可以同时挂在多个链表上
+template<typename T, list_hook T::* Member>
+struct member_hook {
+    static size_t offset() {
+        return reinterpret_cast<size_t>(&(static_cast<T*>(nullptr)->*Member));
+    }
+    static list_hook*       to_hook(T* p)                { return &(p->*Member); }
+    static const list_hook* to_hook(const T* p)          { return &(p->*Member); }
+    static T*               to_value(list_hook* h) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset());
+    }
+    static const T*         to_value(const list_hook* h) {
+        return reinterpret_cast<const T*>(reinterpret_cast<const char*>(h) - offset());
+    }
+};
+
+template<typename T, typename Hook, typename Ref, typename Ptr>
+struct intrusiveListIterator : public iterator<bidirectional_iterator_tag, T> {
+    typedef intrusiveListIterator<T, Hook, T&, T*>              iterator;
+    typedef intrusiveListIterator<T, Hook, const T&, const T*>  constIterator;
+    typedef intrusiveListIterator                               self;
+
+    typedef T                                       value_type;
+    typedef Ptr                                     pointer;
+    typedef Ref                                     reference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+
+    list_hook*                                      node;
+
+    intrusiveListIterator() noexcept : node(nullptr) {}
+    explicit intrusiveListIterator(list_hook* n) noexcept : node(n) {}
+    intrusiveListIterator(const iterator& it) noexcept : node(it.node) {}
+
+    intrusiveListIterator& operator=(const intrusiveListIterator&) = default;
+
+    reference operator*()  const { return *Hook::to_value(node); }
+    pointer   operator->() const { return Hook::to_value(node); }
+
+    self& operator++() { node = node->next; return *this; }
+    self& operator--() { node = node->prev; return *this; }
+    self operator++(int) { self temp = *this; node = node->next; return temp; }
+    self operator--(int) { self temp = *this; node = node->prev; return temp; }
+
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+};
+
+/**
+ * @brief 侵入式双向链表，带哨兵的环形链表
+ *        元素的生命周期由使用者管理，元素析构前必须先从链表中摘下
+ *
+ * @tparam T
+ * @tparam Hook base_hook<T> 或 member_hook<T, &T::hook>
+ */
+template<typename T, typename Hook = base_hook<T>>
+class intrusive_list {
+public:
+    typedef T                                                   valueType;
+    typedef T&                                                  reference;
+    typedef const T&                                            constReference;
+    typedef size_t                                              sizeType;
+    typedef ptrdiff_t                                           differenceType;
+
+    typedef intrusiveListIterator<T, Hook, T&, T*>              iterator;
+    typedef intrusiveListIterator<T, Hook, const T&, const T*>  constIterator;
+
+private:
+    list_hook   head;       // 哨兵
+    sizeType    nsize;
+
+public:
+    intrusive_list() noexcept : nsize(0) { head.prev = head.next = &head; }
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+    intrusive_list(intrusive_list&& rhs) noexcept : nsize(0) {
+        head.prev = head.next = &head;
+        splice(end(), rhs);
+    }
+    intrusive_list& operator=(intrusive_list&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            splice(end(), rhs);
+        }
+        return *this;
+    }
+    ~intrusive_list() { clear(); }
+
+    // 迭代器相关
+    iterator        begin()        { return iterator(head.next); }
+    iterator        end()          { return iterator(&head); }
+    constIterator   begin()  const { return constIterator(const_cast<list_hook*>(head.next)); }
+    constIterator   end()    const { return constIterator(const_cast<list_hook*>(&head)); }
+
+    // 元素对象 -> 迭代器，O(1)
+    iterator        iterator_to(T& x)             { return iterator(Hook::to_hook(&x)); }
+    constIterator   iterator_to(const T& x) const {
+        return constIterator(const_cast<list_hook*>(Hook::to_hook(&x)));
+    }
+
+    // 容量
+    bool            empty() const { return head.next == &head; }
+    sizeType        size()  const { return nsize; }
+
+    // 元素访问
+    reference       front()       { assert(!empty()); return *begin(); }
+    constReference  front() const { assert(!empty()); return *begin(); }
+    reference       back()        { assert(!empty()); return *iterator(head.prev); }
+    constReference  back()  const { assert(!empty()); return *constIterator(head.prev); }
+
+    // 修改，元素不能已经在某个链表中
+    void push_front(T& x) { link_before(head.next, Hook::to_hook(&x)); }
+    void push_back(T& x)  { link_before(&head, Hook::to_hook(&x)); }
+    void pop_front() { assert(!empty()); erase(begin()); }
+    void pop_back()  { assert(!empty()); erase(iterator(head.prev)); }
+
+    iterator insert(iterator pos, T& x) {
+        list_hook* h = Hook::to_hook(&x);
+        link_before(pos.node, h);
+        return iterator(h);
+    }
+
+    // 摘下元素，返回下一个元素的迭代器
+    iterator erase(iterator pos) {
+        assert(pos.node != &head);
+        list_hook* next = pos.node->next;
+        pos.node->unlink();
+        --nsize;
+        return iterator(next);
+    }
+    iterator erase(iterator first, iterator last) {
+        while(first != last) first = erase(first);
+        return last;
+    }
+    void erase(T& x) { erase(iterator_to(x)); }
+
+    void clear() noexcept {
+        list_hook* cur = head.next;
+        while(cur != &head) {
+            list_hook* next = cur->next;
+            cur->prev = cur->next = nullptr;
+            cur = next;
+        }
+        head.prev = head.next = &head;
+        nsize = 0;
+    }
+
+    // 把x的所有元素移动到pos之前
+    void splice(iterator pos, intrusive_list& x) {
+        if(x.empty()) return;
+        transfer(pos.node, x.head.next, &x.head);
+        nsize += x.nsize;
+        x.nsize = 0;
+    }
+    // 把x中的it移动到pos之前，x可以是自身
+    void splice(iterator pos, intrusive_list& x, iterator it) {
+        list_hook* next = it.node->next;
+        if(pos.node == it.node || pos.node == next) return;
+        transfer(pos.node, it.node, next);
+        ++nsize;
+        --x.nsize;
+    }
+    // 把x中的[first, last)移动到pos之前，x不是自身时需要O(n)统计移动的个数
+    void splice(iterator pos, intrusive_list& x, iterator first, iterator last) {
+        if(first == last) return;
+        if(&x != this) {
+            sizeType n = 0;
+            for(iterator it = first; it != last; ++it) ++n;
+            nsize += n;
+            x.nsize -= n;
+        }
+        transfer(pos.node, first.node, last.node);
+    }
+
+    // 两个链表都按comp有序，把x合并进来，稳定
+    template<typename Compare>
+    void merge(intrusive_list& x, Compare comp) {
+        if(&x == this) return;
+        iterator first1 = begin(), last1 = end();
+        iterator first2 = x.begin(), last2 = x.end();
+        while(first1 != last1 && first2 != last2) {
+            if(comp(*first2, *first1)) {
+                iterator next = first2;
+                ++next;
+                transfer(first1.node, first2.node, next.node);
+                first2 = next;
+            } else {
+                ++first1;
+            }
+        }
+        if(first2 != last2) transfer(last1.node, first2.node, last2.node);
+        nsize += x.nsize;
+        x.nsize = 0;
+    }
+    void merge(intrusive_list& x) { merge(x, std::less<T>()); }
+
+    void reverse() noexcept {
+        list_hook* cur = &head;
+        do {
+            list_hook* temp = cur->next;
+            cur->next = cur->prev;
+            cur->prev = temp;
+            cur = temp;
+        } while(cur != &head);
+    }
+
+    void swap(intrusive_list& rhs) noexcept {
+        intrusive_list temp(std::move(rhs));
+        rhs = std::move(*this);
+        *this = std::move(temp);
+    }
+
+private:
+    void link_before(list_hook* pos, list_hook* h) {
+        assert(!h->is_linked());
+        h->prev = pos->prev;
+        h->next = pos;
+        pos->prev->next = h;
+        pos->prev = h;
+        ++nsize;
+    }
+    // 把[first, last)移动到pos之前，pos不能在[first, last)中
+    static void transfer(list_hook* pos, list_hook* first, list_hook* last) {
+        if(pos == last) return;
+        list_hook* tail = last->prev;
+        // 从原来的位置摘下
+        first->prev->next = last;
+        last->prev = first->prev;
+        // 接到pos之前
+        tail->next = pos;
+        first->prev = pos->prev;
+        pos->prev->next = first;
+        pos->prev = tail;
+    }
+};
+
+template<typename T, typename Hook>
+void swap(intrusive_list<T, Hook>& x, intrusive_list<T, Hook>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
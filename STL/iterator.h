@@ -2,15 +2,22 @@
 #define ITERATOR_H
 
 #include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "type_traits.h"
+
 namespace mystl {
 
 // 五种迭代器, 每一种都是结构体
 // 就是迭代器模板中的Category
-struct input_iterator_tag {};
-struct output_iterator_tag {};
-struct forward_iterator_tag : public input_iterator_tag {};
-struct bidirectional_iterator_tag : public forward_iterator_tag {};
-struct random_access_iterator_tag : public bidirectional_iterator_tag {};
+// 直接使用std的五个tag：std容器/流迭代器可以传给mystl的算法和容器，
+// mystl的迭代器也能用在std的算法里
+typedef std::input_iterator_tag             input_iterator_tag;
+typedef std::output_iterator_tag            output_iterator_tag;
+typedef std::forward_iterator_tag           forward_iterator_tag;
+typedef std::bidirectional_iterator_tag     bidirectional_iterator_tag;
+typedef std::random_access_iterator_tag     random_access_iterator_tag;
 
 
 // 任何迭代器都应该包含这五个内嵌型别
@@ -27,8 +34,22 @@ struct iterator {
 // iterator traits
 // 五种常用迭代器相应型别，必须包含
 // 泛化版本，针对class type，如果是原生指针不符合，需偏特化版本
+// 没有iterator_category的类型(比如int)得到一个空的traits，
+// 这样 _RequireInputIter<int> 是替换失败而不是编译错误
+template<typename T>
+struct __has_iterator_category {
+private:
+    template<typename U> static char test(typename U::iterator_category*);
+    template<typename U> static long test(...);
+public:
+    static constexpr bool value = sizeof(test<T>(nullptr)) == sizeof(char);
+};
+
+template<typename Iterator, bool = __has_iterator_category<Iterator>::value>
+struct __iterator_traits_impl {};
+
 template<typename Iterator>
-struct iterator_traits {
+struct __iterator_traits_impl<Iterator, true> {
     typedef typename Iterator::iterator_category    iterator_category;
     typedef typename Iterator::value_type           value_type;
     typedef typename Iterator::difference_type      difference_type;
@@ -36,6 +57,9 @@ struct iterator_traits {
     typedef typename Iterator::reference            reference;
 };
 
+template<typename Iterator>
+struct iterator_traits : public __iterator_traits_impl<Iterator> {};
+
 // 针对原生指针的偏特化版本的iterator traits
 template<typename T>
 struct iterator_traits<T*> {
@@ -64,10 +88,16 @@ using _RequireInputIter = typename
     iterator_traits<_InIter>::iterator_category,
                 input_iterator_tag>::value>::type;
 
+// 至少是前向迭代器，可以先计算距离再遍历一次
+template<typename Iterator>
+struct is_forward_iterator
+    : std::integral_constant<bool, std::is_convertible<typename
+      iterator_traits<Iterator>::iterator_category, forward_iterator_tag>::value> {};
+
 // 占位参数
 // 萃取Iterator的category, valuetype, difftype
 template<typename Iterator>
-typename iterator_traits<Iterator>::iterator_category
+MYSTL_CONSTEXPR14 typename iterator_traits<Iterator>::iterator_category
 iterator_category(const Iterator&) {
     return typename iterator_traits<Iterator>::iterator_category();
 }
@@ -86,58 +116,58 @@ difference_type(const Iterator&) {
 
 // 计算迭代器的距离
 template<typename InputIterator>
-typename iterator_traits<InputIterator>::difference_type
+MYSTL_CONSTEXPR14 typename iterator_traits<InputIterator>::difference_type
 __distance(InputIterator first, InputIterator last,
            input_iterator_tag) {
     typename iterator_traits<InputIterator>::difference_type n = 0;
     while(first != last) {
-        n++;
-        first++;
+        ++n;
+        ++first;
     }
     return n;
 }
 
 template<typename RandomAccessIterator>
-typename iterator_traits<RandomAccessIterator>::difference_type
+MYSTL_CONSTEXPR14 typename iterator_traits<RandomAccessIterator>::difference_type
 __distance(RandomAccessIterator first, RandomAccessIterator last,
            random_access_iterator_tag) {
     return last - first;
 }
 
 template<typename InputIterator>
-typename iterator_traits<InputIterator>::difference_type
+MYSTL_CONSTEXPR14 typename iterator_traits<InputIterator>::difference_type
 distance(InputIterator first, InputIterator last) {
     typedef typename 
         iterator_traits<InputIterator>::iterator_category iterator_category;
-    return __distance(first, last, iterator_category());
+    return mystl::__distance(first, last, iterator_category());
     // return __distance(first, last, iterator_category(first));
 }
 
 // 让迭代器移动n个距离
 template<typename InputIterator, typename Distance>
-void __advance(InputIterator& it, Distance n, input_iterator_tag) {
+MYSTL_CONSTEXPR14 void __advance(InputIterator& it, Distance n, input_iterator_tag) {
     while(n--) {
-        it++;
+        ++it;
     }
 }
 
 template<typename RandomAccessIterator, typename Distance>
-void __advance(RandomAccessIterator& it, Distance n, random_access_iterator_tag) {
+MYSTL_CONSTEXPR14 void __advance(RandomAccessIterator& it, Distance n, random_access_iterator_tag) {
     it += n;
 }
 
 template<typename BidirectionalIterator, typename Distance>
-void __advance(BidirectionalIterator& it, Distance n, bidirectional_iterator_tag) {
+MYSTL_CONSTEXPR14 void __advance(BidirectionalIterator& it, Distance n, bidirectional_iterator_tag) {
     if(n > 0) {
-        while(n--) it++;
+        while(n--) ++it;
     } else {
-        while(n++) it--;
+        while(n++) --it;
     }
 }
 
 template<typename InputIterator, typename Distance>
-void advance(InputIterator& it, Distance n) {
-    __advance(it, n, iterator_category(it));
+MYSTL_CONSTEXPR14 void advance(InputIterator& it, Distance n) {
+    mystl::__advance(it, n, mystl::iterator_category(it));
 }
 
 
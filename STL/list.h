@@ -0,0 +1,422 @@
+#ifndef LIST_H
+#define LIST_H
+
+// list 双向链表，结点挂在 intrusive_list 上，结点内存来自链表自己的slab池
+// 结点按slab批量申请，同一个链表的结点在内存中比较集中，释放的结点放回池中复用
+// slab只在链表析构时整体释放
+
+#include "allocator.h"
+#include "intrusive_list.h"
+
+#include <initializer_list>
+#include <functional>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef LIST_SLAB_MIN_NODES
+#define LIST_SLAB_MIN_NODES 8
+#endif
+
+#ifndef LIST_SLAB_MAX_NODES
+#define LIST_SLAB_MAX_NODES 512
+#endif
+
+template<typename T>
+struct listNode : public list_hook {
+    T data;
+
+    template<typename... Args>
+    explicit listNode(Args&&... args) : list_hook(), data(std::forward<Args>(args)...) {}
+};
+
+/**
+ * @brief 定长结点的slab池，每个slab的结点数从 LIST_SLAB_MIN_NODES 开始翻倍，
+ *        最多 LIST_SLAB_MAX_NODES；空闲结点组成单链表，链表指针放在结点的存储空间里
+ *
+ * @tparam Node
+ */
+template<typename Node>
+class listNodePool {
+private:
+    struct freeNode { freeNode* next; };
+    struct slab {
+        slab*   next;
+        size_t  count;
+    };
+
+    static_assert(sizeof(Node) >= sizeof(freeNode), "node is too small");
+
+    // slab头之后紧跟着count个结点
+    static constexpr size_t headerSize =
+        (sizeof(slab) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+
+    slab*       slabs;
+    freeNode*   freeHead;
+    freeNode*   freeTail;
+    size_t      nextCount;      // 下一个slab的结点数
+
+public:
+    listNodePool() noexcept
+    : slabs(nullptr), freeHead(nullptr), freeTail(nullptr), nextCount(LIST_SLAB_MIN_NODES) {}
+    listNodePool(const listNodePool&) = delete;
+    listNodePool& operator=(const listNodePool&) = delete;
+    listNodePool(listNodePool&& rhs) noexcept
+    : slabs(rhs.slabs), freeHead(rhs.freeHead), freeTail(rhs.freeTail), nextCount(rhs.nextCount) {
+        rhs.slabs = nullptr;
+        rhs.freeHead = rhs.freeTail = nullptr;
+        rhs.nextCount = LIST_SLAB_MIN_NODES;
+    }
+    ~listNodePool() { release(); }
+
+    // 返回未构造的结点空间
+    Node* allocate() {
+        if(freeHead == nullptr) add_slab();
+        freeNode* p = freeHead;
+        freeHead = p->next;
+        if(freeHead == nullptr) freeTail = nullptr;
+        return reinterpret_cast<Node*>(p);
+    }
+
+    // 结点已经析构
+    void deallocate(Node* node) noexcept {
+        freeNode* p = reinterpret_cast<freeNode*>(node);
+        p->next = freeHead;
+        freeHead = p;
+        if(freeTail == nullptr) freeTail = p;
+    }
+
+    // 接管rhs的所有slab和空闲结点，rhs中还活着的结点从此属于this，O(slab数)
+    void absorb(listNodePool& rhs) noexcept {
+        if(rhs.slabs == nullptr) return;
+        slab* last = rhs.slabs;
+        while(last->next != nullptr) last = last->next;
+        last->next = slabs;
+        slabs = rhs.slabs;
+        if(rhs.freeHead != nullptr) {
+            rhs.freeTail->next = freeHead;
+            if(freeHead == nullptr) freeTail = rhs.freeTail;
+            freeHead = rhs.freeHead;
+        }
+        if(rhs.nextCount > nextCount) nextCount = rhs.nextCount;
+        rhs.slabs = nullptr;
+        rhs.freeHead = rhs.freeTail = nullptr;
+        rhs.nextCount = LIST_SLAB_MIN_NODES;
+    }
+
+    // 所有结点都已经析构之后才能调用
+    void release() noexcept {
+        while(slabs != nullptr) {
+            slab* next = slabs->next;
+            slab_delete(slabs);
+            slabs = next;
+        }
+        freeHead = freeTail = nullptr;
+        nextCount = LIST_SLAB_MIN_NODES;
+    }
+
+    void swap(listNodePool& rhs) noexcept {
+        std::swap(slabs, rhs.slabs);
+        std::swap(freeHead, rhs.freeHead);
+        std::swap(freeTail, rhs.freeTail);
+        std::swap(nextCount, rhs.nextCount);
+    }
+
+    size_t slab_count() const {
+        size_t n = 0;
+        for(slab* s = slabs; s != nullptr; s = s->next) ++n;
+        return n;
+    }
+
+private:
+    // 结点的对齐超过普通 operator new 的保证时走对齐的分配
+    static slab* slab_new(size_t bytes) {
+        if(alignof(Node) > default_new_alignment)
+            return static_cast<slab*>(aligned_operator_new(bytes, alignof(Node)));
+        return static_cast<slab*>(::operator new(bytes));
+    }
+    static void slab_delete(slab* s) noexcept {
+        if(alignof(Node) > default_new_alignment) aligned_operator_delete(s, alignof(Node));
+        else ::operator delete(s);
+    }
+
+    void add_slab() {
+        const size_t count = nextCount;
+        slab* s = slab_new(headerSize + count * sizeof(Node));
+        s->next = slabs;
+        s->count = count;
+        slabs = s;
+        if(nextCount < LIST_SLAB_MAX_NODES) nextCount *= 2;
+        // 按地址顺序串起来，顺序分配的结点在内存中也是连续的
+        char* first = reinterpret_cast<char*>(s) + headerSize;
+        for(size_t i = 0; i + 1 < count; ++i) {
+            reinterpret_cast<freeNode*>(first + i * sizeof(Node))->next =
+                reinterpret_cast<freeNode*>(first + (i + 1) * sizeof(Node));
+        }
+        freeTail = reinterpret_cast<freeNode*>(first + (count - 1) * sizeof(Node));
+        freeTail->next = nullptr;
+        freeHead = reinterpret_cast<freeNode*>(first);
+    }
+};
+
+template<typename T, typename Ref, typename Ptr>
+struct listIterator : public iterator<bidirectional_iterator_tag, T> {
+    typedef listIterator<T, T&, T*>                 iterator;
+    typedef listIterator<T, const T&, const T*>     constIterator;
+    typedef listIterator                            self;
+
+    typedef T                                       value_type;
+    typedef Ptr                                     pointer;
+    typedef Ref                                     reference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+
+    list_hook*                                      node;
+
+    listIterator() noexcept : node(nullptr) {}
+    explicit listIterator(list_hook* n) noexcept : node(n) {}
+    listIterator(const iterator& it) noexcept : node(it.node) {}
+
+    listIterator& operator=(const listIterator&) = default;
+
+    reference operator*()  const { return static_cast<listNode<T>*>(node)->data; }
+    pointer   operator->() const { return &static_cast<listNode<T>*>(node)->data; }
+
+    self& operator++() { node = node->next; return *this; }
+    self& operator--() { node = node->prev; return *this; }
+    self operator++(int) { self temp = *this; node = node->next; return temp; }
+    self operator--(int) { self temp = *this; node = node->prev; return temp; }
+
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+};
+
+/**
+ * @brief 双向链表
+ *        splice整个链表、merge时连同对方的slab一起接管，是O(1)的指针操作，迭代器保持有效；
+ *        从另一个链表splice部分元素时，元素被移动到本链表的结点上，原来的迭代器失效
+ *
+ * @tparam T
+ */
+template<typename T>
+class list {
+public:
+    typedef T                                       valueType;
+    typedef T*                                      pointer;
+    typedef const T*                                constPointer;
+    typedef T&                                      reference;
+    typedef const T&                                constReference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+
+    typedef listIterator<T, T&, T*>                 iterator;
+    typedef listIterator<T, const T&, const T*>     constIterator;
+
+private:
+    typedef listNode<T>                             nodeType;
+    typedef intrusive_list<nodeType>                nodeList;
+
+    listNodePool<nodeType>  pool;
+    nodeList                nodes;
+
+public:
+    // 构造
+    // 委托给默认构造，元素构造抛出异常时析构函数会释放已经插入的结点
+    list() noexcept {}
+    explicit list(sizeType n) : list() { while(n--) emplace_back(); }
+    list(sizeType n, const T& value) : list() { while(n--) push_back(value); }
+    template<typename InputIterator,
+             typename = mystl::_RequireInputIter<InputIterator>>
+    list(InputIterator first, InputIterator last) : list() {
+        for(; first != last; ++first) emplace_back(*first);
+    }
+    list(std::initializer_list<T> il) : list() {
+        for(auto it = il.begin(); it != il.end(); ++it) push_back(*it);
+    }
+    list(const list& rhs) : list() {
+        for(constIterator it = rhs.begin(); it != rhs.end(); ++it) push_back(*it);
+    }
+    list(list&& rhs) noexcept
+    : pool(std::move(rhs.pool)), nodes(std::move(rhs.nodes)) {}
+
+    ~list() { clear(); }
+
+    list& operator=(const list& rhs) {
+        if(this != &rhs) {
+            list temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+    list& operator=(list&& rhs) noexcept {
+        if(this != &rhs) {
+            clear();
+            pool.release();
+            pool.swap(rhs.pool);
+            nodes = std::move(rhs.nodes);
+        }
+        return *this;
+    }
+
+    // 迭代器相关
+    iterator        begin()        { return iterator(nodes.begin().node); }
+    iterator        end()          { return iterator(nodes.end().node); }
+    constIterator   begin()  const { return constIterator(nodes.begin().node); }
+    constIterator   end()    const { return constIterator(nodes.end().node); }
+    constIterator   cbegin() const { return begin(); }
+    constIterator   cend()   const { return end(); }
+
+    // 容量
+    bool        empty() const { return nodes.empty(); }
+    sizeType    size()  const { return nodes.size(); }
+
+    // 元素访问
+    reference       front()       { assert(!empty()); return *begin(); }
+    constReference  front() const { assert(!empty()); return *begin(); }
+    reference       back()        { assert(!empty()); return *(--end()); }
+    constReference  back()  const { assert(!empty()); return *(--end()); }
+
+    // 修改
+    template<typename... Args>
+    iterator emplace(constIterator pos, Args&&... args) {
+        nodeType* node = create_node(std::forward<Args>(args)...);
+        nodes.insert(typename nodeList::iterator(pos.node), *node);
+        return iterator(node);
+    }
+    template<typename... Args>
+    void emplace_front(Args&&... args) { emplace(begin(), std::forward<Args>(args)...); }
+    template<typename... Args>
+    void emplace_back(Args&&... args) { emplace(end(), std::forward<Args>(args)...); }
+
+    iterator insert(constIterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(constIterator pos, T&& value) { return emplace(pos, std::move(value)); }
+    void push_front(const T& value) { emplace(begin(), value); }
+    void push_front(T&& value) { emplace(begin(), std::move(value)); }
+    void push_back(const T& value) { emplace(end(), value); }
+    void push_back(T&& value) { emplace(end(), std::move(value)); }
+    void pop_front() { assert(!empty()); erase(begin()); }
+    void pop_back() { assert(!empty()); erase(--end()); }
+
+    iterator erase(constIterator pos) {
+        assert(pos != end());
+        nodeType* node = static_cast<nodeType*>(pos.node);
+        auto next = nodes.erase(nodes.iterator_to(*node));
+        destroy_node(node);
+        return iterator(next.node);
+    }
+    iterator erase(constIterator first, constIterator last) {
+        while(first != last) first = erase(first);
+        return iterator(last.node);
+    }
+    void clear() noexcept {
+        while(!nodes.empty()) {
+            nodeType* node = &nodes.front();
+            nodes.pop_front();
+            destroy_node(node);
+        }
+    }
+
+    void remove(const T& value) {
+        for(iterator it = begin(); it != end(); ) {
+            if(*it == value) it = erase(it);
+            else ++it;
+        }
+    }
+
+    // 把x的所有元素移动到pos之前，O(1)，x的slab也归this所有
+    void splice(constIterator pos, list& x) {
+        if(&x == this || x.empty()) return;
+        nodes.splice(typename nodeList::iterator(pos.node), x.nodes);
+        pool.absorb(x.pool);
+    }
+    void splice(constIterator pos, list&& x) { splice(pos, x); }
+
+    // 把x中的it移动到pos之前
+    void splice(constIterator pos, list& x, constIterator it) {
+        if(&x == this) {
+            nodes.splice(typename nodeList::iterator(pos.node), nodes,
+                         typename nodeList::iterator(it.node));
+        } else {
+            emplace(pos, std::move(*iterator(it.node)));
+            x.erase(it);
+        }
+    }
+
+    // 把x中的[first, last)移动到pos之前，pos不能在[first, last)中
+    void splice(constIterator pos, list& x, constIterator first, constIterator last) {
+        if(&x == this) {
+            nodes.splice(typename nodeList::iterator(pos.node), nodes,
+                         typename nodeList::iterator(first.node),
+                         typename nodeList::iterator(last.node));
+        } else {
+            while(first != last) {
+                constIterator next = first;
+                ++next;
+                splice(pos, x, first);
+                first = next;
+            }
+        }
+    }
+
+    // 两个链表都按comp有序，把x合并进来，稳定，结束后x为空，x的slab归this所有
+    template<typename Compare>
+    void merge(list& x, Compare comp) {
+        if(&x == this) return;
+        nodes.merge(x.nodes, [&comp](const nodeType& a, const nodeType& b) {
+            return comp(a.data, b.data);
+        });
+        pool.absorb(x.pool);
+    }
+    void merge(list& x) { merge(x, std::less<T>()); }
+
+    void reverse() noexcept { nodes.reverse(); }
+
+    void swap(list& rhs) noexcept {
+        pool.swap(rhs.pool);
+        nodes.swap(rhs.nodes);
+    }
+
+    sizeType slab_count() const { return pool.slab_count(); }
+
+private:
+    template<typename... Args>
+    nodeType* create_node(Args&&... args) {
+        nodeType* node = pool.allocate();
+        try {
+            mystl::construct(node, std::forward<Args>(args)...);
+        } catch(...) {
+            pool.deallocate(node);
+            throw;
+        }
+        return node;
+    }
+    void destroy_node(nodeType* node) noexcept {
+        mystl::destory(node);
+        pool.deallocate(node);
+    }
+};
+
+template<typename T>
+bool operator==(const list<T>& x, const list<T>& y) {
+    if(x.size() != y.size()) return false;
+    auto it1 = x.begin();
+    auto it2 = y.begin();
+    for(; it1 != x.end(); ++it1, ++it2) {
+        if(!(*it1 == *it2)) return false;
+    }
+    return true;
+}
+
+template<typename T>
+bool operator!=(const list<T>& x, const list<T>& y) {
+    return !(x == y);
+}
+
+template<typename T>
+void swap(list<T>& x, list<T>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
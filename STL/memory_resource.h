@@ -0,0 +1,558 @@
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+// 运行时可替换的内存资源(对应 std::pmr)
+// 容器类型不变，每个实例在构造时选择从哪里申请内存：请求范围内用 monotonic_buffer_resource 一次性释放，
+// 长期存在的队列用 pool_resource 复用固定大小的块
+// pmr::vector<T> 等是 mystl::vector<T, pmr::polymorphic_allocator<T>> 的别名，
+// polymorphic_allocator 构造元素时把自己传给接受分配器的元素(uses-allocator 构造)，嵌套的 pmr 容器使用同一个资源
+
+#include "allocator.h"
+#include "vector.h"
+#include "deque.h"
+#include "stack.h"
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <memory>
+#include <utility>
+
+// monotonic_buffer_resource 默认的第一块缓冲区大小，之后每块翻倍
+#ifndef PMR_MONOTONIC_INITIAL_SIZE
+#define PMR_MONOTONIC_INITIAL_SIZE 1024
+#endif
+
+// pool_resource 的默认选项：最大的池化块，以及每次向上游申请的块数上限
+#ifndef PMR_POOL_LARGEST_BLOCK
+#define PMR_POOL_LARGEST_BLOCK 4096
+#endif
+
+#ifndef PMR_POOL_MAX_BLOCKS_PER_CHUNK
+#define PMR_POOL_MAX_BLOCKS_PER_CHUNK 1024
+#endif
+
+namespace mystl {
+namespace pmr {
+
+/**
+ * @brief 内存资源的抽象基类，派生类实现 do_allocate/do_deallocate/do_is_equal
+ *        deallocate 要传回 allocate 时的 bytes 和 alignment
+ */
+class memory_resource {
+public:
+    virtual ~memory_resource() {}
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        return do_allocate(bytes, alignment);
+    }
+    void deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        do_deallocate(ptr, bytes, alignment);
+    }
+    // 一个资源申请的内存能否由另一个释放
+    bool is_equal(const memory_resource& other) const noexcept { return do_is_equal(other); }
+
+private:
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& a, const memory_resource& b) noexcept {
+    return &a == &b || a.is_equal(b);
+}
+
+inline bool operator!=(const memory_resource& a, const memory_resource& b) noexcept {
+    return !(a == b);
+}
+
+// ::operator new / ::operator delete，超过默认对齐时用对齐的版本
+class __new_delete_resource : public memory_resource {
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if(alignment > default_new_alignment) return aligned_operator_new(bytes, alignment);
+        return ::operator new(bytes);
+    }
+    void do_deallocate(void* ptr, size_t, size_t alignment) override {
+        if(alignment > default_new_alignment) aligned_operator_delete(ptr, alignment);
+        else ::operator delete(ptr);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return &other == this;
+    }
+};
+
+// 每次申请都抛出 bad_alloc，用来检查 monotonic_buffer_resource 的初始缓冲区是否够用
+class __null_memory_resource : public memory_resource {
+private:
+    void* do_allocate(size_t, size_t) override { throw std::bad_alloc(); }
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const memory_resource& other) const noexcept override { return &other == this; }
+};
+
+// 两个全局资源都不析构，静态对象析构之后仍然可以使用
+inline memory_resource* new_delete_resource() noexcept {
+    static __new_delete_resource* res = new __new_delete_resource;
+    return res;
+}
+
+inline memory_resource* null_memory_resource() noexcept {
+    static __null_memory_resource* res = new __null_memory_resource;
+    return res;
+}
+
+inline std::atomic<memory_resource*>& __default_resource() noexcept {
+    static std::atomic<memory_resource*> res(new_delete_resource());
+    return res;
+}
+
+// 默认构造的 polymorphic_allocator 使用的资源，传 nullptr 恢复为 new_delete_resource
+inline memory_resource* set_default_resource(memory_resource* res) noexcept {
+    if(res == nullptr) res = new_delete_resource();
+    return __default_resource().exchange(res);
+}
+
+inline memory_resource* get_default_resource() noexcept {
+    return __default_resource().load();
+}
+
+// 把 ptr 向上对齐到 alignment(2的幂)
+inline char* __align_up(char* ptr, size_t alignment) {
+    const size_t addr = reinterpret_cast<size_t>(ptr);
+    return ptr + ((alignment - addr % alignment) % alignment);
+}
+
+/**
+ * @brief 单调增长的缓冲区：申请只移动指针，deallocate 什么都不做，release 或析构时一次性还给上游
+ *        可以先用调用者提供的缓冲区(比如栈上的数组)，用完了再向上游申请，每块是上一块的两倍
+ *        适合生命周期相同的一批对象，比如一次请求里构造的所有容器
+ */
+class monotonic_buffer_resource : public memory_resource {
+public:
+    monotonic_buffer_resource() : monotonic_buffer_resource(get_default_resource()) {}
+    explicit monotonic_buffer_resource(memory_resource* upstream)
+        : monotonic_buffer_resource(nullptr, 0, PMR_MONOTONIC_INITIAL_SIZE, upstream) {}
+    explicit monotonic_buffer_resource(size_t initialSize, memory_resource* upstream = get_default_resource())
+        : monotonic_buffer_resource(nullptr, 0, initialSize, upstream) {}
+    monotonic_buffer_resource(void* buffer, size_t size, memory_resource* upstream = get_default_resource())
+        : monotonic_buffer_resource(buffer, size, size, upstream) {}
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+    ~monotonic_buffer_resource() override { release(); }
+
+    // 把向上游申请的块全部还回去，之后重新从初始缓冲区开始
+    void release() {
+        while(chunks) {
+            chunkHeader* next = chunks->next;
+            upstream->deallocate(chunks, chunks->bytes, chunks->alignment);
+            chunks = next;
+        }
+        cur = initialBuffer;
+        last = initialBuffer + initialSize;
+        nextSize = initialNextSize;
+    }
+
+    memory_resource* upstream_resource() const { return upstream; }
+
+private:
+    // 每块开头记录块的大小，release 时按申请时的参数释放
+    struct chunkHeader {
+        chunkHeader*    next;
+        size_t          bytes;
+        size_t          alignment;
+    };
+
+    monotonic_buffer_resource(void* buffer, size_t size, size_t firstChunk, memory_resource* up)
+        : upstream(up),
+          initialBuffer(static_cast<char*>(buffer)),
+          initialSize(buffer ? size : 0),
+          initialNextSize(firstChunk > sizeof(chunkHeader) ? firstChunk : PMR_MONOTONIC_INITIAL_SIZE),
+          cur(initialBuffer),
+          last(initialBuffer + initialSize),
+          nextSize(initialNextSize),
+          chunks(nullptr) {}
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if(bytes == 0) bytes = 1;
+        char* ptr = cur ? __align_up(cur, alignment) : nullptr;
+        if(ptr == nullptr || ptr > last || static_cast<size_t>(last - ptr) < bytes) {
+            new_chunk(bytes, alignment);
+            ptr = __align_up(cur, alignment);
+        }
+        cur = ptr + bytes;
+        return ptr;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override { return &other == this; }
+
+    void new_chunk(size_t bytes, size_t alignment) {
+        const size_t chunkAlign = alignment > alignof(chunkHeader) ? alignment : alignof(chunkHeader);
+        const size_t need = sizeof(chunkHeader) + chunkAlign + bytes;
+        if(need < bytes) throw std::bad_alloc();
+        size_t size = nextSize;
+        while(size < need) size *= 2;
+        void* mem = upstream->allocate(size, chunkAlign);
+        chunkHeader* header = static_cast<chunkHeader*>(mem);
+        header->next = chunks;
+        header->bytes = size;
+        header->alignment = chunkAlign;
+        chunks = header;
+        cur = static_cast<char*>(mem) + sizeof(chunkHeader);
+        last = static_cast<char*>(mem) + size;
+        nextSize = size * 2;
+    }
+
+private:
+    memory_resource*    upstream;
+    char*               initialBuffer;
+    size_t              initialSize;
+    size_t              initialNextSize;
+    char*               cur;            // [cur, last) 是当前块剩余的空间
+    char*               last;
+    size_t              nextSize;       // 下一块的大小
+    chunkHeader*        chunks;         // 向上游申请的块，最新的在前
+};
+
+struct pool_options {
+    size_t max_blocks_per_chunk = 0;          // 0 表示使用默认值
+    size_t largest_required_pool_block = 0;   // 超过它的申请直接交给上游
+};
+
+/**
+ * @brief 按大小分级的内存池，不加锁
+ *        块大小是2的幂(8, 16, ..., largest_required_pool_block)，每级一个空闲链表
+ *        空闲链表空了就向上游申请一大块切成多个块，每次申请的块数翻倍直到 max_blocks_per_chunk
+ *        释放的块回到空闲链表，只有 release 或析构时才还给上游
+ *        超过最大块的申请直接交给上游，用链表记下来，release 时一起释放
+ */
+class unsynchronized_pool_resource : public memory_resource {
+public:
+    unsynchronized_pool_resource() : unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+    explicit unsynchronized_pool_resource(memory_resource* upstream)
+        : unsynchronized_pool_resource(pool_options(), upstream) {}
+    explicit unsynchronized_pool_resource(const pool_options& poolOpts, memory_resource* up = get_default_resource())
+        : upstream(up), opts(normalize(poolOpts)), pools(nullptr), poolCount(0), oversized(nullptr) {
+        for(size_t sz = minBlock; sz < opts.largest_required_pool_block; sz <<= 1) ++poolCount;
+        ++poolCount;
+        pools = static_cast<pool*>(upstream->allocate(poolCount * sizeof(pool), alignof(pool)));
+        for(size_t i = 0; i < poolCount; ++i) {
+            pools[i].freeList = nullptr;
+            pools[i].chunks = nullptr;
+            pools[i].nextBlocks = 1;
+        }
+    }
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+    unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+    ~unsynchronized_pool_resource() override {
+        release();
+        upstream->deallocate(pools, poolCount * sizeof(pool), alignof(pool));
+    }
+
+    void release() {
+        for(size_t i = 0; i < poolCount; ++i) {
+            const size_t blockSize = minBlock << i;
+            for(chunkFooter* c = pools[i].chunks; c != nullptr; ) {
+                chunkFooter* next = c->next;
+                upstream->deallocate(reinterpret_cast<char*>(c) - c->blocks * blockSize,
+                                     c->blocks * blockSize + sizeof(chunkFooter), blockSize);
+                c = next;
+            }
+            pools[i].freeList = nullptr;
+            pools[i].chunks = nullptr;
+            pools[i].nextBlocks = 1;
+        }
+        while(oversized) {
+            bigHeader* next = oversized->next;
+            release_oversized(oversized);
+            oversized = next;
+        }
+    }
+
+    memory_resource* upstream_resource() const { return upstream; }
+    pool_options options() const { return opts; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        const size_t i = pool_index(bytes, alignment);
+        if(i == poolCount) return allocate_oversized(bytes, alignment);
+        pool& p = pools[i];
+        if(p.freeList == nullptr) refill(p, minBlock << i);
+        freeBlock* block = p.freeList;
+        p.freeList = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        const size_t i = pool_index(bytes, alignment);
+        if(i == poolCount) {
+            bigHeader* header = reinterpret_cast<bigHeader*>(static_cast<char*>(ptr) - sizeof(bigHeader));
+            if(header->prev) header->prev->next = header->next;
+            else oversized = header->next;
+            if(header->next) header->next->prev = header->prev;
+            release_oversized(header);
+            return;
+        }
+        freeBlock* block = static_cast<freeBlock*>(ptr);
+        block->next = pools[i].freeList;
+        pools[i].freeList = block;
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override { return &other == this; }
+
+private:
+    static const size_t minBlock = 8;
+
+    struct freeBlock {
+        freeBlock*  next;
+    };
+
+    // 记在块的末尾，块的开头按块大小对齐
+    struct chunkFooter {
+        chunkFooter*    next;
+        size_t          blocks;
+    };
+
+    struct pool {
+        freeBlock*      freeList;
+        chunkFooter*    chunks;
+        size_t          nextBlocks;     // 下次向上游申请的块数
+    };
+
+    // 记在返回的指针前面，offset 是从上游拿到的地址到返回地址的距离
+    struct bigHeader {
+        bigHeader*  prev;
+        bigHeader*  next;
+        size_t      bytes;
+        size_t      alignment;
+        size_t      offset;
+    };
+
+    static pool_options normalize(pool_options opts) {
+        if(opts.max_blocks_per_chunk == 0) opts.max_blocks_per_chunk = PMR_POOL_MAX_BLOCKS_PER_CHUNK;
+        if(opts.largest_required_pool_block == 0) opts.largest_required_pool_block = PMR_POOL_LARGEST_BLOCK;
+        size_t largest = minBlock;
+        while(largest < opts.largest_required_pool_block && largest < (size_t(1) << 20)) largest <<= 1;
+        opts.largest_required_pool_block = largest;
+        return opts;
+    }
+
+    // 块大小取 bytes 和 alignment 中较大的再向上取2的幂，块的地址按块大小对齐，也就满足了 alignment
+    size_t pool_index(size_t bytes, size_t alignment) const {
+        size_t need = bytes > alignment ? bytes : alignment;
+        if(need > opts.largest_required_pool_block) return poolCount;
+        size_t i = 0;
+        for(size_t sz = minBlock; sz < need; sz <<= 1) ++i;
+        return i;
+    }
+
+    void refill(pool& p, size_t blockSize) {
+        const size_t blocks = p.nextBlocks;
+        char* mem = static_cast<char*>(upstream->allocate(blocks * blockSize + sizeof(chunkFooter), blockSize));
+        chunkFooter* footer = reinterpret_cast<chunkFooter*>(mem + blocks * blockSize);
+        footer->next = p.chunks;
+        footer->blocks = blocks;
+        p.chunks = footer;
+        for(size_t k = blocks; k > 0; --k) {
+            freeBlock* block = reinterpret_cast<freeBlock*>(mem + (k - 1) * blockSize);
+            block->next = p.freeList;
+            p.freeList = block;
+        }
+        if(p.nextBlocks < opts.max_blocks_per_chunk) {
+            p.nextBlocks = p.nextBlocks * 2 < opts.max_blocks_per_chunk ? p.nextBlocks * 2 : opts.max_blocks_per_chunk;
+        }
+    }
+
+    void* allocate_oversized(size_t bytes, size_t alignment) {
+        const size_t align = alignment > alignof(bigHeader) ? alignment : alignof(bigHeader);
+        // 头部放在返回地址之前，返回地址按 align 对齐
+        const size_t offset = (sizeof(bigHeader) + align - 1) / align * align;
+        if(bytes > size_t(-1) - offset) throw std::bad_alloc();
+        char* mem = static_cast<char*>(upstream->allocate(bytes + offset, align));
+        bigHeader* header = reinterpret_cast<bigHeader*>(mem + offset - sizeof(bigHeader));
+        header->prev = nullptr;
+        header->next = oversized;
+        header->bytes = bytes;
+        header->alignment = align;
+        header->offset = offset;
+        if(oversized) oversized->prev = header;
+        oversized = header;
+        return mem + offset;
+    }
+
+    void release_oversized(bigHeader* header) {
+        char* mem = reinterpret_cast<char*>(header) + sizeof(bigHeader) - header->offset;
+        upstream->deallocate(mem, header->bytes + header->offset, header->alignment);
+    }
+
+private:
+    memory_resource*    upstream;
+    pool_options        opts;
+    pool*               pools;          // 第i级的块大小是 minBlock << i
+    size_t              poolCount;
+    bigHeader*          oversized;
+};
+
+/**
+ * @brief 加锁的内存池，可以被多个线程共享
+ *        所有操作都在一个互斥锁下转给 unsynchronized_pool_resource
+ */
+class synchronized_pool_resource : public memory_resource {
+public:
+    synchronized_pool_resource() : pool() {}
+    explicit synchronized_pool_resource(memory_resource* upstream) : pool(upstream) {}
+    explicit synchronized_pool_resource(const pool_options& poolOpts, memory_resource* up = get_default_resource())
+        : pool(poolOpts, up) {}
+
+    synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+    synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mtx);
+        pool.release();
+    }
+
+    memory_resource* upstream_resource() const { return pool.upstream_resource(); }
+    pool_options options() const { return pool.options(); }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        return pool.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        pool.deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override { return &other == this; }
+
+private:
+    std::mutex                      mtx;
+    unsynchronized_pool_resource    pool;
+};
+
+/**
+ * @brief 通过 memory_resource 申请内存的分配器，接口和 mystl::allocator 一样但不是静态的
+ *        默认构造时使用 get_default_resource()
+ *        拷贝构造容器时新容器用默认资源，容器赋值不改变资源，swap 时资源跟着交换
+ */
+template<typename T>
+class polymorphic_allocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* constPointer;
+    typedef T& reference;
+    typedef const T& constReference;
+    typedef size_t sizeType;
+    typedef ptrdiff_t differenceType;
+
+    template<typename U>
+    struct rebind { typedef polymorphic_allocator<U> other; };
+
+public:
+    polymorphic_allocator() noexcept : res(get_default_resource()) {}
+    // 可以从 memory_resource* 隐式转换，pmr::vector<int> v(&pool) 这样写
+    polymorphic_allocator(memory_resource* r) noexcept : res(r) {}
+    template<typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept : res(other.resource()) {}
+
+    pointer allocate() const { return allocate(1); }
+    pointer allocate(sizeType n) const {
+        if(n > size_t(-1) / sizeof(T)) throw std::bad_alloc();
+        return static_cast<pointer>(res->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(pointer ptr) const { deallocate(ptr, 1); }
+    void deallocate(pointer ptr, sizeType n) const {
+        if(ptr != nullptr) res->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    // uses-allocator 构造：元素接受这个分配器时把分配器传给它
+    // 优先 U(allocator_arg, alloc, args...)，其次 U(args..., alloc)，否则普通构造
+    template<typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) const {
+        construct_impl(ptr, uses_allocator_tag<U, Args...>(), std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destory(U* ptr) const { mystl::destory(ptr); }
+    template<typename U>
+    void destory(U* first, U* last) const { mystl::destory(first, last); }
+
+    polymorphic_allocator select_on_container_copy_construction() const { return polymorphic_allocator(); }
+
+    memory_resource* resource() const noexcept { return res; }
+
+private:
+    typedef std::integral_constant<int, 0> plain_tag;
+    typedef std::integral_constant<int, 1> leading_tag;
+    typedef std::integral_constant<int, 2> trailing_tag;
+
+    template<typename U, typename... Args>
+    using uses_allocator_tag = std::integral_constant<int,
+        !mystl::uses_allocator<U, polymorphic_allocator>::value ? 0 :
+        std::is_constructible<U, std::allocator_arg_t, const polymorphic_allocator&, Args...>::value ? 1 :
+        std::is_constructible<U, Args..., const polymorphic_allocator&>::value ? 2 : -1>;
+
+    template<typename U, typename... Args>
+    void construct_impl(U* ptr, plain_tag, Args&&... args) const {
+        mystl::construct(ptr, std::forward<Args>(args)...);
+    }
+
+    template<typename U, typename... Args>
+    void construct_impl(U* ptr, leading_tag, Args&&... args) const {
+        ::new(static_cast<void*>(ptr)) U(std::allocator_arg, *this, std::forward<Args>(args)...);
+    }
+
+    template<typename U, typename... Args>
+    void construct_impl(U* ptr, trailing_tag, Args&&... args) const {
+        ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)..., *this);
+    }
+
+    template<typename U, typename... Args>
+    void construct_impl(U*, std::integral_constant<int, -1>, Args&&...) const {
+        static_assert(sizeof(U) == 0, "uses-allocator construction: no constructor takes the allocator");
+    }
+
+private:
+    memory_resource* res;
+};
+
+template<typename T, typename U>
+bool operator==(const polymorphic_allocator<T>& a, const polymorphic_allocator<U>& b) noexcept {
+    return *a.resource() == *b.resource();
+}
+
+template<typename T, typename U>
+bool operator!=(const polymorphic_allocator<T>& a, const polymorphic_allocator<U>& b) noexcept {
+    return !(a == b);
+}
+
+template<typename T>
+using vector = mystl::vector<T, polymorphic_allocator<T>>;
+
+template<typename T>
+using deque = mystl::deque<T, polymorphic_allocator<T>>;
+
+template<typename T>
+using stack = mystl::stack<T, pmr::deque<T>>;
+
+}   // end of namespace pmr
+
+// pmr 容器批量构造元素时也要逐个经过 polymorphic_allocator::construct，把资源传给嵌套的容器
+template<typename U, typename T>
+struct needs_allocator_construct<pmr::polymorphic_allocator<U>, T>
+    : uses_allocator<T, pmr::polymorphic_allocator<U>> {};
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,339 @@
+#ifndef MMAP_VECTOR_H
+#define MMAP_VECTOR_H
+
+// mmap_vector 以文件为存储的vector，只能存放平凡可拷贝的类型
+// 打开时只做一次mmap，不读取也不拷贝数据，启动是O(1)的；页缓存由内核管理，多个进程可以共享
+// 文件布局：64字节的文件头(magic、元素大小、元素个数) + capacity 个元素
+// 扩容时 ftruncate 扩大文件再 mremap，元素的地址可能改变，和vector一样迭代器会失效
+
+#include "vector.h"
+
+#include <stdexcept>
+#include <system_error>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mystl {
+
+enum class mmap_mode {
+    read_only,      // 只读打开已有的文件
+    read_write,     // 读写打开，文件不存在时创建
+    truncate        // 读写打开，清空已有的内容
+};
+
+// madvise 的访问模式提示
+enum class mmap_advice {
+    normal      = MADV_NORMAL,
+    sequential  = MADV_SEQUENTIAL,
+    random      = MADV_RANDOM,
+    willneed    = MADV_WILLNEED,
+    dontneed    = MADV_DONTNEED
+};
+
+struct mmapVectorHeader {
+    char        magic[8];
+    uint64_t    elemSize;
+    uint64_t    size;
+    uint64_t    reserved[5];
+};
+
+static_assert(sizeof(mmapVectorHeader) == 64, "mmap_vector header must be 64 bytes");
+
+template<typename T>
+class mmap_vector {
+public:
+    typedef T                                       value_type;
+    typedef T*                                      pointer;
+    typedef const T*                                constPointer;
+    typedef T&                                      reference;
+    typedef const T&                                constReference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+
+    typedef T*                                      iterator;
+    typedef const T*                                constIterator;
+
+    static_assert(std::is_trivially_copyable<T>::value, "mmap_vector requires a trivially copyable T");
+    static_assert(alignof(T) <= sizeof(mmapVectorHeader), "mmap_vector element is over-aligned");
+
+private:
+    static constexpr const char* magicString() { return "MYSTLMV1"; }
+    static constexpr sizeType headerSize = sizeof(mmapVectorHeader);
+
+    int         fd;
+    bool        writable;
+    char*       base;           // 映射的起始地址，文件头在最前面
+    sizeType    mapLength;      // 映射的字节数，等于文件大小
+    sizeType    cap;
+
+public:
+    mmap_vector(const char* path, mmap_mode mode = mmap_mode::read_write);
+    mmap_vector(const mmap_vector&) = delete;
+    mmap_vector& operator=(const mmap_vector&) = delete;
+    mmap_vector(mmap_vector&& rhs) noexcept
+    : fd(rhs.fd), writable(rhs.writable), base(rhs.base), mapLength(rhs.mapLength), cap(rhs.cap) {
+        rhs.fd = -1;
+        rhs.base = nullptr;
+        rhs.mapLength = rhs.cap = 0;
+    }
+    mmap_vector& operator=(mmap_vector&& rhs) noexcept {
+        if(this != &rhs) {
+            close();
+            fd = rhs.fd;
+            writable = rhs.writable;
+            base = rhs.base;
+            mapLength = rhs.mapLength;
+            cap = rhs.cap;
+            rhs.fd = -1;
+            rhs.base = nullptr;
+            rhs.mapLength = rhs.cap = 0;
+        }
+        return *this;
+    }
+    ~mmap_vector() { close(); }
+
+    // 容量
+    bool        empty()       const { return size() == 0; }
+    sizeType    size()        const { return base ? static_cast<sizeType>(header()->size) : 0; }
+    sizeType    capacity()    const { return cap; }
+    bool        is_writable() const { return writable; }
+    void        reserve(sizeType n) { if(n > cap) remap(n); }
+    void        shrink_to_fit() { if(cap > size()) remap(size()); }
+
+    // 元素访问，只读模式下不能通过非const引用修改元素
+    pointer         data()        { return reinterpret_cast<pointer>(base + headerSize); }
+    constPointer    data()  const { return reinterpret_cast<constPointer>(base + headerSize); }
+    reference       operator[](sizeType n)       { return data()[n]; }
+    constReference  operator[](sizeType n) const { return data()[n]; }
+    reference       at(sizeType n) {
+        if(n >= size()) throw std::out_of_range("mmap_vector::at");
+        return data()[n];
+    }
+    constReference  at(sizeType n) const {
+        if(n >= size()) throw std::out_of_range("mmap_vector::at");
+        return data()[n];
+    }
+    reference       front()       { assert(!empty()); return data()[0]; }
+    constReference  front() const { assert(!empty()); return data()[0]; }
+    reference       back()        { assert(!empty()); return data()[size() - 1]; }
+    constReference  back()  const { assert(!empty()); return data()[size() - 1]; }
+
+    // 迭代器相关
+    iterator        begin()        { return data(); }
+    iterator        end()          { return data() + size(); }
+    constIterator   begin()  const { return data(); }
+    constIterator   end()    const { return data() + size(); }
+    constIterator   cbegin() const { return data(); }
+    constIterator   cend()   const { return data() + size(); }
+
+    // 修改
+    void push_back(const T& value) {
+        assert(writable);
+        const sizeType n = size();
+        if(n == cap) {
+            T temp = value;     // value 可能是自己的元素，remap之后地址会变
+            remap(vector_grow_capacity(cap, n + 1));
+            data()[n] = temp;
+        } else {
+            data()[n] = value;
+        }
+        set_size(n + 1);
+    }
+    template<typename... Args>
+    void emplace_back(Args&&... args) { push_back(T(std::forward<Args>(args)...)); }
+    void pop_back() { assert(writable && !empty()); set_size(size() - 1); }
+    void clear() { assert(writable); set_size(0); }
+    void resize(sizeType n, const T& value = T());
+    // 把[first, last)整块memcpy到末尾
+    void append(const T* first, const T* last);
+
+    // 把修改写回文件；async为true时只发起写回不等待
+    void flush(bool async = false);
+    // 给内核的访问模式提示，作用于整个映射
+    void advise(mmap_advice advice);
+    // 只对[first, first + n)这些元素给出提示
+    void advise(mmap_advice advice, sizeType first, sizeType n);
+
+    void close() noexcept;
+
+    void swap(mmap_vector& rhs) noexcept {
+        std::swap(fd, rhs.fd);
+        std::swap(writable, rhs.writable);
+        std::swap(base, rhs.base);
+        std::swap(mapLength, rhs.mapLength);
+        std::swap(cap, rhs.cap);
+    }
+
+private:
+    mmapVectorHeader*       header()       { return reinterpret_cast<mmapVectorHeader*>(base); }
+    const mmapVectorHeader* header() const { return reinterpret_cast<const mmapVectorHeader*>(base); }
+    void set_size(sizeType n) { header()->size = n; }
+    static sizeType file_length(sizeType capacity) { return headerSize + capacity * sizeof(T); }
+    static void throw_errno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+    void map(sizeType length);
+    void remap(sizeType newCapacity);
+};
+
+template<typename T>
+constexpr typename mmap_vector<T>::sizeType mmap_vector<T>::headerSize;
+
+template<typename T>
+mmap_vector<T>::mmap_vector(const char* path, mmap_mode mode)
+: fd(-1), writable(mode != mmap_mode::read_only), base(nullptr), mapLength(0), cap(0) {
+    int flags = O_RDONLY;
+    if(mode == mmap_mode::read_write) flags = O_RDWR | O_CREAT;
+    if(mode == mmap_mode::truncate) flags = O_RDWR | O_CREAT | O_TRUNC;
+    fd = ::open(path, flags | O_CLOEXEC, 0644);
+    if(fd < 0) throw_errno("mmap_vector: open");
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw_errno("mmap_vector: fstat");
+    }
+    sizeType length = static_cast<sizeType>(st.st_size);
+    try {
+        if(length == 0) {
+            // 新文件，写入文件头
+            if(!writable) throw std::runtime_error("mmap_vector: empty file opened read-only");
+            length = file_length(0);
+            if(::ftruncate(fd, static_cast<off_t>(length)) != 0) throw_errno("mmap_vector: ftruncate");
+            map(length);
+            memcpy(header()->magic, magicString(), sizeof(header()->magic));
+            header()->elemSize = sizeof(T);
+            header()->size = 0;
+        } else {
+            if(length < headerSize) throw std::runtime_error("mmap_vector: file is too small");
+            map(length);
+            if(memcmp(header()->magic, magicString(), sizeof(header()->magic)) != 0 ||
+               header()->elemSize != sizeof(T)) {
+                throw std::runtime_error("mmap_vector: bad file header");
+            }
+        }
+        cap = (length - headerSize) / sizeof(T);
+        if(header()->size > cap) throw std::runtime_error("mmap_vector: bad element count");
+    } catch(...) {
+        close();
+        throw;
+    }
+}
+
+template<typename T>
+void mmap_vector<T>::map(sizeType length) {
+    const int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* p = ::mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED) throw_errno("mmap_vector: mmap");
+    base = static_cast<char*>(p);
+    mapLength = length;
+}
+
+// 调整文件大小和映射，容量变为newCapacity
+template<typename T>
+void mmap_vector<T>::remap(sizeType newCapacity) {
+    assert(writable);
+    const sizeType newLength = file_length(newCapacity);
+    // 缩小时先缩小映射再截断文件，避免映射访问到文件之外
+#ifdef MREMAP_MAYMOVE
+    const bool grow = newLength > mapLength;
+    if(grow && ::ftruncate(fd, static_cast<off_t>(newLength)) != 0) throw_errno("mmap_vector: ftruncate");
+    void* p = ::mremap(base, mapLength, newLength, MREMAP_MAYMOVE);
+    if(p == MAP_FAILED) throw_errno("mmap_vector: mremap");
+    // 映射已经改变，之后截断文件失败时容量也要和映射一致
+    base = static_cast<char*>(p);
+    mapLength = newLength;
+    cap = newCapacity;
+    if(!grow && ::ftruncate(fd, static_cast<off_t>(newLength)) != 0) throw_errno("mmap_vector: ftruncate");
+#else
+    // 没有mremap的平台：重新映射整个文件
+    ::munmap(base, mapLength);
+    base = nullptr;
+    mapLength = cap = 0;
+    if(::ftruncate(fd, static_cast<off_t>(newLength)) != 0) throw_errno("mmap_vector: ftruncate");
+    map(newLength);
+    cap = newCapacity;
+#endif
+}
+
+template<typename T>
+void mmap_vector<T>::resize(sizeType n, const T& value) {
+    assert(writable);
+    const sizeType oldSize = size();
+    if(n > oldSize) {
+        T temp = value;
+        if(n > cap) remap(vector_grow_capacity(cap, n));
+        std::fill(data() + oldSize, data() + n, temp);
+    }
+    set_size(n);
+}
+
+template<typename T>
+void mmap_vector<T>::append(const T* first, const T* last) {
+    assert(writable);
+    const sizeType n = static_cast<sizeType>(last - first);
+    const sizeType oldSize = size();
+    if(oldSize + n > cap) {
+        // first 可能指向自己的元素，remap之前记下偏移
+        const bool inside = first >= data() && first < data() + oldSize;
+        const sizeType offset = inside ? static_cast<sizeType>(first - data()) : 0;
+        remap(vector_grow_capacity(cap, oldSize + n));
+        if(inside) first = data() + offset;
+    }
+    if(n) memmove(static_cast<void*>(data() + oldSize), static_cast<const void*>(first), n * sizeof(T));
+    set_size(oldSize + n);
+}
+
+template<typename T>
+void mmap_vector<T>::flush(bool async) {
+    if(base == nullptr || !writable) return;
+    if(::msync(base, mapLength, async ? MS_ASYNC : MS_SYNC) != 0) throw_errno("mmap_vector: msync");
+}
+
+template<typename T>
+void mmap_vector<T>::advise(mmap_advice advice) {
+    if(base == nullptr) return;
+    if(::madvise(base, mapLength, static_cast<int>(advice)) != 0) throw_errno("mmap_vector: madvise");
+}
+
+template<typename T>
+void mmap_vector<T>::advise(mmap_advice advice, sizeType first, sizeType n) {
+    assert(first + n <= cap);
+    if(base == nullptr || n == 0) return;
+    // madvise 的起始地址必须按页对齐
+    const uintptr_t page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data() + first) & ~(page - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(data() + first + n);
+    if(::madvise(reinterpret_cast<void*>(begin), end - begin, static_cast<int>(advice)) != 0) {
+        throw_errno("mmap_vector: madvise");
+    }
+}
+
+template<typename T>
+void mmap_vector<T>::close() noexcept {
+    if(base != nullptr) {
+        ::munmap(base, mapLength);
+        base = nullptr;
+    }
+    if(fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    mapLength = 0;
+    cap = 0;
+}
+
+template<typename T>
+void swap(mmap_vector<T>& x, mmap_vector<T>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef PACKED_VECTOR_H
+#define PACKED_VECTOR_H
+
+// 压缩存储的无符号整数序列
+// packed_vector：每个值占 bit_width() 位，位宽在运行时决定，放入更大的值时自动加宽
+// sorted_packed_vector：单调不减的序列(ID、时间戳)，每64个值一块，块内存相邻两个值的差，
+//                       每块记下第一个值、位宽和在字数组中的位置(跳表指针)，随机访问只需要解开一块
+// 64个 w 位的值正好占 w 个字，按块打包/解包时位宽是编译期常量，移位量全部是常数，
+// 循环写成编译器可以展开和自动向量化的形式，按位宽查表分派
+
+#include "vector.h"
+#include "type_traits.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <stdexcept>
+
+namespace mystl {
+
+const size_t packed_block_size = 64;
+
+// 放下v需要的位数，0需要0位
+inline unsigned packed_bits_needed(uint64_t v) {
+    return v ? 64 - static_cast<unsigned>(__builtin_clzll(v)) : 0;
+}
+
+inline uint64_t packed_mask(unsigned width) {
+    return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+// 第J个值在块内的位置：第 k 个字的第 s 位开始，s + W > 64 时跨到下一个字
+template<unsigned W, size_t J>
+inline void __packed_pack_one(const uint64_t* in, uint64_t* out) {
+    const unsigned bit = static_cast<unsigned>(J) * W;
+    const unsigned k = bit / 64, s = bit % 64;
+    out[k] |= in[J] << s;
+    if(s + W > 64) out[k + 1] |= in[J] >> ((64 - s) % 64);
+}
+
+template<unsigned W, size_t J>
+inline uint64_t __packed_unpack_one(const uint64_t* in) {
+    const unsigned bit = static_cast<unsigned>(J) * W;
+    const unsigned k = bit / 64, s = bit % 64;
+    uint64_t v = in[k] >> s;
+    if(s + W > 64) v |= in[k + 1] << ((64 - s) % 64);
+    return W >= 64 ? v : v & ((uint64_t(1) << (W % 64)) - 1);
+}
+
+// 用下标序列展开成64条语句，每条的移位量都是常数，不依赖编译器的循环展开
+template<unsigned W, size_t... Js>
+inline void __packed_pack_block(const uint64_t* in, uint64_t* out, index_sequence<Js...>) {
+    for(unsigned k = 0; k < W; ++k) out[k] = 0;
+    const int expand[] = {(__packed_pack_one<W, Js>(in, out), 0)...};
+    (void)expand;
+}
+
+template<unsigned W, size_t... Js>
+inline void __packed_unpack_block(const uint64_t* in, uint64_t* out, index_sequence<Js...>) {
+    const int expand[] = {(out[Js] = __packed_unpack_one<W, Js>(in), 0)...};
+    (void)expand;
+}
+
+// 把64个值(每个不超过W位)打包到 out[0, W)
+template<unsigned W>
+void packed_pack_block(const uint64_t* in, uint64_t* out) {
+    if(W == 0) return;
+    __packed_pack_block<W>(in, out, make_index_sequence<64>());
+}
+
+// 从 in[0, W) 解出64个值
+template<unsigned W>
+void packed_unpack_block(const uint64_t* in, uint64_t* out) {
+    if(W == 0) {
+        for(unsigned j = 0; j < packed_block_size; ++j) out[j] = 0;
+        return;
+    }
+    __packed_unpack_block<W>(in, out, make_index_sequence<64>());
+}
+
+typedef void (*packed_block_fn)(const uint64_t*, uint64_t*);
+
+template<size_t... Ws>
+inline const packed_block_fn* __packed_pack_table(index_sequence<Ws...>) {
+    static const packed_block_fn table[] = {&packed_pack_block<static_cast<unsigned>(Ws)>...};
+    return table;
+}
+
+template<size_t... Ws>
+inline const packed_block_fn* __packed_unpack_table(index_sequence<Ws...>) {
+    static const packed_block_fn table[] = {&packed_unpack_block<static_cast<unsigned>(Ws)>...};
+    return table;
+}
+
+// 位宽 0 ~ 64 的打包/解包
+inline void packed_pack(unsigned width, const uint64_t* in, uint64_t* out) {
+    assert(width <= 64);
+    __packed_pack_table(make_index_sequence<65>())[width](in, out);
+}
+
+inline void packed_unpack(unsigned width, const uint64_t* in, uint64_t* out) {
+    assert(width <= 64);
+    __packed_unpack_table(make_index_sequence<65>())[width](in, out);
+}
+
+// 读写从 base 开始的第i个 width 位的值，调用者保证 base[k + 1] 可以读(末尾留一个字)
+inline uint64_t packed_get(const uint64_t* base, unsigned width, size_t i) {
+    const size_t bit = i * width;
+    const size_t k = bit / 64;
+    const unsigned s = static_cast<unsigned>(bit % 64);
+    // s 为0时高位部分移出去，不会有64位的移位
+    const uint64_t v = (base[k] >> s) | ((base[k + 1] << 1) << (63 - s));
+    return v & packed_mask(width);
+}
+
+inline void packed_set(uint64_t* base, unsigned width, size_t i, uint64_t value) {
+    const size_t bit = i * width;
+    const size_t k = bit / 64;
+    const unsigned s = static_cast<unsigned>(bit % 64);
+    const uint64_t mask = packed_mask(width);
+    base[k] = (base[k] & ~(mask << s)) | (value << s);
+    if(s + width > 64) {
+        const unsigned r = 64 - s;
+        base[k + 1] = (base[k + 1] & ~(mask >> r)) | (value >> r);
+    }
+}
+
+
+/**
+ * @brief 位压缩的整数数组
+ *        第j块(64个值)存放在 words[j * width, (j + 1) * width)，末尾多留一个字让随机读取可以无条件读相邻的字
+ *        push_back/set 的值放不下时整体重新打包到更宽的位宽，位宽最多加宽64次
+ */
+class packed_vector {
+public:
+    typedef uint64_t    valueType;
+    typedef size_t      sizeType;
+
+private:
+    mystl::vector<uint64_t> words;
+    sizeType                count;
+    unsigned                width;
+
+public:
+    explicit packed_vector(unsigned bitWidth = 1) : words(size_t(1), uint64_t(0)), count(0), width(bitWidth) {
+        if(bitWidth == 0 || bitWidth > 64) throw std::invalid_argument("packed_vector: bit width must be in [1, 64]");
+    }
+    // 先算出需要的位宽，只打包一次
+    packed_vector(const valueType* first, const valueType* last) : packed_vector(1) {
+        append(first, static_cast<sizeType>(last - first));
+    }
+
+    // 容量
+    bool        empty()        const { return count == 0; }
+    sizeType    size()         const { return count; }
+    unsigned    bit_width()    const { return width; }
+    // 实际占用的内存(不含对象本身)
+    sizeType    memory_bytes() const { return words.capacity() * sizeof(uint64_t); }
+    void        reserve(sizeType n) { words.reserve((n + packed_block_size - 1) / packed_block_size * width + 1); }
+    void        clear() { words.assign(size_t(1), uint64_t(0)); count = 0; }
+
+    // 元素访问
+    valueType operator[](sizeType i) const {
+        assert(i < count);
+        return packed_get(words.data(), width, i);
+    }
+    valueType at(sizeType i) const {
+        if(i >= count) throw std::out_of_range("packed_vector::at");
+        return (*this)[i];
+    }
+    valueType back() const { assert(count != 0); return (*this)[count - 1]; }
+
+    void set(sizeType i, valueType value) {
+        assert(i < count);
+        ensure_width(packed_bits_needed(value));
+        packed_set(words.data(), width, i, value);
+    }
+
+    void push_back(valueType value) {
+        ensure_width(packed_bits_needed(value));
+        if(count % packed_block_size == 0) add_block();
+        packed_set(words.data(), width, count, value);
+        ++count;
+    }
+
+    void append(const valueType* first, sizeType n);
+
+    // 把 [pos, pos + n) 解到out，返回解出的个数；中间的整块直接解到out
+    sizeType decode(sizeType pos, sizeType n, valueType* out) const;
+
+    // 改成更宽的位宽，newWidth 不能小于当前位宽
+    void widen(unsigned newWidth);
+
+private:
+    void ensure_width(unsigned need) { if(need > width) widen(need); }
+    // 在末尾的保留字之前加一块的字
+    void add_block() { words.insert(words.cend() - 1, size_t(width), uint64_t(0)); }
+    const uint64_t* block_words(sizeType block) const { return words.data() + block * width; }
+};
+
+inline void packed_vector::append(const valueType* first, sizeType n) {
+    if(n == 0) return;
+    uint64_t bits = 0;
+    for(sizeType i = 0; i < n; ++i) bits |= first[i];
+    ensure_width(packed_bits_needed(bits));
+    // 先补齐当前不完整的块，之后整块打包
+    sizeType i = 0;
+    for(; i < n && count % packed_block_size != 0; ++i) push_back(first[i]);
+    reserve(count + (n - i));
+    for(; i + packed_block_size <= n; i += packed_block_size) {
+        add_block();
+        packed_pack(width, first + i, words.data() + (count / packed_block_size) * width);
+        count += packed_block_size;
+    }
+    for(; i < n; ++i) push_back(first[i]);
+}
+
+inline packed_vector::sizeType packed_vector::decode(sizeType pos, sizeType n, valueType* out) const {
+    if(pos >= count) return 0;
+    if(n > count - pos) n = count - pos;
+    sizeType done = 0;
+    // 不在块边界上的开头逐个读
+    for(; done < n && (pos + done) % packed_block_size != 0; ++done) out[done] = (*this)[pos + done];
+    uint64_t tmp[packed_block_size];
+    while(done < n) {
+        const sizeType block = (pos + done) / packed_block_size;
+        if(n - done >= packed_block_size) {
+            packed_unpack(width, block_words(block), out + done);
+            done += packed_block_size;
+        } else {
+            packed_unpack(width, block_words(block), tmp);
+            memcpy(out + done, tmp, (n - done) * sizeof(uint64_t));
+            done = n;
+        }
+    }
+    return n;
+}
+
+inline void packed_vector::widen(unsigned newWidth) {
+    assert(newWidth >= width && newWidth <= 64);
+    if(newWidth == width) return;
+    const sizeType blocks = (count + packed_block_size - 1) / packed_block_size;
+    mystl::vector<uint64_t> wider(blocks * newWidth + 1, uint64_t(0));
+    uint64_t tmp[packed_block_size];
+    for(sizeType b = 0; b < blocks; ++b) {
+        packed_unpack(width, block_words(b), tmp);
+        packed_pack(newWidth, tmp, wider.data() + b * newWidth);
+    }
+    words.swap(wider);
+    width = newWidth;
+}
+
+
+/**
+ * @brief 单调不减的整数序列，按块做差分编码
+ *        每块记录第一个值 base、差值的位宽和差值在 words 中的起始位置，
+ *        块内第j个值 = base + delta[1] + ... + delta[j]，随机访问解开一块再求前缀和
+ *        最后不满64个的值先原样放在 tail 里，凑满一块才编码
+ */
+class sorted_packed_vector {
+public:
+    typedef uint64_t    valueType;
+    typedef size_t      sizeType;
+
+private:
+    struct blockHeader {
+        uint64_t    base;
+        uint64_t    offsetAndWidth;     // 高56位是在words中的起始位置，低8位是位宽
+
+        sizeType offset() const { return static_cast<sizeType>(offsetAndWidth >> 8); }
+        unsigned width()  const { return static_cast<unsigned>(offsetAndWidth & 0xff); }
+    };
+
+    mystl::vector<blockHeader>  blocks;
+    mystl::vector<uint64_t>     words;      // 末尾多留一个字，同 packed_vector
+    uint64_t                    tail[packed_block_size];
+    sizeType                    tailCount;
+    sizeType                    count;
+
+public:
+    sorted_packed_vector() : words(size_t(1), uint64_t(0)), tailCount(0), count(0) {}
+    sorted_packed_vector(const valueType* first, const valueType* last) : sorted_packed_vector() {
+        for(; first != last; ++first) push_back(*first);
+    }
+
+    bool        empty()        const { return count == 0; }
+    sizeType    size()         const { return count; }
+    sizeType    memory_bytes() const {
+        return blocks.capacity() * sizeof(blockHeader) + words.capacity() * sizeof(uint64_t) + sizeof(tail);
+    }
+    void        clear() { blocks.clear(); words.assign(size_t(1), uint64_t(0)); tailCount = 0; count = 0; }
+
+    // 比前一个值小时抛出 invalid_argument
+    void push_back(valueType value) {
+        if(count != 0 && value < back()) throw std::invalid_argument("sorted_packed_vector: values must be non-decreasing");
+        tail[tailCount++] = value;
+        ++count;
+        if(tailCount == packed_block_size) seal_block();
+    }
+
+    valueType back() const {
+        assert(count != 0);
+        return tailCount ? tail[tailCount - 1] : (*this)[count - 1];
+    }
+
+    valueType operator[](sizeType i) const;
+    valueType at(sizeType i) const {
+        if(i >= count) throw std::out_of_range("sorted_packed_vector::at");
+        return (*this)[i];
+    }
+
+    // 把 [pos, pos + n) 解到out，返回解出的个数
+    sizeType decode(sizeType pos, sizeType n, valueType* out) const;
+
+    // 第一个不小于value的下标，没有时返回size()；先在块的base上二分，再解开一块查找
+    sizeType lower_bound(valueType value) const;
+    bool contains(valueType value) const {
+        const sizeType i = lower_bound(value);
+        return i < count && (*this)[i] == value;
+    }
+
+private:
+    void seal_block();
+    // 解开第b块，out 得到64个值
+    void decode_block(sizeType b, valueType* out) const;
+};
+
+inline void sorted_packed_vector::seal_block() {
+    uint64_t deltas[packed_block_size];
+    uint64_t bits = 0;
+    deltas[0] = 0;
+    for(sizeType j = 1; j < packed_block_size; ++j) {
+        deltas[j] = tail[j] - tail[j - 1];
+        bits |= deltas[j];
+    }
+    const unsigned width = packed_bits_needed(bits);
+    blockHeader header;
+    header.base = tail[0];
+    header.offsetAndWidth = (static_cast<uint64_t>(words.size() - 1) << 8) | width;
+    words.insert(words.cend() - 1, size_t(width), uint64_t(0));
+    packed_pack(width, deltas, words.data() + header.offset());
+    blocks.push_back(header);
+    tailCount = 0;
+}
+
+inline void sorted_packed_vector::decode_block(sizeType b, valueType* out) const {
+    const blockHeader& header = blocks[b];
+    packed_unpack(header.width(), words.data() + header.offset(), out);
+    uint64_t v = header.base;
+    for(sizeType j = 0; j < packed_block_size; ++j) {
+        v += out[j];
+        out[j] = v;
+    }
+}
+
+inline sorted_packed_vector::valueType sorted_packed_vector::operator[](sizeType i) const {
+    assert(i < count);
+    const sizeType b = i / packed_block_size;
+    const sizeType j = i % packed_block_size;
+    if(b == blocks.size()) return tail[j];
+    const blockHeader& header = blocks[b];
+    const unsigned width = header.width();
+    uint64_t v = header.base;
+    if(width == 0) return v;
+    // 靠前的位置逐个累加，靠后的整块解开
+    if(j < 16) {
+        const uint64_t* base = words.data() + header.offset();
+        for(sizeType k = 1; k <= j; ++k) v += packed_get(base, width, k);
+        return v;
+    }
+    uint64_t tmp[packed_block_size];
+    packed_unpack(width, words.data() + header.offset(), tmp);
+    for(sizeType k = 1; k <= j; ++k) v += tmp[k];
+    return v;
+}
+
+inline sorted_packed_vector::sizeType sorted_packed_vector::decode(sizeType pos, sizeType n, valueType* out) const {
+    if(pos >= count) return 0;
+    if(n > count - pos) n = count - pos;
+    sizeType done = 0;
+    uint64_t tmp[packed_block_size];
+    while(done < n) {
+        const sizeType b = (pos + done) / packed_block_size;
+        const sizeType j = (pos + done) % packed_block_size;
+        const sizeType k = std::min(n - done, packed_block_size - j);
+        if(b == blocks.size()) {
+            memcpy(out + done, tail + j, k * sizeof(uint64_t));
+        } else if(j == 0 && k == packed_block_size) {
+            decode_block(b, out + done);
+        } else {
+            decode_block(b, tmp);
+            memcpy(out + done, tmp + j, k * sizeof(uint64_t));
+        }
+        done += k;
+    }
+    return n;
+}
+
+inline sorted_packed_vector::sizeType sorted_packed_vector::lower_bound(valueType value) const {
+    // 最后一个 base < value 的块，答案在这一块里或者是下一块的开头
+    sizeType lo = 0, hi = blocks.size();
+    while(lo < hi) {
+        const sizeType mid = lo + (hi - lo) / 2;
+        if(blocks[mid].base < value) lo = mid + 1;
+        else hi = mid;
+    }
+    const sizeType tailStart = blocks.size() * packed_block_size;
+    if(lo == 0 && !blocks.empty()) return 0;
+    if(lo != 0) {
+        uint64_t tmp[packed_block_size];
+        decode_block(lo - 1, tmp);
+        const uint64_t* it = std::lower_bound(tmp, tmp + packed_block_size, value);
+        if(it != tmp + packed_block_size) return (lo - 1) * packed_block_size + static_cast<sizeType>(it - tmp);
+        if(lo < blocks.size()) return lo * packed_block_size;
+    }
+    return tailStart + static_cast<sizeType>(std::lower_bound(tail, tail + tailCount, value) - tail);
+}
+
+}   // end of namespace mystl
+
+#endif
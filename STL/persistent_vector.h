@@ -0,0 +1,644 @@
+#ifndef PERSISTENT_VECTOR_H
+#define PERSISTENT_VECTOR_H
+
+// persistent_vector 是一个持久化(不可变)的vector，拷贝只增加根结点和尾缓冲区的引用计数
+// 结构是32叉的radix balanced tree + 一个尾缓冲区(tail)，参考Clojure的PersistentVector
+// 修改操作只拷贝根到叶子的路径(path copying)，其余结点在各个快照之间共享
+
+#include "allocator.h"
+#include "algobase.h"
+#include "uninitialized.h"
+
+#include <atomic>
+#include <memory>
+#include <assert.h>
+
+#ifndef PVECTOR_SHIFT
+#define PVECTOR_SHIFT 5
+#endif
+
+namespace mystl {
+
+template<typename T>
+class persistent_vector;
+template<typename T>
+class transient_vector;
+
+constexpr size_t PVECTOR_BRANCH = size_t(1) << PVECTOR_SHIFT;
+constexpr size_t PVECTOR_MASK   = PVECTOR_BRANCH - 1;
+
+/**
+ * @brief 树结点的公共部分
+ *        refCount 使用原子操作，快照可以安全地交给其他读线程
+ *        edit 标记创建该结点的transient，同一个transient可以原地修改自己创建的结点
+ */
+struct pvectorNodeBase {
+    std::atomic<size_t>     refCount;
+    size_t                  edit;
+
+    pvectorNodeBase() : refCount(1), edit(0) {}
+};
+
+// 内部结点，孩子是内部结点或者叶子结点，未使用的孩子为nullptr
+struct pvectorBranch : public pvectorNodeBase {
+    pvectorNodeBase*        child[PVECTOR_BRANCH];
+
+    pvectorBranch() {
+        for(size_t i = 0; i < PVECTOR_BRANCH; ++i) child[i] = nullptr;
+    }
+};
+
+// 叶子结点，存放 PVECTOR_BRANCH 个元素，元素的构造/析构由persistent_vector负责
+// 树中的叶子永远是满的，只有tail可能不满，所以叶子自身不需要记录元素个数
+template<typename T>
+struct pvectorLeaf : public pvectorNodeBase {
+    typename std::aligned_storage<sizeof(T) * PVECTOR_BRANCH,
+                                  alignof(T)>::type storage;
+
+    T*       data()       { return reinterpret_cast<T*>(&storage); }
+    const T* data() const { return reinterpret_cast<const T*>(&storage); }
+};
+
+/**
+ * @brief persistent_vector 的迭代器，只读的随机访问迭代器
+ *        缓存当前所在的叶子，顺序遍历时每32个元素才走一次树
+ */
+template<typename T>
+struct pvectorIterator : public iterator<random_access_iterator_tag, T,
+                                         ptrdiff_t, const T*, const T&> {
+    typedef pvectorIterator                         self;
+    typedef T                                       value_type;
+    typedef const T*                                pointer;
+    typedef const T&                                reference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+
+    const persistent_vector<T>*                     vec;
+    sizeType                                        index;
+    mutable const T*                                block;
+    mutable sizeType                                blockStart;
+
+    pvectorIterator() noexcept
+    : vec(nullptr), index(0), block(nullptr), blockStart(0) {}
+
+    pvectorIterator(const persistent_vector<T>* v, sizeType i) noexcept
+    : vec(v), index(i), block(nullptr), blockStart(0) {}
+
+    reference operator*() const {
+        // 无符号回绕，index < blockStart 时同样会重新定位
+        if(block == nullptr || index - blockStart >= PVECTOR_BRANCH) {
+            blockStart = index & ~PVECTOR_MASK;
+            block = vec->array_for(index);
+        }
+        return block[index & PVECTOR_MASK];
+    }
+    pointer operator->() const { return &**this; }
+    reference operator[](differenceType n) const { return *(*this + n); }
+
+    self& operator++() { ++index; return *this; }
+    self& operator--() { --index; return *this; }
+    self operator++(int) { self temp = *this; ++index; return temp; }
+    self operator--(int) { self temp = *this; --index; return temp; }
+
+    self& operator+=(differenceType n) { index += n; return *this; }
+    self& operator-=(differenceType n) { index -= n; return *this; }
+    self operator+(differenceType n) const { self temp = *this; return temp += n; }
+    self operator-(differenceType n) const { self temp = *this; return temp -= n; }
+    differenceType operator-(const self& rhs) const {
+        return static_cast<differenceType>(index) -
+               static_cast<differenceType>(rhs.index);
+    }
+
+    bool operator==(const self& rhs) const { return index == rhs.index; }
+    bool operator!=(const self& rhs) const { return index != rhs.index; }
+    bool operator< (const self& rhs) const { return index < rhs.index; }
+    bool operator> (const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+/**
+ * @brief persistent_vector 模板类
+ *        值语义 + 结构共享：拷贝是O(1)的，之后对任意一方的修改都不会影响另一方
+ *        修改时只有引用计数为1(或者属于当前transient)的结点会被原地修改，其余结点先拷贝
+ *
+ * @tparam T
+ */
+template<typename T>
+class persistent_vector {
+    friend class transient_vector<T>;
+    friend struct pvectorIterator<T>;
+public:
+    typedef mystl::allocator<T>                             data_allocator;
+    typedef mystl::allocator<pvectorLeaf<T>>                leaf_allocator;
+    typedef mystl::allocator<pvectorBranch>                 branch_allocator;
+    typedef typename data_allocator::value_type             valueType;
+    typedef typename data_allocator::pointer                pointer;
+    typedef typename data_allocator::constPointer           constPointer;
+    typedef typename data_allocator::reference              reference;
+    typedef typename data_allocator::constReference         constReference;
+    typedef typename data_allocator::sizeType               sizeType;
+    typedef typename data_allocator::differenceType         differenceType;
+
+    typedef pvectorIterator<T>                              constIterator;
+    typedef constIterator                                   iterator;
+
+private:
+    typedef pvectorLeaf<T>                                  leafNode;
+    typedef pvectorBranch                                   branchNode;
+
+    sizeType        cnt;        // 元素个数
+    sizeType        shift;      // 根结点所在的层，叶子层为0
+    branchNode*     root;       // 树中只存放满的叶子，cnt <= 32 时为nullptr
+    leafNode*       tail;       // 尾缓冲区，存放最后 1 ~ 32 个元素
+    sizeType        editId;     // 非0表示处于transient模式
+
+public:
+    persistent_vector() noexcept
+    : cnt(0), shift(PVECTOR_SHIFT), root(nullptr), tail(nullptr), editId(0) {}
+    persistent_vector(sizeType, const valueType&);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    persistent_vector(Iter first, Iter last);
+
+    // 拷贝只增加引用计数 O(1)
+    persistent_vector(const persistent_vector&) noexcept;
+    persistent_vector& operator=(const persistent_vector&) noexcept;
+
+    persistent_vector(persistent_vector&&) noexcept;
+    persistent_vector& operator=(persistent_vector&&) noexcept;
+
+    ~persistent_vector() { release_all(); }
+
+    // 容量
+    bool        empty()     const { return cnt == 0; }
+    sizeType    size()      const { return cnt; }
+
+    // 元素访问，只提供只读访问，修改请使用set
+    constReference operator[](sizeType n) const {
+        return array_for(n)[n & PVECTOR_MASK];
+    }
+    constReference front() const { assert(!empty()); return (*this)[0]; }
+    constReference back()  const { assert(!empty()); return (*this)[cnt - 1]; }
+
+    // 修改操作，O(log32 n)
+    void push_back(const valueType&);
+    void pop_back();
+    void set(sizeType, const valueType&);
+    void clear() noexcept { release_all(); reset(); }
+
+    // 批量修改，在transient上的修改不需要检查引用计数
+    transient_vector<T> transient() const;
+
+    void swap(persistent_vector& rhs) noexcept {
+        using std::swap;
+        swap(cnt, rhs.cnt);
+        swap(shift, rhs.shift);
+        swap(root, rhs.root);
+        swap(tail, rhs.tail);
+        swap(editId, rhs.editId);
+    }
+
+    // 迭代器相关
+    constIterator begin()   const { return constIterator(this, 0); }
+    constIterator end()     const { return constIterator(this, cnt); }
+    constIterator cbegin()  const { return begin(); }
+    constIterator cend()    const { return end(); }
+
+private:
+    // helper function
+    sizeType        tail_offset() const {
+        return cnt < PVECTOR_BRANCH ? 0 : ((cnt - 1) >> PVECTOR_SHIFT) << PVECTOR_SHIFT;
+    }
+    sizeType        tail_size() const { return cnt - tail_offset(); }
+    leafNode*       leaf_for(sizeType) const;
+    const T*        array_for(sizeType n) const { return leaf_for(n)->data(); }
+    void            reset() noexcept;
+    void            release_all() noexcept;
+
+    static size_t   new_edit_id();
+    bool            editable(const pvectorNodeBase*) const;
+    static void     retain(pvectorNodeBase*) noexcept;
+    static void     release_leaf(leafNode*, sizeType) noexcept;
+    static void     release_branch(branchNode*, sizeType) noexcept;
+
+    leafNode*       new_leaf() const;
+    branchNode*     new_branch() const;
+    leafNode*       copy_leaf(const leafNode*, sizeType) const;
+    leafNode*       edit_leaf(leafNode*, sizeType) const;
+    branchNode*     edit_branch(branchNode*, sizeType) const;
+    branchNode*     new_path(sizeType, pvectorNodeBase*) const;
+    branchNode*     push_tail(sizeType, branchNode*, leafNode*);
+    branchNode*     pop_tail(sizeType, branchNode*);
+    branchNode*     do_set(sizeType, branchNode*, sizeType, const valueType&);
+};
+
+/**
+ * @brief persistent_vector 的批量修改模式(transient)
+ *        transient 自己创建的结点带有它的edit标记，可以不经引用计数检查直接原地修改
+ *        transient 不是线程安全的，修改完成后调用persistent()得到可以共享的快照
+ */
+template<typename T>
+class transient_vector {
+public:
+    typedef typename persistent_vector<T>::valueType        valueType;
+    typedef typename persistent_vector<T>::constReference   constReference;
+    typedef typename persistent_vector<T>::sizeType         sizeType;
+
+private:
+    persistent_vector<T>    vec;
+
+public:
+    explicit transient_vector(const persistent_vector<T>& v) : vec(v) {
+        vec.editId = persistent_vector<T>::new_edit_id();
+    }
+    // 拷贝出来的transient会和原来的共享带有相同edit标记的结点，所以禁止拷贝
+    transient_vector(const transient_vector&) = delete;
+    transient_vector& operator=(const transient_vector&) = delete;
+    transient_vector(transient_vector&&) = default;
+
+    bool            empty() const { return vec.empty(); }
+    sizeType        size()  const { return vec.size(); }
+    constReference  operator[](sizeType n) const { return vec[n]; }
+
+    void push_back(const valueType& value) { vec.push_back(value); }
+    void pop_back() { vec.pop_back(); }
+    void set(sizeType n, const valueType& value) { vec.set(n, value); }
+
+    // 结束批量修改，transient 之后变为空
+    persistent_vector<T> persistent() {
+        persistent_vector<T> result(std::move(vec));
+        result.editId = 0;
+        return result;
+    }
+};
+
+template<typename T>
+persistent_vector<T>::persistent_vector(sizeType n, const valueType& value)
+: persistent_vector() {
+    transient_vector<T> t(*this);
+    for(sizeType i = 0; i < n; ++i) t.push_back(value);
+    *this = t.persistent();
+}
+
+template<typename T>
+template<typename Iter, typename>
+persistent_vector<T>::persistent_vector(Iter first, Iter last)
+: persistent_vector() {
+    transient_vector<T> t(*this);
+    for(; first != last; ++first) t.push_back(*first);
+    *this = t.persistent();
+}
+
+// 拷贝构造，快照只共享root和tail
+template<typename T>
+persistent_vector<T>::persistent_vector(const persistent_vector& rhs) noexcept
+: cnt(rhs.cnt), shift(rhs.shift), root(rhs.root), tail(rhs.tail), editId(0) {
+    if(root) retain(root);
+    if(tail) retain(tail);
+}
+
+template<typename T>
+persistent_vector<T>&
+persistent_vector<T>::operator=(const persistent_vector& rhs) noexcept {
+    if(this != &rhs) {
+        // editId 不随赋值传递
+        if(rhs.root) retain(rhs.root);
+        if(rhs.tail) retain(rhs.tail);
+        release_all();
+        cnt = rhs.cnt;
+        shift = rhs.shift;
+        root = rhs.root;
+        tail = rhs.tail;
+    }
+    return *this;
+}
+
+template<typename T>
+persistent_vector<T>::persistent_vector(persistent_vector&& rhs) noexcept
+: cnt(rhs.cnt), shift(rhs.shift), root(rhs.root), tail(rhs.tail),
+  editId(rhs.editId) {
+    rhs.reset();
+}
+
+template<typename T>
+persistent_vector<T>&
+persistent_vector<T>::operator=(persistent_vector&& rhs) noexcept {
+    if(this != &rhs) {
+        release_all();
+        cnt = rhs.cnt;
+        shift = rhs.shift;
+        root = rhs.root;
+        tail = rhs.tail;
+        rhs.reset();
+    }
+    return *this;
+}
+
+// push_back
+template<typename T>
+void persistent_vector<T>::push_back(const valueType& value) {
+    const sizeType tailSize = tail_size();
+    if(tail != nullptr && tailSize < PVECTOR_BRANCH) {
+        tail = edit_leaf(tail, tailSize);
+        data_allocator::construct(tail->data() + tailSize, value);
+        ++cnt;
+        return;
+    }
+    // 先构造新的tail，保证构造元素抛出异常时树没有被修改
+    leafNode* newTail = new_leaf();
+    try {
+        data_allocator::construct(newTail->data(), value);
+    } catch(...) {
+        release_leaf(newTail, 0);
+        throw;
+    }
+    if(tail != nullptr) {
+        // tail 已满，把它放进树中，tail的引用转移给树
+        if(root == nullptr) {
+            root = new_path(shift, tail);
+        } else if((cnt >> PVECTOR_SHIFT) > (size_t(1) << shift)) {
+            // 根结点已满，树增高一层
+            branchNode* newRoot = new_branch();
+            newRoot->child[0] = root;
+            newRoot->child[1] = new_path(shift, tail);
+            root = newRoot;
+            shift += PVECTOR_SHIFT;
+        } else {
+            root = push_tail(shift, root, tail);
+        }
+    }
+    tail = newTail;
+    ++cnt;
+}
+
+// pop_back
+template<typename T>
+void persistent_vector<T>::pop_back() {
+    assert(!empty());
+    const sizeType tailSize = tail_size();
+    if(cnt == 1) {
+        clear();
+    } else if(tailSize > 1) {
+        if(editable(tail)) {
+            data_allocator::destory(tail->data() + tailSize - 1);
+        } else {
+            leafNode* newTail = copy_leaf(tail, tailSize - 1);
+            release_leaf(tail, tailSize);
+            tail = newTail;
+        }
+        --cnt;
+    } else {
+        // tail 只剩一个元素，把树中最后一个叶子取出来作为新的tail
+        leafNode* newTail = leaf_for(cnt - 2);
+        retain(newTail);
+        root = pop_tail(shift, root);
+        if(root != nullptr && shift > PVECTOR_SHIFT && root->child[1] == nullptr) {
+            // 根结点只剩一个孩子，树降低一层
+            branchNode* oldRoot = root;
+            root = static_cast<branchNode*>(oldRoot->child[0]);
+            retain(root);
+            release_branch(oldRoot, shift);
+            shift -= PVECTOR_SHIFT;
+        }
+        if(root == nullptr) shift = PVECTOR_SHIFT;
+        release_leaf(tail, 1);
+        tail = newTail;
+        --cnt;
+    }
+}
+
+// set，修改第n个元素，只拷贝根到叶子的路径
+template<typename T>
+void persistent_vector<T>::set(sizeType n, const valueType& value) {
+    assert(n < cnt);
+    const sizeType tailOff = tail_offset();
+    if(n >= tailOff) {
+        tail = edit_leaf(tail, cnt - tailOff);
+        tail->data()[n & PVECTOR_MASK] = value;
+    } else {
+        root = do_set(shift, root, n, value);
+    }
+}
+
+template<typename T>
+transient_vector<T> persistent_vector<T>::transient() const {
+    return transient_vector<T>(*this);
+}
+
+/***********************************************************************
+ *                                                                     |
+ * helper function                                                     |
+ *                                                                     |
+ **********************************************************************/
+template<typename T>
+typename persistent_vector<T>::leafNode*
+persistent_vector<T>::leaf_for(sizeType n) const {
+    assert(n < cnt);
+    if(n >= tail_offset()) {
+        return tail;
+    }
+    pvectorNodeBase* node = root;
+    for(sizeType level = shift; level > 0; level -= PVECTOR_SHIFT) {
+        node = static_cast<branchNode*>(node)->child[(n >> level) & PVECTOR_MASK];
+    }
+    return static_cast<leafNode*>(node);
+}
+
+template<typename T>
+void persistent_vector<T>::reset() noexcept {
+    cnt = 0;
+    shift = PVECTOR_SHIFT;
+    root = nullptr;
+    tail = nullptr;
+}
+
+template<typename T>
+void persistent_vector<T>::release_all() noexcept {
+    if(root) release_branch(root, shift);
+    if(tail) release_leaf(tail, tail_size());
+}
+
+template<typename T>
+size_t persistent_vector<T>::new_edit_id() {
+    static std::atomic<size_t> nextId(1);
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 引用计数为1说明只有当前vector能访问到该结点(路径上的祖先结点也必然是独占的)
+template<typename T>
+bool persistent_vector<T>::editable(const pvectorNodeBase* node) const {
+    return (editId != 0 && node->edit == editId) ||
+           node->refCount.load(std::memory_order_acquire) == 1;
+}
+
+template<typename T>
+void persistent_vector<T>::retain(pvectorNodeBase* node) noexcept {
+    node->refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 叶子只知道自己在哪里，不知道有多少元素，所以由调用者传入n
+template<typename T>
+void persistent_vector<T>::release_leaf(leafNode* leaf, sizeType n) noexcept {
+    if(leaf->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        data_allocator::destory(leaf->data(), leaf->data() + n);
+        leaf_allocator::destory(leaf);
+        leaf_allocator::deallocate(leaf);
+    }
+}
+
+// level 是结点所在的层，level == PVECTOR_SHIFT 时孩子是叶子
+template<typename T>
+void persistent_vector<T>::release_branch(branchNode* node, sizeType level) noexcept {
+    if(node->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    for(size_t i = 0; i < PVECTOR_BRANCH && node->child[i]; ++i) {
+        if(level == PVECTOR_SHIFT) {
+            release_leaf(static_cast<leafNode*>(node->child[i]), PVECTOR_BRANCH);
+        } else {
+            release_branch(static_cast<branchNode*>(node->child[i]),
+                           level - PVECTOR_SHIFT);
+        }
+    }
+    branch_allocator::destory(node);
+    branch_allocator::deallocate(node);
+}
+
+template<typename T>
+typename persistent_vector<T>::leafNode* persistent_vector<T>::new_leaf() const {
+    leafNode* leaf = leaf_allocator::allocate();
+    leaf_allocator::construct(leaf);
+    leaf->edit = editId;
+    return leaf;
+}
+
+template<typename T>
+typename persistent_vector<T>::branchNode* persistent_vector<T>::new_branch() const {
+    branchNode* node = branch_allocator::allocate();
+    branch_allocator::construct(node);
+    node->edit = editId;
+    return node;
+}
+
+template<typename T>
+typename persistent_vector<T>::leafNode*
+persistent_vector<T>::copy_leaf(const leafNode* leaf, sizeType n) const {
+    leafNode* newLeaf = new_leaf();
+    try {
+        std::uninitialized_copy(leaf->data(), leaf->data() + n, newLeaf->data());
+    } catch(...) {
+        release_leaf(newLeaf, 0);
+        throw;
+    }
+    return newLeaf;
+}
+
+// 返回一个可以原地修改的叶子，调用者用返回值替换原来的指针(原来的引用被转移或释放)
+template<typename T>
+typename persistent_vector<T>::leafNode*
+persistent_vector<T>::edit_leaf(leafNode* leaf, sizeType n) const {
+    if(editable(leaf)) return leaf;
+    leafNode* newLeaf = copy_leaf(leaf, n);
+    release_leaf(leaf, n);
+    return newLeaf;
+}
+
+template<typename T>
+typename persistent_vector<T>::branchNode*
+persistent_vector<T>::edit_branch(branchNode* node, sizeType level) const {
+    if(editable(node)) return node;
+    branchNode* newNode = new_branch();
+    for(size_t i = 0; i < PVECTOR_BRANCH && node->child[i]; ++i) {
+        newNode->child[i] = node->child[i];
+        retain(newNode->child[i]);
+    }
+    release_branch(node, level);
+    return newNode;
+}
+
+// 为叶子创建一条高度为level的新路径
+template<typename T>
+typename persistent_vector<T>::branchNode*
+persistent_vector<T>::new_path(sizeType level, pvectorNodeBase* node) const {
+    branchNode* ret = new_branch();
+    ret->child[0] = (level == PVECTOR_SHIFT) ? node : new_path(level - PVECTOR_SHIFT, node);
+    return ret;
+}
+
+template<typename T>
+typename persistent_vector<T>::branchNode*
+persistent_vector<T>::push_tail(sizeType level, branchNode* parent, leafNode* tailNode) {
+    parent = edit_branch(parent, level);
+    const sizeType subIdx = ((cnt - 1) >> level) & PVECTOR_MASK;
+    if(level == PVECTOR_SHIFT) {
+        parent->child[subIdx] = tailNode;
+    } else {
+        branchNode* child = static_cast<branchNode*>(parent->child[subIdx]);
+        parent->child[subIdx] = child
+            ? push_tail(level - PVECTOR_SHIFT, child, tailNode)
+            : new_path(level - PVECTOR_SHIFT, tailNode);
+    }
+    return parent;
+}
+
+// 删除树中最后一个叶子，结点变空时返回nullptr
+template<typename T>
+typename persistent_vector<T>::branchNode*
+persistent_vector<T>::pop_tail(sizeType level, branchNode* node) {
+    const sizeType subIdx = ((cnt - 2) >> level) & PVECTOR_MASK;
+    if(level == PVECTOR_SHIFT && subIdx == 0) {
+        release_branch(node, level);
+        return nullptr;
+    }
+    node = edit_branch(node, level);
+    if(level > PVECTOR_SHIFT) {
+        branchNode* newChild = pop_tail(level - PVECTOR_SHIFT,
+                                        static_cast<branchNode*>(node->child[subIdx]));
+        node->child[subIdx] = newChild;
+        if(newChild == nullptr && subIdx == 0) {
+            release_branch(node, level);
+            return nullptr;
+        }
+    } else {
+        release_leaf(static_cast<leafNode*>(node->child[subIdx]), PVECTOR_BRANCH);
+        node->child[subIdx] = nullptr;
+    }
+    return node;
+}
+
+template<typename T>
+typename persistent_vector<T>::branchNode*
+persistent_vector<T>::do_set(sizeType level, branchNode* node,
+                             sizeType n, const valueType& value) {
+    node = edit_branch(node, level);
+    const sizeType subIdx = (n >> level) & PVECTOR_MASK;
+    if(level == PVECTOR_SHIFT) {
+        leafNode* leaf = edit_leaf(static_cast<leafNode*>(node->child[subIdx]),
+                                   PVECTOR_BRANCH);
+        node->child[subIdx] = leaf;
+        leaf->data()[n & PVECTOR_MASK] = value;
+    } else {
+        node->child[subIdx] = do_set(level - PVECTOR_SHIFT,
+                                     static_cast<branchNode*>(node->child[subIdx]),
+                                     n, value);
+    }
+    return node;
+}
+
+template<typename T>
+bool operator==(const persistent_vector<T>& x, const persistent_vector<T>& y) {
+    return x.size() == y.size() && mystl::equal(x.begin(), x.end(), y.begin());
+}
+
+template<typename T>
+bool operator!=(const persistent_vector<T>& x, const persistent_vector<T>& y) {
+    return !(x == y);
+}
+
+template<typename T>
+void swap(persistent_vector<T>& x, persistent_vector<T>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+// priority_queue 基于d叉堆的优先队列，默认底层容器是vector
+// 一个结点的D个孩子在内存中是连续的，4叉/8叉堆的树高更低，
+// 每次下沉比较的孩子大多落在同一条cache line上，比二叉堆的cache miss更少
+
+#include "vector.h"
+
+#include <functional>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 4
+#endif
+
+/*************************************************************************************/
+// d叉堆算法，[first, last) 是一个以comp为序的大顶堆(和std::push_heap一样)              /
+// 结点i的孩子是 D*i+1 ... D*i+D，父结点是 (i-1)/D                                      /
+/*************************************************************************************/
+template<size_t D, typename RandomIter, typename Distance, typename T, typename Compare>
+void __dary_sift_up(RandomIter first, Distance hole, T value, Compare comp) {
+    while(hole > 0) {
+        const Distance parent = (hole - 1) / D;
+        if(!comp(*(first + parent), value)) break;
+        *(first + hole) = std::move(*(first + parent));
+        hole = parent;
+    }
+    *(first + hole) = std::move(value);
+}
+
+template<size_t D, typename RandomIter, typename Distance, typename T, typename Compare>
+void __dary_sift_down(RandomIter first, Distance hole, Distance len, T value, Compare comp) {
+    for(;;) {
+        const Distance child = D * hole + 1;
+        if(child >= len) break;
+        // 在D个孩子中找到最大的一个
+        Distance best = child;
+        const Distance last = (len - child > static_cast<Distance>(D)) ? child + D : len;
+        for(Distance c = child + 1; c < last; ++c) {
+            if(comp(*(first + best), *(first + c))) best = c;
+        }
+        if(!comp(value, *(first + best))) break;
+        *(first + hole) = std::move(*(first + best));
+        hole = best;
+    }
+    *(first + hole) = std::move(value);
+}
+
+// 新元素已经放在 last - 1
+template<size_t D, typename RandomIter, typename Compare>
+void dary_push_heap(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    typedef typename iterator_traits<RandomIter>::value_type      valueType;
+    const Distance len = last - first;
+    if(len < 2) return;
+    valueType value = std::move(*(last - 1));
+    __dary_sift_up<D>(first, len - 1, std::move(value), comp);
+}
+
+// 把堆顶移动到 last - 1，[first, last - 1) 重新成为堆
+template<size_t D, typename RandomIter, typename Compare>
+void dary_pop_heap(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    typedef typename iterator_traits<RandomIter>::value_type      valueType;
+    const Distance len = last - first;
+    if(len < 2) return;
+    valueType value = std::move(*(last - 1));
+    *(last - 1) = std::move(*first);
+    __dary_sift_down<D>(first, Distance(0), len - 1, std::move(value), comp);
+}
+
+// Floyd建堆，从最后一个非叶子结点开始下沉，O(n)
+template<size_t D, typename RandomIter, typename Compare>
+void dary_make_heap(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    typedef typename iterator_traits<RandomIter>::value_type      valueType;
+    const Distance len = last - first;
+    if(len < 2) return;
+    for(Distance i = (len - 2) / D; ; --i) {
+        valueType value = std::move(*(first + i));
+        __dary_sift_down<D>(first, i, len, std::move(value), comp);
+        if(i == 0) break;
+    }
+}
+
+template<size_t D, typename RandomIter, typename Compare>
+bool dary_is_heap(RandomIter first, RandomIter last, Compare comp) {
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    const Distance len = last - first;
+    for(Distance i = 1; i < len; ++i) {
+        if(comp(*(first + (i - 1) / D), *(first + i))) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 优先队列适配器
+ *
+ * @tparam T
+ * @tparam Sequence 随机访问容器，需要 push_back/emplace_back/pop_back
+ * @tparam Compare  和std一样，comp(a, b)为真时b的优先级更高，默认大顶堆
+ * @tparam D        堆的叉数，2/4/8
+ */
+template<typename T, typename Sequence = mystl::vector<T>,
+         typename Compare = std::less<T>, size_t D = HEAP_ARITY>
+class priority_queue {
+public:
+    typedef T                                   valueType;
+    typedef typename Sequence::reference        reference;
+    typedef typename Sequence::constReference   constReference;
+    typedef typename Sequence::sizeType         sizeType;
+    typedef          Sequence                   containerType;
+    typedef          Compare                    valueCompare;
+
+    static_assert(D >= 2, "heap arity must be at least 2");
+
+protected:
+    Sequence c;
+    Compare  comp;
+
+public:
+    priority_queue() = default;
+    explicit priority_queue(const Compare& x) : c(), comp(x) {}
+    priority_queue(const Compare& x, const Sequence& s) : c(s), comp(x) {
+        dary_make_heap<D>(c.begin(), c.end(), comp);
+    }
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    priority_queue(Iter first, Iter last, const Compare& x = Compare())
+    : c(), comp(x) {
+        push_range(first, last);
+    }
+
+    bool            empty() const { return c.empty(); }
+    sizeType        size()  const { return c.size(); }
+    constReference  top()   const { assert(!c.empty()); return c.front(); }
+
+    void push(const valueType& x) {
+        c.push_back(x);
+        dary_push_heap<D>(c.begin(), c.end(), comp);
+    }
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        c.emplace_back(std::forward<Args>(args)...);
+        dary_push_heap<D>(c.begin(), c.end(), comp);
+    }
+    void pop() {
+        assert(!c.empty());
+        dary_pop_heap<D>(c.begin(), c.end(), comp);
+        c.pop_back();
+    }
+
+    // 批量插入，插入的元素多于已有元素时整体重新建堆(O(n))，否则逐个上浮
+    template<typename Iter>
+    void push_range(Iter first, Iter last) {
+        const sizeType oldSize = c.size();
+        for(; first != last; ++first) c.push_back(*first);
+        const sizeType added = c.size() - oldSize;
+        if(added >= oldSize) {
+            dary_make_heap<D>(c.begin(), c.end(), comp);
+        } else {
+            for(sizeType i = oldSize + 1; i <= c.size(); ++i) {
+                dary_push_heap<D>(c.begin(), c.begin() + i, comp);
+            }
+        }
+    }
+
+    void swap(priority_queue& rhs) noexcept {
+        using std::swap;
+        c.swap(rhs.c);
+        swap(comp, rhs.comp);
+    }
+};
+
+template<typename T, typename Sequence, typename Compare, size_t D>
+void swap(priority_queue<T, Sequence, Compare, D>& x,
+          priority_queue<T, Sequence, Compare, D>& y) {
+    x.swap(y);
+}
+
+/**
+ * @brief 带句柄的d叉堆，push返回一个句柄，可以通过句柄修改元素的优先级(decrease_key)
+ *        元素按句柄存放，堆中只移动句柄，pos记录每个句柄在堆中的位置
+ *
+ * @tparam T
+ * @tparam Compare
+ * @tparam D
+ */
+template<typename T, typename Compare = std::less<T>, size_t D = HEAP_ARITY>
+class indexed_priority_queue {
+public:
+    typedef T                                   valueType;
+    typedef const T&                            constReference;
+    typedef size_t                              sizeType;
+    typedef size_t                              handleType;
+
+    static constexpr sizeType npos = static_cast<sizeType>(-1);
+    static_assert(D >= 2, "heap arity must be at least 2");
+
+private:
+    mystl::vector<T>            values;         // 句柄 -> 元素
+    mystl::vector<sizeType>     pos;            // 句柄 -> 在heap中的位置，npos表示句柄空闲
+    mystl::vector<handleType>   heap;           // d叉堆，存放句柄
+    mystl::vector<handleType>   freeHandles;    // 可以复用的句柄
+    Compare                     comp;
+
+public:
+    indexed_priority_queue() = default;
+    explicit indexed_priority_queue(const Compare& x) : comp(x) {}
+
+    bool            empty()      const { return heap.empty(); }
+    sizeType        size()       const { return heap.size(); }
+    constReference  top()        const { assert(!empty()); return values[heap[0]]; }
+    handleType      top_handle() const { assert(!empty()); return heap[0]; }
+    bool            contains(handleType h) const { return h < pos.size() && pos[h] != npos; }
+    constReference  get(handleType h) const { assert(contains(h)); return values[h]; }
+
+    handleType push(const valueType& x) {
+        handleType h;
+        if(!freeHandles.empty()) {
+            h = freeHandles.back();
+            values[h] = x;
+            freeHandles.pop_back();
+        } else {
+            h = values.size();
+            values.push_back(x);
+            pos.push_back(npos);
+        }
+        pos[h] = heap.size();
+        heap.push_back(h);
+        sift_up(heap.size() - 1);
+        return h;
+    }
+
+    void pop() {
+        assert(!empty());
+        erase(heap[0]);
+    }
+
+    // 删除任意句柄对应的元素
+    void erase(handleType h) {
+        assert(contains(h));
+        const sizeType i = pos[h];
+        const handleType last = heap.back();
+        heap.pop_back();
+        pos[h] = npos;
+        freeHandles.push_back(h);
+        if(i < heap.size()) {
+            place(i, last);
+            fix(i);
+        }
+    }
+
+    // 提高优先级，新值不能比原来的优先级低，只需要上浮
+    void decrease_key(handleType h, const valueType& x) {
+        assert(contains(h) && !comp(x, values[h]));
+        values[h] = x;
+        sift_up(pos[h]);
+    }
+
+    // 任意修改优先级
+    void update(handleType h, const valueType& x) {
+        assert(contains(h));
+        values[h] = x;
+        fix(pos[h]);
+    }
+
+private:
+    void place(sizeType i, handleType h) {
+        heap[i] = h;
+        pos[h] = i;
+    }
+
+    void fix(sizeType i) {
+        if(i > 0 && comp(values[heap[(i - 1) / D]], values[heap[i]])) sift_up(i);
+        else sift_down(i);
+    }
+
+    void sift_up(sizeType i) {
+        const handleType h = heap[i];
+        while(i > 0) {
+            const sizeType parent = (i - 1) / D;
+            if(!comp(values[heap[parent]], values[h])) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, h);
+    }
+
+    void sift_down(sizeType i) {
+        const handleType h = heap[i];
+        const sizeType len = heap.size();
+        for(;;) {
+            const sizeType child = D * i + 1;
+            if(child >= len) break;
+            sizeType best = child;
+            const sizeType last = (len - child > D) ? child + D : len;
+            for(sizeType c = child + 1; c < last; ++c) {
+                if(comp(values[heap[best]], values[heap[c]])) best = c;
+            }
+            if(!comp(values[h], values[heap[best]])) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, h);
+    }
+};
+
+template<typename T, typename Compare, size_t D>
+constexpr typename indexed_priority_queue<T, Compare, D>::sizeType
+indexed_priority_queue<T, Compare, D>::npos;
+
+}   // end of namespace mystl
+
+#endif
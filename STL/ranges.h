@@ -0,0 +1,782 @@
+#ifndef RANGES_H
+#define RANGES_H
+
+// 惰性的视图：filter/transform/take/drop/chunk/stride/zip/enumerate 不生成中间容器，
+// 遍历时才逐个计算，可以用 | 串起来：
+//     auto v = vec | views::filter(odd) | views::transform(square) | views::take(10);
+//     mystl::vector<int> out = v | mystl::to<mystl::vector>();
+// 视图尽量保持底层迭代器的分类，底层是随机访问时 take/drop/chunk/stride/zip/enumerate/transform
+// 也是随机访问的，mystl::distance/advance 仍然是O(1)，to<>() 可以先算出个数只reserve一次
+// transform 的函数返回值不是引用时分类只能是输入迭代器，但仍然支持 += 和相减，
+// iterator_concept 记录实际能做的移动，to<>() 按它判断能不能先算出个数
+// 左值容器按引用保存(ref_view)，右值容器移动进视图(owning_view)，视图本身按值保存
+// 和std一样，迭代器引用所在的视图，视图要比迭代器活得久
+
+#include "iterator.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <assert.h>
+
+namespace mystl {
+
+// 所有视图的基类，用来区分视图和容器
+struct view_base {};
+
+template<typename R>
+struct is_view : std::is_base_of<view_base, typename std::decay<R>::type> {};
+
+template<typename R>
+using range_iterator_t = decltype(std::declval<R&>().begin());
+
+template<typename R>
+using range_value_t = typename iterator_traits<range_iterator_t<R>>::value_type;
+
+template<typename R>
+using range_reference_t = typename iterator_traits<range_iterator_t<R>>::reference;
+
+template<typename R>
+using range_difference_t = typename iterator_traits<range_iterator_t<R>>::difference_type;
+
+template<typename R>
+using range_category_t = typename iterator_traits<range_iterator_t<R>>::iterator_category;
+
+template<typename Iter>
+struct is_random_access_iterator
+    : std::is_convertible<typename iterator_traits<Iter>::iterator_category,
+                          random_access_iterator_tag> {};
+
+// 两种分类中较弱的一种
+template<typename C1, typename C2>
+using common_category_t = typename std::conditional<std::is_convertible<C1, C2>::value, C2, C1>::type;
+
+// 迭代器实际支持的移动方式，视图迭代器有 iterator_concept，其他迭代器就是 iterator_category
+template<typename Iter>
+struct __iterator_concept {
+private:
+    template<typename U> static typename U::iterator_concept test(int);
+    template<typename U> static typename iterator_traits<U>::iterator_category test(...);
+public:
+    typedef decltype(test<Iter>(0)) type;
+};
+
+template<typename Iter>
+using iterator_concept_t = typename __iterator_concept<Iter>::type;
+
+// 最多前进n步，不越过last；随机访问迭代器是O(1)
+template<typename Iter, typename Distance>
+void __advance_bounded(Iter& it, Distance n, const Iter& last, random_access_iterator_tag) {
+    const Distance left = static_cast<Distance>(last - it);
+    it += n < left ? n : left;
+}
+
+template<typename Iter, typename Distance>
+void __advance_bounded(Iter& it, Distance n, const Iter& last, input_iterator_tag) {
+    for(; n > 0 && it != last; --n) ++it;
+}
+
+template<typename Iter, typename Distance>
+void advance_bounded(Iter& it, Distance n, const Iter& last) {
+    __advance_bounded(it, n, last, mystl::iterator_category(it));
+}
+
+/**
+ * @brief 视图迭代器的公共部分(CRTP)
+ *        Derived 提供 *、前置++、==，双向的再提供前置--，随机访问的再提供 +=、两个迭代器相减和 <
+ *        其他运算符在这里用它们实现，只有用到时才会实例化
+ */
+template<typename Derived, typename Category, typename Value, typename Reference,
+         typename Distance = ptrdiff_t, typename Concept = Category>
+struct view_iterator_base {
+    typedef Category    iterator_category;
+    typedef Concept     iterator_concept;
+    typedef Value       value_type;
+    typedef Distance    difference_type;
+    typedef void        pointer;
+    typedef Reference   reference;
+
+    Derived& self() { return static_cast<Derived&>(*this); }
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+    Derived operator++(int) { Derived temp = self(); ++self(); return temp; }
+    Derived operator--(int) { Derived temp = self(); --self(); return temp; }
+    Derived& operator-=(Distance n) { return self() += -n; }
+    Reference operator[](Distance n) const { return *(self() + n); }
+
+    friend bool operator!=(const Derived& x, const Derived& y) { return !(x == y); }
+    friend bool operator> (const Derived& x, const Derived& y) { return y < x; }
+    friend bool operator<=(const Derived& x, const Derived& y) { return !(y < x); }
+    friend bool operator>=(const Derived& x, const Derived& y) { return !(x < y); }
+    friend Derived operator+(Derived it, Distance n) { it += n; return it; }
+    friend Derived operator+(Distance n, Derived it) { it += n; return it; }
+    friend Derived operator-(Derived it, Distance n) { it += -n; return it; }
+};
+
+/*************************************************************************************/
+// subrange / ref_view / owning_view                                                  /
+/*************************************************************************************/
+// 一对迭代器，比如deque的一段 subrange(dq.begin() + 10, dq.end())
+template<typename Iter>
+class subrange : public view_base {
+private:
+    Iter first;
+    Iter last;
+
+public:
+    subrange() : first(), last() {}
+    subrange(Iter f, Iter l) : first(f), last(l) {}
+
+    Iter begin() const { return first; }
+    Iter end() const { return last; }
+    bool empty() const { return first == last; }
+    typename iterator_traits<Iter>::difference_type size() const { return mystl::distance(first, last); }
+};
+
+template<typename Iter>
+subrange<Iter> make_subrange(Iter first, Iter last) {
+    return subrange<Iter>(first, last);
+}
+
+// 引用一个左值容器
+template<typename C>
+class ref_view : public view_base {
+private:
+    C* c;
+
+public:
+    explicit ref_view(C& container) : c(&container) {}
+
+    range_iterator_t<C> begin() const { return c->begin(); }
+    range_iterator_t<C> end() const { return c->end(); }
+};
+
+// 接管一个右值容器，视图的begin()是const的，所以容器用mutable保存
+template<typename C>
+class owning_view : public view_base {
+private:
+    mutable C c;
+
+public:
+    explicit owning_view(C&& container) : c(std::move(container)) {}
+
+    range_iterator_t<C> begin() const { return c.begin(); }
+    range_iterator_t<C> end() const { return c.end(); }
+};
+
+namespace views {
+
+template<typename R>
+typename std::enable_if<is_view<R>::value, typename std::decay<R>::type>::type
+all(R&& r) {
+    return std::forward<R>(r);
+}
+
+template<typename C>
+typename std::enable_if<!is_view<C>::value, ref_view<C>>::type
+all(C& c) {
+    return ref_view<C>(c);
+}
+
+template<typename C>
+typename std::enable_if<!is_view<C>::value && !std::is_lvalue_reference<C>::value, owning_view<C>>::type
+all(C&& c) {
+    return owning_view<C>(std::move(c));
+}
+
+}   // end of namespace views
+
+template<typename R>
+using all_t = decltype(views::all(std::declval<R>()));
+
+// 视图适配器的基类，range | adaptor 等价于 adaptor(range)
+struct range_adaptor_base {};
+
+template<typename R, typename Adaptor,
+         typename = typename std::enable_if<
+             std::is_base_of<range_adaptor_base, typename std::decay<Adaptor>::type>::value>::type>
+auto operator|(R&& r, const Adaptor& adaptor) -> decltype(adaptor(std::forward<R>(r))) {
+    return adaptor(std::forward<R>(r));
+}
+
+/*************************************************************************************/
+// transform                                                                          /
+/*************************************************************************************/
+template<typename V, typename F>
+class transform_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V base;
+    F fun;
+
+public:
+    typedef decltype(std::declval<const F&>()(*std::declval<baseIter>())) reference;
+
+private:
+    // 前向迭代器的 * 必须返回引用，函数返回值时只能是输入迭代器
+    typedef typename std::conditional<std::is_lvalue_reference<reference>::value,
+                                      range_category_t<const V>, input_iterator_tag>::type category;
+
+public:
+    class iterator : public view_iterator_base<iterator, category, typename std::decay<reference>::type,
+                                               reference, differenceType, range_category_t<const V>> {
+    private:
+        baseIter    it;
+        const F*    fun;
+
+    public:
+        iterator() : it(), fun(nullptr) {}
+        iterator(baseIter i, const F* f) : it(i), fun(f) {}
+
+        reference operator*() const { return (*fun)(*it); }
+        iterator& operator++() { ++it; return *this; }
+        iterator& operator--() { --it; return *this; }
+        iterator& operator+=(differenceType n) { it += n; return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.it == y.it; }
+        friend bool operator<(const iterator& x, const iterator& y) { return x.it < y.it; }
+        friend differenceType operator-(const iterator& x, const iterator& y) { return x.it - y.it; }
+    };
+
+    transform_view(V v, F f) : base(std::move(v)), fun(std::move(f)) {}
+
+    iterator begin() const { return iterator(base.begin(), &fun); }
+    iterator end() const { return iterator(base.end(), &fun); }
+};
+
+/*************************************************************************************/
+// filter                                                                             /
+/*************************************************************************************/
+// 最多是前向迭代器，begin() 每次都要找第一个满足条件的元素
+template<typename V, typename Pred>
+class filter_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V       base;
+    Pred    pred;
+
+public:
+    class iterator : public view_iterator_base<iterator,
+                                               common_category_t<range_category_t<const V>,
+                                                                 forward_iterator_tag>,
+                                               range_value_t<const V>,
+                                               range_reference_t<const V>, differenceType> {
+    private:
+        baseIter    it;
+        baseIter    last;
+        const Pred* pred;
+
+        void satisfy() {
+            while(it != last && !(*pred)(*it)) ++it;
+        }
+
+    public:
+        iterator() : it(), last(), pred(nullptr) {}
+        iterator(baseIter i, baseIter l, const Pred* p) : it(i), last(l), pred(p) { satisfy(); }
+
+        range_reference_t<const V> operator*() const { return *it; }
+        iterator& operator++() { ++it; satisfy(); return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.it == y.it; }
+    };
+
+    filter_view(V v, Pred p) : base(std::move(v)), pred(std::move(p)) {}
+
+    iterator begin() const { return iterator(base.begin(), base.end(), &pred); }
+    iterator end() const { return iterator(base.end(), base.end(), &pred); }
+};
+
+/*************************************************************************************/
+// take                                                                               /
+/*************************************************************************************/
+// 底层是随机访问时直接截出一段subrange，迭代器就是底层的迭代器
+template<typename V, bool = is_random_access_iterator<range_iterator_t<const V>>::value>
+class take_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  count;
+
+public:
+    typedef baseIter iterator;
+
+    take_view(V v, differenceType n) : base(std::move(v)), count(n) {}
+
+    iterator begin() const { return base.begin(); }
+    iterator end() const {
+        iterator it = base.begin();
+        advance_bounded(it, count, base.end());
+        return it;
+    }
+};
+
+// 其他情况记下还能走几步，走完或者到了底层的end都算结束
+template<typename V>
+class take_view<V, false> : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  count;
+
+public:
+    class iterator : public view_iterator_base<iterator,
+                                               common_category_t<range_category_t<const V>,
+                                                                 forward_iterator_tag>,
+                                               range_value_t<const V>,
+                                               range_reference_t<const V>, differenceType> {
+    private:
+        baseIter        it;
+        differenceType  left;
+
+    public:
+        iterator() : it(), left(0) {}
+        iterator(baseIter i, differenceType n) : it(i), left(n) {}
+
+        range_reference_t<const V> operator*() const { return *it; }
+        iterator& operator++() { ++it; --left; return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) {
+            return x.left == y.left || x.it == y.it;
+        }
+    };
+
+    take_view(V v, differenceType n) : base(std::move(v)), count(n) {}
+
+    iterator begin() const { return iterator(base.begin(), count); }
+    iterator end() const { return iterator(base.end(), 0); }
+};
+
+/*************************************************************************************/
+// drop                                                                               /
+/*************************************************************************************/
+template<typename V>
+class drop_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  count;
+
+public:
+    typedef baseIter iterator;
+
+    drop_view(V v, differenceType n) : base(std::move(v)), count(n) {}
+
+    iterator begin() const {
+        iterator it = base.begin();
+        advance_bounded(it, count, base.end());
+        return it;
+    }
+    iterator end() const { return base.end(); }
+};
+
+/*************************************************************************************/
+// stride                                                                             /
+/*************************************************************************************/
+// 随机访问：记下起点和第几个，第pos个元素就是 first[pos * step]
+template<typename V, bool = is_random_access_iterator<range_iterator_t<const V>>::value>
+class stride_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  step;
+
+public:
+    class iterator : public view_iterator_base<iterator, range_category_t<const V>,
+                                               range_value_t<const V>,
+                                               range_reference_t<const V>, differenceType> {
+    private:
+        baseIter        first;
+        differenceType  step;
+        differenceType  pos;
+
+    public:
+        iterator() : first(), step(1), pos(0) {}
+        iterator(baseIter f, differenceType s, differenceType p) : first(f), step(s), pos(p) {}
+
+        range_reference_t<const V> operator*() const { return first[pos * step]; }
+        iterator& operator++() { ++pos; return *this; }
+        iterator& operator--() { --pos; return *this; }
+        iterator& operator+=(differenceType n) { pos += n; return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.pos == y.pos; }
+        friend bool operator<(const iterator& x, const iterator& y) { return x.pos < y.pos; }
+        friend differenceType operator-(const iterator& x, const iterator& y) { return x.pos - y.pos; }
+    };
+
+    stride_view(V v, differenceType s) : base(std::move(v)), step(s) { assert(s > 0); }
+
+    iterator begin() const { return iterator(base.begin(), step, 0); }
+    iterator end() const {
+        const differenceType n = base.end() - base.begin();
+        return iterator(base.begin(), step, (n + step - 1) / step);
+    }
+};
+
+template<typename V>
+class stride_view<V, false> : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  step;
+
+public:
+    class iterator : public view_iterator_base<iterator,
+                                               common_category_t<range_category_t<const V>,
+                                                                 forward_iterator_tag>,
+                                               range_value_t<const V>,
+                                               range_reference_t<const V>, differenceType> {
+    private:
+        baseIter        it;
+        baseIter        last;
+        differenceType  step;
+
+    public:
+        iterator() : it(), last(), step(1) {}
+        iterator(baseIter i, baseIter l, differenceType s) : it(i), last(l), step(s) {}
+
+        range_reference_t<const V> operator*() const { return *it; }
+        iterator& operator++() { advance_bounded(it, step, last); return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.it == y.it; }
+    };
+
+    stride_view(V v, differenceType s) : base(std::move(v)), step(s) { assert(s > 0); }
+
+    iterator begin() const { return iterator(base.begin(), base.end(), step); }
+    iterator end() const { return iterator(base.end(), base.end(), step); }
+};
+
+/*************************************************************************************/
+// chunk                                                                              /
+/*************************************************************************************/
+// 每个元素是一段最多n个元素的subrange，最后一段可能不满
+template<typename V, bool = is_random_access_iterator<range_iterator_t<const V>>::value>
+class chunk_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  n;
+
+public:
+    typedef subrange<baseIter> reference;
+
+    class iterator : public view_iterator_base<iterator, range_category_t<const V>,
+                                               reference, reference, differenceType> {
+    private:
+        baseIter        first;
+        differenceType  n;
+        differenceType  pos;
+        differenceType  total;
+
+    public:
+        iterator() : first(), n(1), pos(0), total(0) {}
+        iterator(baseIter f, differenceType c, differenceType p, differenceType t)
+            : first(f), n(c), pos(p), total(t) {}
+
+        reference operator*() const {
+            const differenceType lo = pos * n;
+            const differenceType hi = lo + n < total ? lo + n : total;
+            return reference(first + lo, first + hi);
+        }
+        iterator& operator++() { ++pos; return *this; }
+        iterator& operator--() { --pos; return *this; }
+        iterator& operator+=(differenceType k) { pos += k; return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.pos == y.pos; }
+        friend bool operator<(const iterator& x, const iterator& y) { return x.pos < y.pos; }
+        friend differenceType operator-(const iterator& x, const iterator& y) { return x.pos - y.pos; }
+    };
+
+    chunk_view(V v, differenceType c) : base(std::move(v)), n(c) { assert(c > 0); }
+
+    iterator begin() const { return iterator(base.begin(), n, 0, base.end() - base.begin()); }
+    iterator end() const {
+        const differenceType total = base.end() - base.begin();
+        return iterator(base.begin(), n, (total + n - 1) / n, total);
+    }
+};
+
+template<typename V>
+class chunk_view<V, false> : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V               base;
+    differenceType  n;
+
+public:
+    typedef subrange<baseIter> reference;
+
+    class iterator : public view_iterator_base<iterator,
+                                               common_category_t<range_category_t<const V>,
+                                                                 forward_iterator_tag>,
+                                               reference, reference, differenceType> {
+    private:
+        baseIter        it;
+        baseIter        last;
+        differenceType  n;
+
+    public:
+        iterator() : it(), last(), n(1) {}
+        iterator(baseIter i, baseIter l, differenceType c) : it(i), last(l), n(c) {}
+
+        reference operator*() const {
+            baseIter next = it;
+            advance_bounded(next, n, last);
+            return reference(it, next);
+        }
+        iterator& operator++() { advance_bounded(it, n, last); return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.it == y.it; }
+    };
+
+    chunk_view(V v, differenceType c) : base(std::move(v)), n(c) { assert(c > 0); }
+
+    iterator begin() const { return iterator(base.begin(), base.end(), n); }
+    iterator end() const { return iterator(base.end(), base.end(), n); }
+};
+
+/*************************************************************************************/
+// enumerate                                                                          /
+/*************************************************************************************/
+// 元素是 (下标, 元素的引用)
+template<typename V>
+class enumerate_view : public view_base {
+private:
+    typedef range_iterator_t<const V>                       baseIter;
+    typedef typename iterator_traits<baseIter>::difference_type differenceType;
+
+    V base;
+
+public:
+    typedef std::pair<differenceType, range_reference_t<const V>> reference;
+    typedef std::pair<differenceType, range_value_t<const V>>     value;
+
+    class iterator : public view_iterator_base<iterator, range_category_t<const V>,
+                                               value, reference, differenceType> {
+    private:
+        baseIter        it;
+        differenceType  index;
+
+    public:
+        iterator() : it(), index(0) {}
+        iterator(baseIter i, differenceType idx) : it(i), index(idx) {}
+
+        reference operator*() const { return reference(index, *it); }
+        iterator& operator++() { ++it; ++index; return *this; }
+        iterator& operator--() { --it; --index; return *this; }
+        iterator& operator+=(differenceType n) { it += n; index += n; return *this; }
+
+        friend bool operator==(const iterator& x, const iterator& y) { return x.it == y.it; }
+        friend bool operator<(const iterator& x, const iterator& y) { return x.index < y.index; }
+        friend differenceType operator-(const iterator& x, const iterator& y) { return x.index - y.index; }
+    };
+
+    explicit enumerate_view(V v) : base(std::move(v)) {}
+
+    iterator begin() const { return iterator(base.begin(), 0); }
+    // end的下标只有随机访问时才能直接算出来，其他情况比较时只看底层迭代器
+    iterator end() const { return end(is_random_access_iterator<baseIter>()); }
+
+private:
+    iterator end(std::true_type) const { return iterator(base.end(), base.end() - base.begin()); }
+    iterator end(std::false_type) const { return iterator(base.end(), 0); }
+};
+
+/*************************************************************************************/
+// zip                                                                                /
+/*************************************************************************************/
+// 元素是两个范围中对应元素的引用组成的pair，长度取较短的一个
+// 不是随机访问时算不出较短的长度，end() 是两边各自的末尾，从end()往回走不对齐，所以最多是前向的
+template<typename V1, typename V2>
+class zip_view : public view_base {
+private:
+    typedef range_iterator_t<const V1>                      baseIter1;
+    typedef range_iterator_t<const V2>                      baseIter2;
+    typedef typename iterator_traits<baseIter1>::difference_type differenceType;
+    typedef common_category_t<range_category_t<const V1>, range_category_t<const V2>> baseCategory;
+    typedef typename std::conditional<std::is_convertible<baseCategory, random_access_iterator_tag>::value,
+                                      baseCategory,
+                                      common_category_t<baseCategory, forward_iterator_tag>>::type category;
+
+    V1 base1;
+    V2 base2;
+
+public:
+    typedef std::pair<range_reference_t<const V1>, range_reference_t<const V2>> reference;
+    typedef std::pair<range_value_t<const V1>, range_value_t<const V2>>         value;
+
+    class iterator : public view_iterator_base<iterator, category, value, reference, differenceType> {
+    private:
+        baseIter1 it1;
+        baseIter2 it2;
+
+    public:
+        iterator() : it1(), it2() {}
+        iterator(baseIter1 i1, baseIter2 i2) : it1(i1), it2(i2) {}
+
+        reference operator*() const { return reference(*it1, *it2); }
+        iterator& operator++() { ++it1; ++it2; return *this; }
+        iterator& operator--() { --it1; --it2; return *this; }
+        iterator& operator+=(differenceType n) { it1 += n; it2 += n; return *this; }
+
+        // 任意一个到头就结束
+        friend bool operator==(const iterator& x, const iterator& y) {
+            return x.it1 == y.it1 || x.it2 == y.it2;
+        }
+        friend bool operator<(const iterator& x, const iterator& y) { return x.it1 < y.it1; }
+        friend differenceType operator-(const iterator& x, const iterator& y) { return x.it1 - y.it1; }
+    };
+
+    zip_view(V1 v1, V2 v2) : base1(std::move(v1)), base2(std::move(v2)) {}
+
+    iterator begin() const { return iterator(base1.begin(), base2.begin()); }
+    // 随机访问时两边都停在较短的长度上，end() - begin() 才是正确的长度
+    iterator end() const { return end(std::is_convertible<category, random_access_iterator_tag>()); }
+
+private:
+    iterator end(std::true_type) const {
+        const differenceType n1 = base1.end() - base1.begin();
+        const differenceType n2 = base2.end() - base2.begin();
+        const differenceType n = n1 < n2 ? n1 : n2;
+        return iterator(base1.begin() + n, base2.begin() + n);
+    }
+    iterator end(std::false_type) const { return iterator(base1.end(), base2.end()); }
+};
+
+/*************************************************************************************/
+// 适配器                                                                             /
+/*************************************************************************************/
+namespace views {
+
+template<typename F>
+struct transform_adaptor : public range_adaptor_base {
+    F fun;
+    explicit transform_adaptor(F f) : fun(std::move(f)) {}
+    template<typename R>
+    transform_view<all_t<R>, F> operator()(R&& r) const {
+        return transform_view<all_t<R>, F>(views::all(std::forward<R>(r)), fun);
+    }
+};
+
+template<typename F>
+transform_adaptor<F> transform(F f) { return transform_adaptor<F>(std::move(f)); }
+
+template<typename Pred>
+struct filter_adaptor : public range_adaptor_base {
+    Pred pred;
+    explicit filter_adaptor(Pred p) : pred(std::move(p)) {}
+    template<typename R>
+    filter_view<all_t<R>, Pred> operator()(R&& r) const {
+        return filter_view<all_t<R>, Pred>(views::all(std::forward<R>(r)), pred);
+    }
+};
+
+template<typename Pred>
+filter_adaptor<Pred> filter(Pred p) { return filter_adaptor<Pred>(std::move(p)); }
+
+// take/drop/stride/chunk 都只带一个数
+template<template<typename> class View>
+struct count_adaptor : public range_adaptor_base {
+    ptrdiff_t n;
+    explicit count_adaptor(ptrdiff_t c) : n(c) {}
+    template<typename R>
+    View<all_t<R>> operator()(R&& r) const {
+        return View<all_t<R>>(views::all(std::forward<R>(r)), n);
+    }
+};
+
+template<typename V> using __take_view   = take_view<V>;
+template<typename V> using __stride_view = stride_view<V>;
+template<typename V> using __chunk_view  = chunk_view<V>;
+template<typename V> using __drop_view   = drop_view<V>;
+
+inline count_adaptor<__take_view>   take(ptrdiff_t n)   { return count_adaptor<__take_view>(n); }
+inline count_adaptor<__drop_view>   drop(ptrdiff_t n)   { return count_adaptor<__drop_view>(n); }
+inline count_adaptor<__stride_view> stride(ptrdiff_t n) { return count_adaptor<__stride_view>(n); }
+inline count_adaptor<__chunk_view>  chunk(ptrdiff_t n)  { return count_adaptor<__chunk_view>(n); }
+
+struct enumerate_adaptor : public range_adaptor_base {
+    constexpr enumerate_adaptor() {}
+    template<typename R>
+    enumerate_view<all_t<R>> operator()(R&& r) const {
+        return enumerate_view<all_t<R>>(views::all(std::forward<R>(r)));
+    }
+};
+
+// vec | views::enumerate 或者 views::enumerate(vec)
+constexpr enumerate_adaptor enumerate;
+
+template<typename R1, typename R2>
+zip_view<all_t<R1>, all_t<R2>> zip(R1&& r1, R2&& r2) {
+    return zip_view<all_t<R1>, all_t<R2>>(views::all(std::forward<R1>(r1)),
+                                          views::all(std::forward<R2>(r2)));
+}
+
+}   // end of namespace views
+
+/*************************************************************************************/
+// to<Container>()                                                                    /
+/*************************************************************************************/
+template<typename C>
+struct __has_reserve {
+private:
+    template<typename U> static char test(decltype(std::declval<U&>().reserve(0))*);
+    template<typename U> static long test(...);
+public:
+    static constexpr bool value = sizeof(test<C>(nullptr)) == sizeof(char);
+};
+
+template<typename C, typename Iter>
+void __reserve_for(C& c, Iter first, Iter last, std::true_type) {
+    if(std::is_convertible<iterator_concept_t<Iter>, random_access_iterator_tag>::value)
+        c.reserve(static_cast<size_t>(last - first));
+}
+
+template<typename C, typename Iter>
+void __reserve_for(C&, Iter, Iter, std::false_type) {}
+
+// 把范围里的元素放进新的容器，个数能O(1)算出来时只reserve一次
+// Container 的其他模板参数(如分配器)取默认值
+template<template<typename...> class Container, typename R>
+Container<typename std::decay<range_value_t<R>>::type> to(R&& r) {
+    typedef Container<typename std::decay<range_value_t<R>>::type> result;
+    result c;
+    auto first = r.begin();
+    auto last = r.end();
+    __reserve_for(c, first, last, std::integral_constant<bool, __has_reserve<result>::value>());
+    for(; first != last; ++first) c.push_back(*first);
+    return c;
+}
+
+template<template<typename...> class Container>
+struct to_adaptor {};
+
+template<template<typename...> class Container>
+to_adaptor<Container> to() { return to_adaptor<Container>(); }
+
+template<typename R, template<typename...> class Container>
+Container<typename std::decay<range_value_t<R>>::type> operator|(R&& r, to_adaptor<Container>) {
+    return mystl::to<Container>(std::forward<R>(r));
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,450 @@
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+// vector/deque 的二进制序列化，只支持平凡可拷贝的类型
+// 文件格式：32字节的文件头(magic、版本、字节序、元素大小、元素个数、校验和) + 元素的原始字节
+// 写的时候用一次writev把文件头和所有缓冲区收集起来写出，读的时候先把缓冲区一次申请好再直接read进去，
+// 不逐个元素处理，速度只受IO带宽限制
+// 数据大于内存时用 serial_writer / serial_reader 分块流式读写
+
+#include "vector.h"
+#include "deque.h"
+
+#include <stdexcept>
+#include <system_error>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace mystl {
+
+#ifndef SERIAL_STREAM_BUFFER
+#define SERIAL_STREAM_BUFFER 65536      // serial_writer 合并小块写的缓冲区大小
+#endif
+
+#ifndef SERIAL_MAX_IOV
+#define SERIAL_MAX_IOV 1024             // 一次writev/readv最多的iovec个数，不超过IOV_MAX
+#endif
+
+#define SERIAL_VERSION      1
+#define SERIAL_BYTE_ORDER   0x0102      // 按本机字节序写入，读出来不一致说明字节序不同
+
+struct serialHeader {
+    char        magic[8];
+    uint16_t    version;
+    uint16_t    byteOrder;
+    uint32_t    elemSize;
+    uint64_t    count;
+    uint64_t    checksum;
+};
+
+static_assert(sizeof(serialHeader) == 32, "serial header must be 32 bytes");
+
+/**
+ * @brief 64位校验和，4路并行按8字节累加(轮函数同xxHash64)，可以分段喂数据
+ *        分段的方式不影响结果，deque按缓冲区喂和vector一次喂得到的值相同
+ */
+class serialChecksum {
+public:
+    serialChecksum() : length(0), tailSize(0) {
+        acc[0] = seed + prime1 + prime2;
+        acc[1] = seed + prime2;
+        acc[2] = seed;
+        acc[3] = seed - prime1;
+    }
+
+    void update(const void* data, size_t n) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        length += n;
+        if(tailSize) {
+            // 先把上次剩下的凑够32字节
+            const size_t fill = n < 32 - tailSize ? n : 32 - tailSize;
+            memcpy(tail + tailSize, p, fill);
+            tailSize += fill;
+            p += fill;
+            n -= fill;
+            if(tailSize < 32) return;
+            consume(tail);
+            tailSize = 0;
+        }
+        for(; n >= 32; p += 32, n -= 32) consume(p);
+        if(n) {
+            memcpy(tail, p, n);
+            tailSize = n;
+        }
+    }
+
+    uint64_t digest() const {
+        uint64_t h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+        for(int i = 0; i < 4; ++i) {
+            h ^= round(0, acc[i]);
+            h = h * prime1 + prime4;
+        }
+        h += length;
+        size_t i = 0;
+        for(; i + 8 <= tailSize; i += 8) {
+            h ^= round(0, load(tail + i));
+            h = rotl(h, 27) * prime1 + prime4;
+        }
+        for(; i < tailSize; ++i) {
+            h ^= tail[i] * prime5;
+            h = rotl(h, 11) * prime1;
+        }
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static const uint64_t seed   = 0;
+    static const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static const uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t load(const unsigned char* p) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    static uint64_t round(uint64_t a, uint64_t input) {
+        a += input * prime2;
+        return rotl(a, 31) * prime1;
+    }
+    void consume(const unsigned char* p) {
+        acc[0] = round(acc[0], load(p));
+        acc[1] = round(acc[1], load(p + 8));
+        acc[2] = round(acc[2], load(p + 16));
+        acc[3] = round(acc[3], load(p + 24));
+    }
+
+    uint64_t        acc[4];
+    uint64_t        length;
+    unsigned char   tail[32];
+    size_t          tailSize;
+};
+
+/***********************************************************************
+ *                                                                     |
+ * helper function                                                     |
+ *                                                                     |
+ **********************************************************************/
+inline void serial_throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// 写完iov中的所有数据，处理被信号打断和只写了一部分的情况，iov会被修改
+inline void serial_writev_all(int fd, struct iovec* iov, int iovcnt) {
+    while(iovcnt > 0) {
+        const int batch = iovcnt < SERIAL_MAX_IOV ? iovcnt : SERIAL_MAX_IOV;
+        ssize_t n = ::writev(fd, iov, batch);
+        if(n < 0) {
+            if(errno == EINTR) continue;
+            serial_throw_errno("serialize: writev");
+        }
+        // 跳过已经写完的iovec
+        while(iovcnt > 0 && static_cast<size_t>(n) >= iov->iov_len) {
+            n -= static_cast<ssize_t>(iov->iov_len);
+            ++iov;
+            --iovcnt;
+        }
+        if(iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= static_cast<size_t>(n);
+        }
+    }
+}
+
+// 把iov读满，读到文件末尾还没满时抛出异常
+inline void serial_readv_all(int fd, struct iovec* iov, int iovcnt) {
+    while(iovcnt > 0) {
+        const int batch = iovcnt < SERIAL_MAX_IOV ? iovcnt : SERIAL_MAX_IOV;
+        ssize_t n = ::readv(fd, iov, batch);
+        if(n < 0) {
+            if(errno == EINTR) continue;
+            serial_throw_errno("deserialize: readv");
+        }
+        if(n == 0) throw std::runtime_error("deserialize: unexpected end of file");
+        while(iovcnt > 0 && static_cast<size_t>(n) >= iov->iov_len) {
+            n -= static_cast<ssize_t>(iov->iov_len);
+            ++iov;
+            --iovcnt;
+        }
+        if(iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= static_cast<size_t>(n);
+        }
+    }
+}
+
+inline void serial_write_all(int fd, const void* data, size_t n) {
+    struct iovec iov;
+    iov.iov_base = const_cast<void*>(data);
+    iov.iov_len = n;
+    serial_writev_all(fd, &iov, 1);
+}
+
+inline void serial_read_all(int fd, void* data, size_t n) {
+    if(n == 0) return;
+    struct iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = n;
+    serial_readv_all(fd, &iov, 1);
+}
+
+template<typename T>
+serialHeader serial_make_header(uint64_t count, uint64_t checksum) {
+    serialHeader h;
+    memcpy(h.magic, "MYSTLSR1", sizeof(h.magic));
+    h.version = SERIAL_VERSION;
+    h.byteOrder = SERIAL_BYTE_ORDER;
+    h.elemSize = sizeof(T);
+    h.count = count;
+    h.checksum = checksum;
+    return h;
+}
+
+template<typename T>
+serialHeader serial_read_header(int fd) {
+    serialHeader h;
+    serial_read_all(fd, &h, sizeof(h));
+    if(memcmp(h.magic, "MYSTLSR1", sizeof(h.magic)) != 0)
+        throw std::runtime_error("deserialize: bad magic");
+    if(h.version != SERIAL_VERSION)
+        throw std::runtime_error("deserialize: unsupported version");
+    if(h.byteOrder != SERIAL_BYTE_ORDER)
+        throw std::runtime_error("deserialize: byte order mismatch");
+    if(h.elemSize != sizeof(T))
+        throw std::runtime_error("deserialize: element size mismatch");
+    return h;
+}
+
+// 读入之前把容器加长到n个元素，新元素马上会被文件内容覆盖
+// resize_for_overwrite 要求平凡的默认构造，平凡可拷贝但默认构造不平凡的类型先值初始化
+template<typename T>
+struct serial_overwritable
+    : std::integral_constant<bool, std::is_trivially_default_constructible<T>::value &&
+                                   std::is_trivially_destructible<T>::value> {};
+
+template<typename Container>
+void serial_grow(Container& c, size_t n, std::true_type) { c.resize_for_overwrite(n); }
+
+template<typename T>
+void serial_grow(vector<T>& v, size_t n, std::false_type) {
+    static_assert(std::is_default_constructible<T>::value, "deserialize requires a default constructible T");
+    v.insert(v.cend(), n - v.size(), T());
+}
+
+template<typename T>
+void serial_grow(deque<T>& d, size_t n, std::false_type) {
+    static_assert(std::is_default_constructible<T>::value, "deserialize requires a default constructible T");
+    d.resize(n);
+}
+
+/***********************************************************************
+ *                                                                     |
+ * 整体序列化                                                           |
+ *                                                                     |
+ **********************************************************************/
+template<typename T>
+void serialize(int fd, const vector<T>& v) {
+    static_assert(std::is_trivially_copyable<T>::value, "serialize requires a trivially copyable T");
+    const size_t bytes = v.size() * sizeof(T);
+    serialChecksum sum;
+    sum.update(v.data(), bytes);
+    serialHeader h = serial_make_header<T>(v.size(), sum.digest());
+
+    struct iovec iov[2];
+    iov[0].iov_base = &h;
+    iov[0].iov_len = sizeof(h);
+    iov[1].iov_base = const_cast<T*>(v.data());
+    iov[1].iov_len = bytes;
+    serial_writev_all(fd, iov, bytes ? 2 : 1);
+}
+
+// 文件头和每个缓冲区各一个iovec，一次writev写出
+template<typename T>
+void serialize(int fd, const deque<T>& d) {
+    static_assert(std::is_trivially_copyable<T>::value, "serialize requires a trivially copyable T");
+    vector<struct iovec> iov;
+    iov.reserve(d.size() / deque<T>::buffer_size() + 3);
+    iov.push_back(iovec());
+    serialChecksum sum;
+    d.for_each_segment([&](const T* p, size_t n) {
+        struct iovec seg;
+        seg.iov_base = const_cast<T*>(p);
+        seg.iov_len = n * sizeof(T);
+        sum.update(p, seg.iov_len);
+        iov.push_back(seg);
+    });
+    serialHeader h = serial_make_header<T>(d.size(), sum.digest());
+    iov[0].iov_base = &h;
+    iov[0].iov_len = sizeof(h);
+    serial_writev_all(fd, iov.data(), static_cast<int>(iov.size()));
+}
+
+// 读出的元素替换v原来的内容，出错时抛出异常，v的内容不确定(但可以安全析构)
+template<typename T>
+void deserialize(int fd, vector<T>& v) {
+    static_assert(std::is_trivially_copyable<T>::value, "deserialize requires a trivially copyable T");
+    const serialHeader h = serial_read_header<T>(fd);
+    v.clear();
+    serial_grow(v, static_cast<size_t>(h.count), serial_overwritable<T>());
+    serial_read_all(fd, v.data(), v.size() * sizeof(T));
+    serialChecksum sum;
+    sum.update(v.data(), v.size() * sizeof(T));
+    if(sum.digest() != h.checksum) throw std::runtime_error("deserialize: checksum mismatch");
+}
+
+// 先一次申请好所有的缓冲区，再用readv直接读进每个缓冲区
+template<typename T>
+void deserialize(int fd, deque<T>& d) {
+    static_assert(std::is_trivially_copyable<T>::value, "deserialize requires a trivially copyable T");
+    const serialHeader h = serial_read_header<T>(fd);
+    d.clear();
+    serial_grow(d, static_cast<size_t>(h.count), serial_overwritable<T>());
+    vector<struct iovec> iov;
+    iov.reserve(d.size() / deque<T>::buffer_size() + 2);
+    d.for_each_segment([&](T* p, size_t n) {
+        struct iovec seg;
+        seg.iov_base = p;
+        seg.iov_len = n * sizeof(T);
+        iov.push_back(seg);
+    });
+    serial_readv_all(fd, iov.data(), static_cast<int>(iov.size()));
+    serialChecksum sum;
+    d.for_each_segment([&](const T* p, size_t n) { sum.update(p, n * sizeof(T)); });
+    if(sum.digest() != h.checksum) throw std::runtime_error("deserialize: checksum mismatch");
+}
+
+/***********************************************************************
+ *                                                                     |
+ * 流式读写                                                             |
+ *                                                                     |
+ **********************************************************************/
+/**
+ * @brief 分块写出，元素个数和校验和在finish时回填到文件头，所以fd必须可以pwrite(普通文件)
+ *        小块的写入先合并到缓冲区，大块直接写出
+ */
+template<typename T>
+class serial_writer {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "serial_writer requires a trivially copyable T");
+
+    explicit serial_writer(int fd) : fd(fd), count(0), used(0), finished(false) {
+        headerOffset = ::lseek(fd, 0, SEEK_CUR);
+        if(headerOffset < 0) serial_throw_errno("serial_writer: lseek");
+        // 先写一个占位的文件头
+        serialHeader h = serial_make_header<T>(0, 0);
+        serial_write_all(fd, &h, sizeof(h));
+    }
+    serial_writer(const serial_writer&) = delete;
+    serial_writer& operator=(const serial_writer&) = delete;
+    // 析构时不会回填文件头，没有调用finish的文件读的时候会校验失败
+    ~serial_writer() {}
+
+    void write(const T* p, size_t n) {
+        const size_t bytes = n * sizeof(T);
+        sum.update(p, bytes);
+        count += n;
+        if(used + bytes <= sizeof(buffer)) {
+            memcpy(buffer + used, p, bytes);
+            used += bytes;
+            return;
+        }
+        // 缓冲区放不下，和已经缓冲的数据一起写出
+        struct iovec iov[2];
+        iov[0].iov_base = buffer;
+        iov[0].iov_len = used;
+        iov[1].iov_base = const_cast<T*>(p);
+        iov[1].iov_len = bytes;
+        serial_writev_all(fd, iov, 2);
+        used = 0;
+    }
+    void write(const T& value) { write(&value, 1); }
+    void write(const vector<T>& v) { write(v.data(), v.size()); }
+    void write(const deque<T>& d) {
+        d.for_each_segment([this](const T* p, size_t n) { write(p, n); });
+    }
+
+    // 写出缓冲区并回填文件头
+    void finish() {
+        if(finished) return;
+        if(used) serial_write_all(fd, buffer, used);
+        used = 0;
+        serialHeader h = serial_make_header<T>(count, sum.digest());
+        if(::pwrite(fd, &h, sizeof(h), headerOffset) != static_cast<ssize_t>(sizeof(h)))
+            serial_throw_errno("serial_writer: pwrite");
+        finished = true;
+    }
+
+    uint64_t size() const { return count; }
+
+private:
+    int             fd;
+    off_t           headerOffset;
+    uint64_t        count;
+    serialChecksum  sum;
+    size_t          used;
+    bool            finished;
+    char            buffer[SERIAL_STREAM_BUFFER];
+};
+
+/**
+ * @brief 分块读入，读完最后一个元素时检查校验和
+ */
+template<typename T>
+class serial_reader {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "serial_reader requires a trivially copyable T");
+
+    explicit serial_reader(int fd) : fd(fd), header(serial_read_header<T>(fd)), consumed(0) {}
+    serial_reader(const serial_reader&) = delete;
+    serial_reader& operator=(const serial_reader&) = delete;
+
+    uint64_t size()      const { return header.count; }
+    uint64_t remaining() const { return header.count - consumed; }
+
+    // 最多读n个元素到out，返回实际读到的个数，0表示读完了
+    size_t read(T* out, size_t n) {
+        if(n > remaining()) n = static_cast<size_t>(remaining());
+        if(n == 0) return 0;
+        serial_read_all(fd, out, n * sizeof(T));
+        account(out, n);
+        return n;
+    }
+
+    // 最多读n个元素追加到v的末尾
+    size_t read(vector<T>& v, size_t n) {
+        if(n > remaining()) n = static_cast<size_t>(remaining());
+        const size_t oldSize = v.size();
+        serial_grow(v, oldSize + n, serial_overwritable<T>());
+        return read(v.data() + oldSize, n);
+    }
+
+private:
+    void account(const T* p, size_t n) {
+        sum.update(p, n * sizeof(T));
+        consumed += n;
+        if(consumed == header.count && sum.digest() != header.checksum)
+            throw std::runtime_error("serial_reader: checksum mismatch");
+    }
+
+    int             fd;
+    serialHeader    header;
+    uint64_t        consumed;
+    serialChecksum  sum;
+};
+
+}   // end of namespace mystl
+
+#endif
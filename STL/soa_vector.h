@@ -0,0 +1,521 @@
+#ifndef SOA_VECTOR_H
+#define SOA_VECTOR_H
+
+// soa_vector 按列(structure of arrays)存储记录，每个字段存放在自己的一段连续内存中
+// 只访问某一个字段的循环不会把其他字段读进cache，而且可以直接向量化
+// 所有列放在同一块内存里，每一列的起始地址按 SOA_ALIGN 对齐
+
+#include "allocator.h"
+#include "vector.h"
+#include "span.h"
+
+#include <tuple>
+#include <assert.h>
+
+namespace mystl {
+
+#ifndef SOA_ALIGN
+#define SOA_ALIGN 64    // cache line
+#endif
+
+// 所有的布尔值都为真
+template<bool... Bs>
+struct soa_all : std::true_type {};
+template<bool B, bool... Bs>
+struct soa_all<B, Bs...> : std::integral_constant<bool, B && soa_all<Bs...>::value> {};
+
+/**
+ * @brief 行的代理引用，保存这一行每个字段的指针
+ */
+template<typename... Ts>
+class soaRowRef {
+public:
+    typedef std::tuple<typename std::remove_const<Ts>::type...> valueType;
+
+private:
+    std::tuple<Ts*...> ptrs;
+
+public:
+    explicit soaRowRef(const std::tuple<Ts*...>& p) : ptrs(p) {}
+
+    template<size_t I>
+    typename std::tuple_element<I, std::tuple<Ts...>>::type& get() const {
+        return *std::get<I>(ptrs);
+    }
+
+    // 读出整行
+    operator valueType() const { return to_value(make_index_sequence<sizeof...(Ts)>()); }
+
+    // 整行赋值，代理引用的赋值写到容器里
+    const soaRowRef& operator=(const valueType& row) const {
+        assign(row, make_index_sequence<sizeof...(Ts)>());
+        return *this;
+    }
+    const soaRowRef& operator=(const soaRowRef& rhs) const {
+        return *this = static_cast<valueType>(rhs);
+    }
+
+private:
+    template<size_t... Is>
+    valueType to_value(index_sequence<Is...>) const {
+        return valueType(*std::get<Is>(ptrs)...);
+    }
+    template<size_t... Is>
+    void assign(const valueType& row, index_sequence<Is...>) const {
+        int dummy[] = { (*std::get<Is>(ptrs) = std::get<Is>(row), 0)... };
+        (void)dummy;
+    }
+};
+
+/**
+ * @brief soa_vector 的迭代器，解引用得到行的代理引用
+ */
+template<typename... Ts>
+struct soaIterator : public iterator<random_access_iterator_tag,
+                                     std::tuple<typename std::remove_const<Ts>::type...>,
+                                     ptrdiff_t, void, soaRowRef<Ts...>> {
+    typedef soaIterator                             self;
+    typedef soaRowRef<Ts...>                        reference;
+    typedef size_t                                  sizeType;
+    typedef ptrdiff_t                               differenceType;
+
+    std::tuple<Ts*...>                              cols;
+    sizeType                                        index;
+
+    soaIterator() : cols(), index(0) {}
+    soaIterator(const std::tuple<Ts*...>& c, sizeType i) : cols(c), index(i) {}
+
+    reference operator*() const { return row(make_index_sequence<sizeof...(Ts)>()); }
+    reference operator[](differenceType n) const { return *(*this + n); }
+
+    self& operator++() { ++index; return *this; }
+    self& operator--() { --index; return *this; }
+    self operator++(int) { self temp = *this; ++index; return temp; }
+    self operator--(int) { self temp = *this; --index; return temp; }
+    self& operator+=(differenceType n) { index += n; return *this; }
+    self& operator-=(differenceType n) { index -= n; return *this; }
+    self operator+(differenceType n) const { self temp = *this; return temp += n; }
+    self operator-(differenceType n) const { self temp = *this; return temp -= n; }
+    differenceType operator-(const self& rhs) const {
+        return static_cast<differenceType>(index) - static_cast<differenceType>(rhs.index);
+    }
+
+    bool operator==(const self& rhs) const { return index == rhs.index; }
+    bool operator!=(const self& rhs) const { return index != rhs.index; }
+    bool operator< (const self& rhs) const { return index < rhs.index; }
+    bool operator> (const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+
+private:
+    template<size_t... Is>
+    reference row(index_sequence<Is...>) const {
+        return reference(std::tuple<Ts*...>((std::get<Is>(cols) + index)...));
+    }
+};
+
+/**
+ * @brief soa_vector 模板类
+ *
+ * @tparam Ts 每一列的类型
+ */
+template<typename... Ts>
+class soa_vector {
+public:
+    typedef mystl::allocator<char>                          byte_allocator;
+    typedef std::tuple<Ts...>                               valueType;
+    typedef soaRowRef<Ts...>                                reference;
+    typedef soaRowRef<const Ts...>                          constReference;
+    typedef size_t                                          sizeType;
+    typedef ptrdiff_t                                       differenceType;
+
+    typedef soaIterator<Ts...>                              iterator;
+    typedef soaIterator<const Ts...>                        constIterator;
+
+    static constexpr sizeType columns = sizeof...(Ts);
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+    template<size_t I>
+    using columnType = typename std::tuple_element<I, valueType>::type;
+
+private:
+    typedef std::tuple<Ts*...>                              columnPointers;
+    typedef make_index_sequence<sizeof...(Ts)>              columnIndices;
+
+    columnPointers  cols;           // 每一列的起始地址
+    char*           raw;            // 整块内存
+    sizeType        rawBytes;
+    sizeType        nsize;
+    sizeType        ncap;
+
+public:
+    // 构造
+    soa_vector() noexcept : cols(), raw(nullptr), rawBytes(0), nsize(0), ncap(0) {}
+    explicit soa_vector(sizeType n) : soa_vector() { resize(n); }
+
+    // 拷贝
+    soa_vector(const soa_vector&);
+    soa_vector& operator=(const soa_vector& rhs) {
+        if(this != &rhs) {
+            soa_vector temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    // 移动
+    soa_vector(soa_vector&& rhs) noexcept : soa_vector() { swap(rhs); }
+    soa_vector& operator=(soa_vector&& rhs) noexcept {
+        if(this != &rhs) {
+            soa_vector temp(std::move(rhs));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~soa_vector() { free(); }
+
+    // 容量
+    bool        empty()     const { return nsize == 0; }
+    sizeType    size()      const { return nsize; }
+    sizeType    capacity()  const { return ncap; }
+    void        reserve(sizeType n) { if(n > ncap) reallocate(n); }
+    void        resize(sizeType);
+    void        shrink_to_fit() { if(ncap > nsize) reallocate(nsize); }
+
+    // 列访问，循环只碰一列时使用
+    template<size_t I>
+    columnType<I>* data() { return std::get<I>(cols); }
+    template<size_t I>
+    const columnType<I>* data() const { return std::get<I>(cols); }
+    template<size_t I>
+    span<columnType<I>> column() { return span<columnType<I>>(std::get<I>(cols), nsize); }
+    template<size_t I>
+    span<const columnType<I>> column() const {
+        return span<const columnType<I>>(std::get<I>(cols), nsize);
+    }
+
+    // 单个字段
+    template<size_t I>
+    columnType<I>& get(sizeType n) { assert(n < nsize); return std::get<I>(cols)[n]; }
+    template<size_t I>
+    const columnType<I>& get(sizeType n) const { assert(n < nsize); return std::get<I>(cols)[n]; }
+
+    // 行访问，返回代理引用
+    reference       operator[](sizeType n)       { return *(begin() + n); }
+    constReference  operator[](sizeType n) const { return *(cbegin() + n); }
+    reference       front()       { assert(!empty()); return (*this)[0]; }
+    reference       back()        { assert(!empty()); return (*this)[nsize - 1]; }
+
+    // push_back / emplace_back，参数按列的顺序给出每个字段
+    void push_back(const Ts&... fields) { emplace_back(fields...); }
+    void push_back(const valueType& row) { push_row(row, columnIndices()); }
+    template<typename... Us>
+    void emplace_back(Us&&...);
+    void pop_back();
+    void clear() noexcept { destroy_rows(cols, 0, nsize); nsize = 0; }
+
+    void swap(soa_vector& rhs) noexcept {
+        using std::swap;
+        swap(cols, rhs.cols);
+        swap(raw, rhs.raw);
+        swap(rawBytes, rhs.rawBytes);
+        swap(nsize, rhs.nsize);
+        swap(ncap, rhs.ncap);
+    }
+
+    // 迭代器相关
+    iterator      begin()        { return iterator(cols, 0); }
+    iterator      end()          { return iterator(cols, nsize); }
+    constIterator begin()  const { return cbegin(); }
+    constIterator end()    const { return cend(); }
+    constIterator cbegin() const { return constIterator(const_cols(columnIndices()), 0); }
+    constIterator cend()   const { return constIterator(const_cols(columnIndices()), nsize); }
+
+private:
+    // helper function
+    static sizeType align_up(sizeType n, sizeType a) { return (n + a - 1) / a * a; }
+    void     reallocate(sizeType);
+    void     free() noexcept;
+    // 申请能放下newCap行的内存，newCols得到每一列的起始地址，返回整块内存
+    char*    allocate_columns(sizeType newCap, columnPointers& newCols, sizeType& newBytes);
+    // 析构旧的行，释放旧的内存，改用新的内存
+    void     replace_storage(const columnPointers&, char*, sizeType, sizeType) noexcept;
+    template<typename... Us>
+    void     reallocate_emplace(Us&&...);
+
+    // 所有列的移动构造都不抛出异常时才移动，否则能拷贝的列全部拷贝，
+    // 避免前面的列已经移走、后面的列拷贝时抛出异常，原来的行被破坏
+    typedef std::integral_constant<bool, soa_all<std::is_nothrow_move_constructible<Ts>::value...>::value>
+            nothrowMoveRows;
+    template<typename T>
+    static typename std::conditional<nothrowMoveRows::value || !std::is_copy_constructible<T>::value,
+                                     T&&, const T&>::type
+    relocate_source(T& x) noexcept { return std::move(x); }
+
+    template<size_t... Is>
+    std::tuple<const Ts*...> const_cols(index_sequence<Is...>) const {
+        return std::tuple<const Ts*...>(std::get<Is>(cols)...);
+    }
+
+    template<size_t... Is>
+    void push_row(const valueType& row, index_sequence<Is...>) {
+        emplace_back(std::get<Is>(row)...);
+    }
+
+    template<size_t... Is, typename... Us>
+    void construct_row(const columnPointers&, index_sequence<Is...>, sizeType, Us&&...);
+
+    // 按列递归的操作，I == columns 时结束
+    template<size_t I = 0>
+    typename std::enable_if<(I == sizeof...(Ts)), sizeType>::type
+    layout(char*, sizeType, sizeType offset, columnPointers&) const { return offset; }
+    template<size_t I = 0>
+    typename std::enable_if<(I < sizeof...(Ts)), sizeType>::type
+    layout(char*, sizeType, sizeType, columnPointers&) const;
+
+    template<size_t I = 0>
+    typename std::enable_if<(I == sizeof...(Ts))>::type
+    move_rows(columnPointers&) {}
+    template<size_t I = 0>
+    typename std::enable_if<(I < sizeof...(Ts))>::type
+    move_rows(columnPointers&);
+
+    template<size_t I = 0>
+    typename std::enable_if<(I == sizeof...(Ts))>::type
+    copy_rows(const soa_vector&) {}
+    template<size_t I = 0>
+    typename std::enable_if<(I < sizeof...(Ts))>::type
+    copy_rows(const soa_vector&);
+
+    template<size_t I = 0>
+    typename std::enable_if<(I == sizeof...(Ts))>::type
+    default_rows(sizeType, sizeType) {}
+    template<size_t I = 0>
+    typename std::enable_if<(I < sizeof...(Ts))>::type
+    default_rows(sizeType, sizeType);
+
+    // 析构[first, last)行的前cnt列
+    template<size_t I = 0>
+    typename std::enable_if<(I == sizeof...(Ts))>::type
+    destroy_rows(const columnPointers&, sizeType, sizeType, sizeType = sizeof...(Ts)) noexcept {}
+    template<size_t I = 0>
+    typename std::enable_if<(I < sizeof...(Ts))>::type
+    destroy_rows(const columnPointers&, sizeType, sizeType, sizeType = sizeof...(Ts)) noexcept;
+};
+
+template<typename... Ts>
+soa_vector<Ts...>::soa_vector(const soa_vector& rhs) : soa_vector() {
+    reserve(rhs.nsize);
+    copy_rows(rhs);
+    nsize = rhs.nsize;
+}
+
+template<typename... Ts>
+template<typename... Us>
+void soa_vector<Ts...>::emplace_back(Us&&... fields) {
+    static_assert(sizeof...(Us) == sizeof...(Ts), "emplace_back needs one argument per column");
+    if(nsize == ncap) {
+        reallocate_emplace(std::forward<Us>(fields)...);
+    } else {
+        construct_row(cols, columnIndices(), nsize, std::forward<Us>(fields)...);
+    }
+    ++nsize;
+}
+
+template<typename... Ts>
+void soa_vector<Ts...>::pop_back() {
+    assert(!empty());
+    destroy_rows(cols, nsize - 1, nsize);
+    --nsize;
+}
+
+template<typename... Ts>
+void soa_vector<Ts...>::resize(sizeType n) {
+    if(n < nsize) {
+        destroy_rows(cols, n, nsize);
+    } else if(n > nsize) {
+        reserve(n);
+        default_rows(nsize, n);
+    }
+    nsize = n;
+}
+
+/*************************************************************************************/
+// helper function                                                                    /
+/*************************************************************************************/
+template<typename... Ts>
+char* soa_vector<Ts...>::allocate_columns(sizeType newCap, columnPointers& newCols, sizeType& newBytes) {
+    // 多申请 SOA_ALIGN 字节用来把首地址对齐
+    newBytes = layout(nullptr, newCap, 0, newCols) + SOA_ALIGN;
+    char* newRaw = byte_allocator::allocate(newBytes);
+    char* base = newRaw + (align_up(reinterpret_cast<sizeType>(newRaw), SOA_ALIGN) -
+                           reinterpret_cast<sizeType>(newRaw));
+    layout(base, newCap, 0, newCols);
+    return newRaw;
+}
+
+template<typename... Ts>
+void soa_vector<Ts...>::replace_storage(const columnPointers& newCols, char* newRaw,
+                                        sizeType newBytes, sizeType newCap) noexcept {
+    destroy_rows(cols, 0, nsize);
+    byte_allocator::deallocate(raw, rawBytes);
+    cols = newCols;
+    raw = newRaw;
+    rawBytes = newBytes;
+    ncap = newCap;
+}
+
+// 申请新的内存，把已有的行按列移动过去
+template<typename... Ts>
+void soa_vector<Ts...>::reallocate(sizeType newCap) {
+    columnPointers newCols;
+    sizeType newBytes;
+    char* newRaw = allocate_columns(newCap, newCols, newBytes);
+    try {
+        move_rows(newCols);
+    } catch(...) {
+        byte_allocator::deallocate(newRaw, newBytes);
+        throw;
+    }
+    replace_storage(newCols, newRaw, newBytes, newCap);
+}
+
+// 同 vector::reallocate_emplace：先在新内存里构造新的一行，再搬旧的行，
+// 参数引用容器里的元素时，构造新行时旧的行还没有被移走或释放
+template<typename... Ts>
+template<typename... Us>
+void soa_vector<Ts...>::reallocate_emplace(Us&&... fields) {
+    const sizeType newCap = vector_grow_capacity(ncap, nsize + 1);
+    columnPointers newCols;
+    sizeType newBytes;
+    char* newRaw = allocate_columns(newCap, newCols, newBytes);
+    try {
+        construct_row(newCols, columnIndices(), nsize, std::forward<Us>(fields)...);
+    } catch(...) {
+        byte_allocator::deallocate(newRaw, newBytes);
+        throw;
+    }
+    try {
+        move_rows(newCols);
+    } catch(...) {
+        destroy_rows(newCols, nsize, nsize + 1);
+        byte_allocator::deallocate(newRaw, newBytes);
+        throw;
+    }
+    replace_storage(newCols, newRaw, newBytes, newCap);
+}
+
+template<typename... Ts>
+void soa_vector<Ts...>::free() noexcept {
+    destroy_rows(cols, 0, nsize);
+    byte_allocator::deallocate(raw, rawBytes);
+    raw = nullptr;
+    nsize = ncap = rawBytes = 0;
+}
+
+// 计算每一列的起始地址，返回总字节数，base为nullptr时只计算大小
+template<typename... Ts>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Ts)), typename soa_vector<Ts...>::sizeType>::type
+soa_vector<Ts...>::layout(char* base, sizeType cap, sizeType offset,
+                          columnPointers& out) const {
+    typedef columnType<I> T;
+    const sizeType a = alignof(T) > SOA_ALIGN ? alignof(T) : SOA_ALIGN;
+    offset = align_up(offset, a);
+    std::get<I>(out) = base ? reinterpret_cast<T*>(base + offset) : nullptr;
+    return layout<I + 1>(base, cap, offset + cap * sizeof(T), out);
+}
+
+// 所有列的移动构造都不抛出异常时才移动，否则拷贝，保证扩容失败时原来的数据不变
+template<typename... Ts>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Ts))>::type
+soa_vector<Ts...>::move_rows(columnPointers& newCols) {
+    typedef columnType<I> T;
+    T* src = std::get<I>(cols);
+    T* dst = std::get<I>(newCols);
+    sizeType i = 0;
+    try {
+        for(; i < nsize; ++i) {
+            mystl::construct(dst + i, relocate_source(src[i]));
+        }
+    } catch(...) {
+        mystl::destory(dst, dst + i);
+        throw;
+    }
+    try {
+        move_rows<I + 1>(newCols);
+    } catch(...) {
+        mystl::destory(dst, dst + nsize);
+        throw;
+    }
+}
+
+template<typename... Ts>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Ts))>::type
+soa_vector<Ts...>::copy_rows(const soa_vector& rhs) {
+    typedef columnType<I> T;
+    T* dst = std::get<I>(cols);
+    std::uninitialized_copy(std::get<I>(rhs.cols), std::get<I>(rhs.cols) + rhs.nsize, dst);
+    try {
+        copy_rows<I + 1>(rhs);
+    } catch(...) {
+        mystl::destory(dst, dst + rhs.nsize);
+        throw;
+    }
+}
+
+template<typename... Ts>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Ts))>::type
+soa_vector<Ts...>::default_rows(sizeType first, sizeType last) {
+    typedef columnType<I> T;
+    T* col = std::get<I>(cols);
+    sizeType i = first;
+    try {
+        for(; i < last; ++i) mystl::construct(col + i);
+        default_rows<I + 1>(first, last);
+    } catch(...) {
+        mystl::destory(col + first, col + i);
+        throw;
+    }
+}
+
+template<typename... Ts>
+template<size_t I>
+typename std::enable_if<(I < sizeof...(Ts))>::type
+soa_vector<Ts...>::destroy_rows(const columnPointers& c, sizeType first, sizeType last, sizeType cnt) noexcept {
+    if(I >= cnt) return;
+    mystl::destory(std::get<I>(c) + first, std::get<I>(c) + last);
+    destroy_rows<I + 1>(c, first, last, cnt);
+}
+
+// 按列依次构造一行，第k列抛出异常时析构已经构造好的前k列
+template<typename... Ts>
+template<size_t... Is, typename... Us>
+void soa_vector<Ts...>::construct_row(const columnPointers& c, index_sequence<Is...>, sizeType row, Us&&... fields) {
+    sizeType done = 0;
+    try {
+        // 花括号初始化列表保证从左到右求值
+        int dummy[] = { (mystl::construct(std::get<Is>(c) + row,
+                                          std::forward<Us>(fields)), ++done, 0)... };
+        (void)dummy;
+    } catch(...) {
+        destroy_rows(c, row, row + 1, done);
+        throw;
+    }
+}
+
+template<typename... Ts>
+constexpr typename soa_vector<Ts...>::sizeType soa_vector<Ts...>::columns;
+
+template<typename... Ts>
+void swap(soa_vector<Ts...>& x, soa_vector<Ts...>& y) {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
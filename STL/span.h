@@ -0,0 +1,52 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+// span 一段连续内存的视图，不拥有元素(c++20才有std::span)
+
+#include "iterator.h"
+
+#include <assert.h>
+
+namespace mystl {
+
+template<typename T>
+class span {
+public:
+    typedef T                       value_type;
+    typedef T*                      pointer;
+    typedef T&                      reference;
+    typedef size_t                  sizeType;
+    typedef ptrdiff_t               differenceType;
+    typedef T*                      iterator;
+
+private:
+    pointer     ptr;
+    sizeType    len;
+
+public:
+    span() noexcept : ptr(nullptr), len(0) {}
+    span(pointer p, sizeType n) noexcept : ptr(p), len(n) {}
+    span(pointer first, pointer last) noexcept : ptr(first), len(last - first) {}
+
+    pointer     data()  const { return ptr; }
+    sizeType    size()  const { return len; }
+    bool        empty() const { return len == 0; }
+
+    reference   operator[](sizeType n) const { return ptr[n]; }
+    reference   front() const { assert(len); return ptr[0]; }
+    reference   back()  const { assert(len); return ptr[len - 1]; }
+
+    iterator    begin() const { return ptr; }
+    iterator    end()   const { return ptr + len; }
+
+    span first(sizeType n) const { assert(n <= len); return span(ptr, n); }
+    span last(sizeType n)  const { assert(n <= len); return span(ptr + len - n, n); }
+    span subspan(sizeType offset, sizeType n) const {
+        assert(offset + n <= len);
+        return span(ptr + offset, n);
+    }
+};
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,410 @@
+#ifndef SPARSE_VECTOR_H
+#define SPARSE_VECTOR_H
+
+// sparse_vector 下标范围很大(可以到2^32个以上)但只有少数位置被写过的数组
+// 两级页表：目录 -> 页表 -> 页，和deque的 map -> 缓冲区类似，页表和页都在第一次写入时才申请
+// 没有页的位置读出默认值，占用的内存只和写过的页数有关，和下标范围无关
+
+#include "allocator.h"
+#include "vector.h"
+#include "algobase.h"
+#include "uninitialized.h"
+
+#include <assert.h>
+#include <stdexcept>
+
+#ifndef SPARSE_VECTOR_PAGE_BYTES
+#define SPARSE_VECTOR_PAGE_BYTES 4096
+#endif
+
+// 每个页表放的页指针个数，64位下512个指针正好一页
+#ifndef SPARSE_VECTOR_TABLE_SIZE
+#define SPARSE_VECTOR_TABLE_SIZE 512
+#endif
+
+
+namespace mystl {
+
+// 每页的元素个数，同 deque_buf_size
+constexpr inline size_t sparse_page_size(size_t __size) {
+    return (__size < SPARSE_VECTOR_PAGE_BYTES
+            ? size_t(SPARSE_VECTOR_PAGE_BYTES / __size) : size_t(1));
+}
+
+/**
+ * @brief 一个已经申请的页：第一个元素的下标和页内的元素
+ *        最后一页只包含 size() 之前的部分
+ */
+template<typename Ptr>
+struct sparsePage {
+    size_t  index;
+    Ptr     data;
+    size_t  length;
+
+    Ptr     begin() const { return data; }
+    Ptr     end()   const { return data + length; }
+    size_t  size()  const { return length; }
+};
+
+/**
+ * @brief 按页遍历的迭代器，只经过已经申请的页，整个页表为空时一次跳过
+ */
+template<typename Container, typename Ptr>
+struct sparsePageIterator : public iterator<forward_iterator_tag, sparsePage<Ptr>> {
+    typedef sparsePageIterator                      self;
+    typedef sparsePage<Ptr>                         value_type;
+    typedef value_type                              reference;
+    typedef size_t                                  sizeType;
+
+    const Container*    container;
+    sizeType            page;           // 页号，等于 container->page_limit() 时是尾后迭代器
+
+    sparsePageIterator() noexcept : container(nullptr), page(0) {}
+    sparsePageIterator(const Container* c, sizeType p) noexcept : container(c), page(p) {}
+
+    reference operator*() const { return container->template make_page<Ptr>(page); }
+
+    self& operator++() {
+        page = container->next_page(page + 1);
+        return *this;
+    }
+    self operator++(int) {
+        self temp = *this;
+        ++*this;
+        return temp;
+    }
+
+    bool operator==(const self& rhs) const { return page == rhs.page; }
+    bool operator!=(const self& rhs) const { return !(*this == rhs); }
+};
+
+/**
+ * @brief 稀疏数组
+ *        第i个元素在第 i / page_size() 页，页号再分成目录下标和页表内的下标
+ *        const 的读取不会申请内存；写入用 set/ref，页不存在时申请一页并用默认值填满
+ *        元素的地址在页被释放(release_default_pages/resize/clear)之前不变
+ * @tparam T
+ * @tparam Alloc 页和页表都由它申请
+ */
+template<typename T, typename Alloc = mystl::allocator<T>>
+class sparse_vector : private allocator_holder<Alloc> {
+public:
+    typedef Alloc                                           data_allocator;
+    typedef Alloc                                           allocator_type;
+    typedef typename Alloc::template rebind<T*>::other      map_allocator;
+    typedef typename data_allocator::value_type             valueType;
+    typedef typename data_allocator::pointer                pointer;
+    typedef typename data_allocator::constPointer           constPointer;
+    typedef typename data_allocator::reference              reference;
+    typedef typename data_allocator::constReference         constReference;
+    typedef typename data_allocator::sizeType               sizeType;
+    typedef typename data_allocator::differenceType         differenceType;
+    typedef pointer*                                        mapPointer;
+
+    typedef sparsePageIterator<sparse_vector, pointer>      pageIterator;
+    typedef sparsePageIterator<sparse_vector, constPointer> constPageIterator;
+
+    static constexpr sizeType page_size()  { return sparse_page_size(sizeof(T)); }
+    static constexpr sizeType table_size() { return SPARSE_VECTOR_TABLE_SIZE; }
+
+private:
+    // 目录的一项：页表和其中已申请的页数，页数为0时页表被释放
+    struct tableEntry {
+        mapPointer  table;
+        sizeType    used;
+    };
+    typedef typename Alloc::template rebind<tableEntry>::other  directory_allocator;
+
+    mystl::vector<tableEntry, directory_allocator>  directory;
+    sizeType                                        count;
+    sizeType                                        pages;          // 已申请的页数
+    valueType                                       defaultValue;
+
+    friend pageIterator;
+    friend constPageIterator;
+
+public:
+    // 构造，n个元素全部是默认值，不申请页
+    sparse_vector()
+        : directory(directory_allocator(this->alloc())), count(0), pages(0), defaultValue() {}
+    explicit sparse_vector(const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc), directory(directory_allocator(this->alloc())),
+          count(0), pages(0), defaultValue() {}
+    explicit sparse_vector(sizeType n, const valueType& value = valueType(),
+                           const allocator_type& alloc = allocator_type())
+        : allocator_holder<Alloc>(alloc), directory(directory_allocator(this->alloc())),
+          count(n), pages(0), defaultValue(value) {}
+
+    // 拷贝只复制已经申请的页，分配器的规则同vector
+    sparse_vector(const sparse_vector& rhs)
+        : allocator_holder<Alloc>(mystl::alloc_select_on_copy(rhs.alloc())),
+          directory(directory_allocator(this->alloc())), count(rhs.count), pages(0), defaultValue(rhs.defaultValue) {
+        copy_pages(rhs);
+    }
+    sparse_vector(const sparse_vector& rhs, const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc), directory(directory_allocator(this->alloc())),
+          count(rhs.count), pages(0), defaultValue(rhs.defaultValue) {
+        copy_pages(rhs);
+    }
+    sparse_vector& operator=(const sparse_vector& rhs) {
+        if(this != &rhs) {
+            release_pages();
+            count = rhs.count;
+            defaultValue = rhs.defaultValue;
+            copy_pages(rhs);
+        }
+        return *this;
+    }
+
+    // 移动接管目录，分配器不相等时只能拷贝页
+    sparse_vector(sparse_vector&& rhs) noexcept
+        : allocator_holder<Alloc>(rhs.alloc()), directory(std::move(rhs.directory)),
+          count(rhs.count), pages(rhs.pages), defaultValue(rhs.defaultValue) {
+        rhs.count = 0;
+        rhs.pages = 0;
+    }
+    sparse_vector& operator=(sparse_vector&& rhs) noexcept(std::is_empty<Alloc>::value) {
+        if(this == &rhs) return *this;
+        if(!(this->alloc() == rhs.alloc())) return *this = static_cast<const sparse_vector&>(rhs);
+        release_pages();
+        directory = std::move(rhs.directory);
+        count = rhs.count;
+        pages = rhs.pages;
+        defaultValue = rhs.defaultValue;
+        rhs.count = 0;
+        rhs.pages = 0;
+        return *this;
+    }
+
+    ~sparse_vector() { release_pages(); }
+
+    // 容量
+    bool        empty()         const { return count == 0; }
+    sizeType    size()          const { return count; }
+    // 已经申请的页数，以及页、页表和目录实际占用的字节数
+    sizeType    page_count()    const { return pages; }
+    sizeType    memory_bytes()  const;
+    constReference default_value() const { return defaultValue; }
+
+    // 变短时释放 n 之后的页，n 所在页的后半部分恢复成默认值；变长不申请内存
+    void        resize(sizeType n);
+    // 释放所有的页，size 变为0
+    void        clear() { release_pages(); count = 0; }
+    // 释放所有元素都等于默认值的页，返回释放的页数，T 需要 operator==
+    sizeType    release_default_pages();
+
+    // 读取，不申请内存
+    constReference operator[](sizeType i) const {
+        assert(i < count);
+        constPointer page = find_page(i / page_size());
+        return page ? page[i % page_size()] : defaultValue;
+    }
+    constReference at(sizeType i) const {
+        if(i >= count) throw std::out_of_range("sparse_vector::at");
+        return (*this)[i];
+    }
+    // 第i个元素所在的页是否已经申请
+    bool has_page(sizeType i) const {
+        assert(i < count);
+        return find_page(i / page_size()) != nullptr;
+    }
+
+    // 写入，页不存在时先申请
+    reference ref(sizeType i) {
+        assert(i < count);
+        return touch_page(i / page_size())[i % page_size()];
+    }
+    void set(sizeType i, const valueType& value) { ref(i) = value; }
+    void set(sizeType i, valueType&& value)      { ref(i) = std::move(value); }
+    // 恢复成默认值，页不存在时什么也不做
+    void reset(sizeType i) {
+        assert(i < count);
+        pointer page = find_page(i / page_size());
+        if(page) page[i % page_size()] = defaultValue;
+    }
+
+    // 按页遍历，页按下标从小到大
+    pageIterator        page_begin()        { return pageIterator(this, next_page(0)); }
+    pageIterator        page_end()          { return pageIterator(this, page_limit()); }
+    constPageIterator   page_begin()  const { return constPageIterator(this, next_page(0)); }
+    constPageIterator   page_end()    const { return constPageIterator(this, page_limit()); }
+
+    // 分配器跟着页一起交换
+    void swap(sparse_vector& rhs) noexcept {
+        this->swap_alloc(rhs);
+        directory.swap(rhs.directory);
+        std::swap(count, rhs.count);
+        std::swap(pages, rhs.pages);
+        std::swap(defaultValue, rhs.defaultValue);
+    }
+
+    allocator_type get_allocator() const { return this->alloc(); }
+
+private:
+    map_allocator   map_alloc() const { return map_allocator(this->alloc()); }
+    // 页号的上界，目录之外不会有页
+    sizeType        page_limit() const { return directory.size() * table_size(); }
+
+    pointer find_page(sizeType p) const {
+        const sizeType t = p / table_size();
+        if(t >= directory.size() || !directory[t].table) return nullptr;
+        return directory[t].table[p % table_size()];
+    }
+    pointer     touch_page(sizeType);
+    void        free_page(sizeType);
+    void        release_pages();
+    void        copy_pages(const sparse_vector&);
+    // 不小于p的第一个已申请的页号，没有时返回 page_limit()
+    sizeType    next_page(sizeType) const;
+    template<typename Ptr>
+    sparsePage<Ptr> make_page(sizeType p) const {
+        sparsePage<Ptr> page;
+        page.index = p * page_size();
+        page.data = find_page(p);
+        page.length = std::min(page_size(), count - page.index);
+        return page;
+    }
+};
+
+template<typename T, typename Alloc>
+typename sparse_vector<T, Alloc>::sizeType sparse_vector<T, Alloc>::memory_bytes() const {
+    sizeType tables = 0;
+    for(sizeType t = 0; t < directory.size(); ++t) tables += directory[t].table != nullptr;
+    return pages * page_size() * sizeof(T) + tables * table_size() * sizeof(pointer)
+           + directory.capacity() * sizeof(tableEntry);
+}
+
+// 申请第p页，页表不存在时先申请页表，新页用默认值填满
+template<typename T, typename Alloc>
+typename sparse_vector<T, Alloc>::pointer sparse_vector<T, Alloc>::touch_page(sizeType p) {
+    const sizeType t = p / table_size();
+    while(directory.size() <= t) directory.push_back(tableEntry{nullptr, 0});
+    tableEntry& entry = directory[t];
+    if(!entry.table) {
+        entry.table = map_alloc().allocate(table_size());
+        mystl::fill_n(entry.table, table_size(), pointer(nullptr));
+    }
+    pointer& slot = entry.table[p % table_size()];
+    if(slot) return slot;
+    pointer page = this->alloc().allocate(page_size());
+    try {
+        mystl::uninitialized_fill_n_a(page, page_size(), defaultValue, this->alloc());
+    } catch(...) {
+        this->alloc().deallocate(page, page_size());
+        if(entry.used == 0) {
+            map_alloc().deallocate(entry.table, table_size());
+            entry.table = nullptr;
+        }
+        throw;
+    }
+    slot = page;
+    ++entry.used;
+    ++pages;
+    return page;
+}
+
+// 释放第p页，页表空了也一起释放
+template<typename T, typename Alloc>
+void sparse_vector<T, Alloc>::free_page(sizeType p) {
+    tableEntry& entry = directory[p / table_size()];
+    pointer& slot = entry.table[p % table_size()];
+    assert(slot);
+    this->alloc().destory(slot, slot + page_size());
+    this->alloc().deallocate(slot, page_size());
+    slot = nullptr;
+    --pages;
+    if(--entry.used == 0) {
+        map_alloc().deallocate(entry.table, table_size());
+        entry.table = nullptr;
+    }
+}
+
+template<typename T, typename Alloc>
+void sparse_vector<T, Alloc>::release_pages() {
+    for(sizeType p = next_page(0); p < page_limit(); p = next_page(p + 1)) free_page(p);
+    directory.clear();
+    pages = 0;
+}
+
+template<typename T, typename Alloc>
+void sparse_vector<T, Alloc>::copy_pages(const sparse_vector& rhs) {
+    for(sizeType p = rhs.next_page(0); p < rhs.page_limit(); p = rhs.next_page(p + 1)) {
+        pointer page = this->alloc().allocate(page_size());
+        try {
+            mystl::uninitialized_copy_a(rhs.find_page(p), rhs.find_page(p) + page_size(), page, this->alloc());
+        } catch(...) {
+            this->alloc().deallocate(page, page_size());
+            release_pages();
+            throw;
+        }
+        const sizeType t = p / table_size();
+        while(directory.size() <= t) directory.push_back(tableEntry{nullptr, 0});
+        tableEntry& entry = directory[t];
+        if(!entry.table) {
+            try {
+                entry.table = map_alloc().allocate(table_size());
+            } catch(...) {
+                this->alloc().destory(page, page + page_size());
+                this->alloc().deallocate(page, page_size());
+                release_pages();
+                throw;
+            }
+            mystl::fill_n(entry.table, table_size(), pointer(nullptr));
+        }
+        entry.table[p % table_size()] = page;
+        ++entry.used;
+        ++pages;
+    }
+}
+
+template<typename T, typename Alloc>
+typename sparse_vector<T, Alloc>::sizeType sparse_vector<T, Alloc>::next_page(sizeType p) const {
+    for(sizeType t = p / table_size(); t < directory.size(); ++t) {
+        const mapPointer table = directory[t].table;
+        if(table) {
+            for(sizeType s = (t == p / table_size() ? p % table_size() : 0); s < table_size(); ++s)
+                if(table[s]) return t * table_size() + s;
+        }
+    }
+    return page_limit();
+}
+
+template<typename T, typename Alloc>
+void sparse_vector<T, Alloc>::resize(sizeType n) {
+    if(n < count) {
+        // n 所在页之后的页整页释放
+        const sizeType keep = (n + page_size() - 1) / page_size();
+        for(sizeType p = next_page(keep); p < page_limit(); p = next_page(p + 1)) free_page(p);
+        while(!directory.empty() && !directory[directory.size() - 1].table) directory.pop_back();
+        if(n % page_size() != 0) {
+            pointer page = find_page(n / page_size());
+            if(page) mystl::fill_n(page + n % page_size(), page_size() - n % page_size(), defaultValue);
+        }
+    }
+    count = n;
+}
+
+template<typename T, typename Alloc>
+typename sparse_vector<T, Alloc>::sizeType sparse_vector<T, Alloc>::release_default_pages() {
+    sizeType released = 0;
+    for(sizeType p = next_page(0); p < page_limit(); p = next_page(p + 1)) {
+        constPointer page = find_page(p);
+        sizeType j = 0;
+        while(j < page_size() && page[j] == defaultValue) ++j;
+        if(j == page_size()) {
+            free_page(p);
+            ++released;
+        }
+    }
+    while(!directory.empty() && !directory[directory.size() - 1].table) directory.pop_back();
+    return released;
+}
+
+template<typename T, typename Alloc>
+void swap(sparse_vector<T, Alloc>& x, sparse_vector<T, Alloc>& y) noexcept {
+    x.swap(y);
+}
+
+}   // end of namespace mystl
+
+#endif
@@ -35,6 +35,20 @@ public:
     stack(sizeType n, const valueType& value) : c(n, value) {}
 
     stack(const stack& rhs) : c(rhs.c){}
+    stack(stack&& rhs) noexcept(std::is_nothrow_move_constructible<Sequence>::value) : c(std::move(rhs.c)) {}
+    stack& operator=(const stack&) = default;
+    stack& operator=(stack&&) = default;
+
+    // 底层容器接受分配器时(如 pmr::deque)，stack 也可以带分配器构造，嵌套在 pmr 容器里时由外层传入
+    template<typename Alloc,
+             typename = typename std::enable_if<mystl::uses_allocator<Sequence, Alloc>::value>::type>
+    explicit stack(const Alloc& alloc) : c(alloc) {}
+    template<typename Alloc,
+             typename = typename std::enable_if<mystl::uses_allocator<Sequence, Alloc>::value>::type>
+    stack(const stack& rhs, const Alloc& alloc) : c(rhs.c, alloc) {}
+    template<typename Alloc,
+             typename = typename std::enable_if<mystl::uses_allocator<Sequence, Alloc>::value>::type>
+    stack(stack&& rhs, const Alloc& alloc) : c(std::move(rhs.c), alloc) {}
     
 
     bool                empty() const { return c.empty(); }
@@ -58,6 +72,9 @@ bool inline operator!=(const stack<T, Sequence>& x, const stack<T, Sequence>& y)
 }
 
 
+template<typename T, typename Sequence, typename Alloc>
+struct uses_allocator<stack<T, Sequence>, Alloc, void> : uses_allocator<Sequence, Alloc> {};
+
 } // end of mystl
 
 
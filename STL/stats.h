@@ -0,0 +1,175 @@
+#ifndef STATS_H
+#define STATS_H
+
+// 容器热路径上的计数器，用来定位性能回退：vector扩容、deque的map扩容、缓冲区申请释放、insert/erase挪动的元素个数
+// 只有定义了 MYSTL_STATS 才会编译进去，否则 MYSTL_STAT_ADD 什么也不做
+// 每个线程写自己的分片(thread_local)，不加锁也没有原子的读改写；snapshot 时加锁把所有分片加起来
+// 线程退出时分片里的计数合并到全局的累计值里，不会丢失
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "type_traits.h"
+
+#ifdef MYSTL_STATS
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#else
+#include <iosfwd>
+#endif
+
+namespace mystl {
+
+enum class stat_counter : unsigned {
+    vector_reallocations,       // vector 重新申请空间的次数
+    vector_bytes_relocated,     // 扩容时搬到新空间的字节数
+    vector_elements_shifted,    // insert/emplace/erase 在原空间里挪动的元素个数
+    deque_map_reallocations,    // deque 重新安排map的次数(包括原地居中和换新的map)
+    deque_map_slots,            // 每次重新安排后map的大小之和
+    deque_block_allocs,         // 申请的缓冲区个数
+    deque_block_frees,          // 释放的缓冲区个数
+    deque_elements_shifted,     // insert/erase 挪动的元素个数
+    count
+};
+
+const size_t stat_counter_count = static_cast<size_t>(stat_counter::count);
+
+inline const char* stat_counter_name(stat_counter c) {
+    static const char* const names[stat_counter_count] = {
+        "vector_reallocations",
+        "vector_bytes_relocated",
+        "vector_elements_shifted",
+        "deque_map_reallocations",
+        "deque_map_slots",
+        "deque_block_allocs",
+        "deque_block_frees",
+        "deque_elements_shifted"
+    };
+    return names[static_cast<size_t>(c)];
+}
+
+// 某一时刻所有线程计数之和
+struct stats_snapshot {
+    uint64_t values[stat_counter_count];
+
+    uint64_t operator[](stat_counter c) const { return values[static_cast<size_t>(c)]; }
+};
+
+#ifdef MYSTL_STATS
+
+class statsShard;
+
+// 所有线程的分片，故意不析构，保证线程在静态对象析构之后退出时也能使用
+struct statsRegistry {
+    std::mutex  lock;
+    statsShard* head;
+    uint64_t    retired[stat_counter_count];     // 已经退出的线程的计数
+
+    statsRegistry() : head(nullptr) {
+        for(size_t i = 0; i < stat_counter_count; ++i) retired[i] = 0;
+    }
+
+    static statsRegistry& instance() {
+        static statsRegistry* registry = new statsRegistry();
+        return *registry;
+    }
+};
+
+// 只有所属线程会写，其他线程只在snapshot时读，所以用relaxed的load+store而不是fetch_add
+class statsShard {
+public:
+    statsShard() : prev(nullptr), next(nullptr) {
+        for(size_t i = 0; i < stat_counter_count; ++i) values[i].store(0, std::memory_order_relaxed);
+        statsRegistry& r = statsRegistry::instance();
+        std::lock_guard<std::mutex> guard(r.lock);
+        next = r.head;
+        if(next) next->prev = this;
+        r.head = this;
+    }
+    statsShard(const statsShard&) = delete;
+    statsShard& operator=(const statsShard&) = delete;
+    ~statsShard() {
+        statsRegistry& r = statsRegistry::instance();
+        std::lock_guard<std::mutex> guard(r.lock);
+        for(size_t i = 0; i < stat_counter_count; ++i)
+            r.retired[i] += values[i].load(std::memory_order_relaxed);
+        if(prev) prev->next = next;
+        else r.head = next;
+        if(next) next->prev = prev;
+    }
+
+    void add(stat_counter c, uint64_t n) {
+        std::atomic<uint64_t>& v = values[static_cast<size_t>(c)];
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t>   values[stat_counter_count];
+    statsShard*             prev;
+    statsShard*             next;
+};
+
+inline statsShard& stats_local_shard() {
+    thread_local statsShard shard;
+    return shard;
+}
+
+inline void stats_add(stat_counter c, uint64_t n) {
+    stats_local_shard().add(c, n);
+}
+
+inline stats_snapshot stats_take_snapshot() {
+    statsRegistry& r = statsRegistry::instance();
+    stats_snapshot snap;
+    std::lock_guard<std::mutex> guard(r.lock);
+    for(size_t i = 0; i < stat_counter_count; ++i) snap.values[i] = r.retired[i];
+    for(statsShard* s = r.head; s; s = s->next) {
+        for(size_t i = 0; i < stat_counter_count; ++i)
+            snap.values[i] += s->values[i].load(std::memory_order_relaxed);
+    }
+    return snap;
+}
+
+// 清零所有计数，和其他线程正在进行的计数同时发生时可能丢掉几次
+inline void stats_reset() {
+    statsRegistry& r = statsRegistry::instance();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for(size_t i = 0; i < stat_counter_count; ++i) r.retired[i] = 0;
+    for(statsShard* s = r.head; s; s = s->next) {
+        for(size_t i = 0; i < stat_counter_count; ++i)
+            s->values[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+// 每行一个 "名字 值"
+inline void stats_dump(std::ostream& os) {
+    const stats_snapshot snap = stats_take_snapshot();
+    for(size_t i = 0; i < stat_counter_count; ++i)
+        os << stat_counter_name(static_cast<stat_counter>(i)) << " " << snap.values[i] << "\n";
+}
+
+// 常量求值(constexpr vector)中不计数
+#define MYSTL_STAT_ADD(counter, n) \
+    (mystl::is_constant_evaluated() ? (void)0 : \
+     mystl::stats_add(mystl::stat_counter::counter, static_cast<uint64_t>(n)))
+
+#else
+
+// 没有打开统计时snapshot全是0
+inline stats_snapshot stats_take_snapshot() {
+    stats_snapshot snap;
+    for(size_t i = 0; i < stat_counter_count; ++i) snap.values[i] = 0;
+    return snap;
+}
+
+inline void stats_reset() {}
+
+inline void stats_dump(std::ostream&) {}
+
+#define MYSTL_STAT_ADD(counter, n) ((void)0)
+
+#endif
+
+}   // end of namespace mystl
+
+#endif
@@ -0,0 +1,345 @@
+#ifndef THREAD_CACHE_H
+#define THREAD_CACHE_H
+
+// 线程缓存分配器：多个线程频繁创建销毁容器时，不让每次申请都进入系统分配器争用
+// 每个线程对每种大小有两个弹匣(magazine)，申请和释放只操作自己的弹匣，不加锁
+// 两个弹匣都空了(或都满了)才去中央仓库(depot)加锁，一次换回一整个弹匣
+// 对象不属于某个线程：A线程申请B线程释放时直接进入B的弹匣，B攒满了交给仓库，A再从仓库拿回去
+// 大于 THREAD_CACHE_MAX_BYTES 的申请直接使用 ::operator new
+// 定义 MYSTL_THREAD_CACHE 后 mystl::allocator 改为从这里申请，vector/deque 等容器都会使用
+
+#include "construct.h"
+
+#include <stddef.h>
+#include <new>
+#include <mutex>
+#include <utility>
+
+#ifndef THREAD_CACHE_MAX_BYTES
+#define THREAD_CACHE_MAX_BYTES 32768
+#endif
+
+// 弹匣最多能装的对象个数，大对象的弹匣按 THREAD_CACHE_MAGAZINE_BYTES 限制个数
+#ifndef THREAD_CACHE_MAGAZINE_SIZE
+#define THREAD_CACHE_MAGAZINE_SIZE 64
+#endif
+
+#ifndef THREAD_CACHE_MAGAZINE_BYTES
+#define THREAD_CACHE_MAGAZINE_BYTES 65536
+#endif
+
+// 仓库中每种大小最多存放的非空弹匣个数，再多的直接还给系统
+#ifndef THREAD_CACHE_DEPOT_LIMIT
+#define THREAD_CACHE_DEPOT_LIMIT 16
+#endif
+
+namespace mystl {
+
+static_assert(THREAD_CACHE_MAX_BYTES >= 1024 &&
+              (THREAD_CACHE_MAX_BYTES & (THREAD_CACHE_MAX_BYTES - 1)) == 0,
+              "THREAD_CACHE_MAX_BYTES must be a power of two no less than 1024");
+static_assert(THREAD_CACHE_MAGAZINE_SIZE >= 4, "THREAD_CACHE_MAGAZINE_SIZE is too small");
+
+// 大小分级：1024字节以内按16字节一级(0 ~ 63)，再往上每级翻倍(2048为64)
+constexpr size_t __thread_cache_log2(size_t n) {
+    return n <= 1 ? 0 : 1 + __thread_cache_log2(n >> 1);
+}
+
+const size_t thread_cache_class_count =
+    64 + (THREAD_CACHE_MAX_BYTES > 1024 ? __thread_cache_log2(THREAD_CACHE_MAX_BYTES) - 10 : 0);
+
+inline size_t thread_cache_class(size_t bytes) {
+    if(bytes <= 1024) return bytes ? (bytes - 1) >> 4 : 0;
+    size_t cls = 64;
+    for(size_t sz = 2048; sz < bytes; sz <<= 1) ++cls;
+    return cls;
+}
+
+inline size_t thread_cache_class_bytes(size_t cls) {
+    return cls < 64 ? (cls + 1) << 4 : size_t(2048) << (cls - 64);
+}
+
+// 每种大小的弹匣容量，大对象少缓存几个
+inline size_t thread_cache_magazine_capacity(size_t cls) {
+    const size_t n = THREAD_CACHE_MAGAZINE_BYTES / thread_cache_class_bytes(cls);
+    return n < 4 ? 4 : (n > THREAD_CACHE_MAGAZINE_SIZE ? THREAD_CACHE_MAGAZINE_SIZE : n);
+}
+
+struct tcMagazine {
+    tcMagazine* next;
+    size_t      count;
+    void*       rounds[THREAD_CACHE_MAGAZINE_SIZE];
+};
+
+inline tcMagazine* thread_cache_new_magazine() {
+    tcMagazine* mag = new(std::nothrow) tcMagazine;
+    if(mag) {
+        mag->next = nullptr;
+        mag->count = 0;
+    }
+    return mag;
+}
+
+// 把弹匣里的对象还给系统
+inline void thread_cache_drain(tcMagazine* mag) {
+    while(mag->count) ::operator delete(mag->rounds[--mag->count]);
+}
+
+// 中央仓库，每种大小一把锁，存放非空弹匣和空弹匣
+// 故意不析构，线程在静态对象析构之后退出时也能把弹匣交回来
+class tcDepot {
+private:
+    struct depotClass {
+        std::mutex  lock;
+        tcMagazine* full;
+        tcMagazine* empty;
+        size_t      fullCount;
+        depotClass() : full(nullptr), empty(nullptr), fullCount(0) {}
+    };
+    depotClass classes[thread_cache_class_count];
+
+public:
+    static tcDepot& instance() {
+        static tcDepot* depot = new tcDepot();
+        return *depot;
+    }
+
+    // 用空弹匣换一个非空弹匣，仓库里没有时返回nullptr，空弹匣仍归调用者
+    tcMagazine* exchange_empty(size_t cls, tcMagazine* mag) {
+        depotClass& d = classes[cls];
+        std::lock_guard<std::mutex> guard(d.lock);
+        tcMagazine* out = d.full;
+        if(out == nullptr) return nullptr;
+        d.full = out->next;
+        --d.fullCount;
+        mag->next = d.empty;
+        d.empty = mag;
+        return out;
+    }
+
+    // 交出一个满弹匣，换回一个空弹匣；仓库已经存满时把这个弹匣清空后还给调用者
+    // 没有空弹匣可换时返回nullptr，满弹匣已经被仓库收下
+    tcMagazine* exchange_full(size_t cls, tcMagazine* mag) {
+        depotClass& d = classes[cls];
+        {
+            std::lock_guard<std::mutex> guard(d.lock);
+            if(d.fullCount < THREAD_CACHE_DEPOT_LIMIT) {
+                mag->next = d.full;
+                d.full = mag;
+                ++d.fullCount;
+                tcMagazine* out = d.empty;
+                if(out) d.empty = out->next;
+                return out;
+            }
+        }
+        thread_cache_drain(mag);
+        return mag;
+    }
+
+    // 线程退出时交回弹匣，不需要换回什么
+    void give_back(size_t cls, tcMagazine* mag) {
+        depotClass& d = classes[cls];
+        std::unique_lock<std::mutex> guard(d.lock);
+        if(mag->count && d.fullCount < THREAD_CACHE_DEPOT_LIMIT) {
+            mag->next = d.full;
+            d.full = mag;
+            ++d.fullCount;
+            return;
+        }
+        guard.unlock();
+        thread_cache_drain(mag);
+        guard.lock();
+        mag->next = d.empty;
+        d.empty = mag;
+    }
+};
+
+// 每个线程的缓存，loaded 是当前使用的弹匣，previous 是备用的
+class threadCache {
+private:
+    struct classCache {
+        tcMagazine* loaded;
+        tcMagazine* previous;
+    };
+    classCache  caches[thread_cache_class_count];
+    bool*       destroyedFlag;
+
+public:
+    explicit threadCache(bool* flag) : destroyedFlag(flag) {
+        for(size_t i = 0; i < thread_cache_class_count; ++i) {
+            caches[i].loaded = caches[i].previous = nullptr;
+        }
+    }
+    threadCache(const threadCache&) = delete;
+    threadCache& operator=(const threadCache&) = delete;
+    ~threadCache() {
+        flush();
+        *destroyedFlag = true;
+    }
+
+    void* allocate(size_t cls) {
+        tcMagazine* mag = caches[cls].loaded;
+        if(mag && mag->count) return mag->rounds[--mag->count];
+        return allocate_slow(cls);
+    }
+
+    void deallocate(void* p, size_t cls) {
+        tcMagazine* mag = caches[cls].loaded;
+        if(mag && mag->count < thread_cache_magazine_capacity(cls)) {
+            mag->rounds[mag->count++] = p;
+            return;
+        }
+        deallocate_slow(p, cls);
+    }
+
+    // 把所有弹匣交回仓库
+    void flush() {
+        tcDepot& depot = tcDepot::instance();
+        for(size_t i = 0; i < thread_cache_class_count; ++i) {
+            if(caches[i].loaded) depot.give_back(i, caches[i].loaded);
+            if(caches[i].previous) depot.give_back(i, caches[i].previous);
+            caches[i].loaded = caches[i].previous = nullptr;
+        }
+    }
+
+private:
+    bool ensure_magazines(classCache& c) {
+        if(c.loaded == nullptr) c.loaded = thread_cache_new_magazine();
+        if(c.previous == nullptr) c.previous = thread_cache_new_magazine();
+        return c.loaded && c.previous;
+    }
+
+    void* allocate_slow(size_t cls) {
+        classCache& c = caches[cls];
+        const size_t bytes = thread_cache_class_bytes(cls);
+        if(!ensure_magazines(c)) return ::operator new(bytes);
+        if(c.previous->count) {
+            std::swap(c.loaded, c.previous);
+            return c.loaded->rounds[--c.loaded->count];
+        }
+        // 两个弹匣都空了，拿一个空的去仓库换满的
+        tcMagazine* full = tcDepot::instance().exchange_empty(cls, c.previous);
+        if(full) {
+            c.previous = c.loaded;
+            c.loaded = full;
+            return c.loaded->rounds[--c.loaded->count];
+        }
+        // 仓库也没有，直接向系统申请半个弹匣，下次不用马上再进入慢路径
+        const size_t batch = thread_cache_magazine_capacity(cls) / 2;
+        tcMagazine* mag = c.loaded;
+        try {
+            while(mag->count < batch) mag->rounds[mag->count++] = ::operator new(bytes);
+        } catch(...) {
+            if(mag->count == 0) throw;
+        }
+        return mag->rounds[--mag->count];
+    }
+
+    void deallocate_slow(void* p, size_t cls) {
+        classCache& c = caches[cls];
+        if(!ensure_magazines(c)) {
+            ::operator delete(p);
+            return;
+        }
+        if(c.previous->count == 0) {
+            std::swap(c.loaded, c.previous);
+            c.loaded->rounds[c.loaded->count++] = p;
+            return;
+        }
+        // 两个弹匣都满了，把备用的交给仓库换一个空的
+        tcMagazine* empty = tcDepot::instance().exchange_full(cls, c.previous);
+        if(empty == nullptr) empty = thread_cache_new_magazine();
+        c.previous = c.loaded;
+        c.loaded = empty;
+        if(empty == nullptr) {
+            ::operator delete(p);
+            return;
+        }
+        c.loaded->rounds[c.loaded->count++] = p;
+    }
+};
+
+// 本线程的缓存，线程退出销毁之后(比如其他thread_local或静态对象的析构函数中)返回nullptr
+inline threadCache* thread_cache_local() {
+    static thread_local bool destroyed = false;
+    if(destroyed) return nullptr;
+    static thread_local threadCache cache(&destroyed);
+    return &cache;
+}
+
+inline void* thread_cache_allocate(size_t bytes) {
+    if(bytes > THREAD_CACHE_MAX_BYTES) return ::operator new(bytes);
+    const size_t cls = thread_cache_class(bytes);
+    threadCache* cache = thread_cache_local();
+    if(cache == nullptr) return ::operator new(thread_cache_class_bytes(cls));
+    return cache->allocate(cls);
+}
+
+// bytes 必须和申请时相同
+inline void thread_cache_deallocate(void* p, size_t bytes) {
+    if(p == nullptr) return;
+    if(bytes > THREAD_CACHE_MAX_BYTES) {
+        ::operator delete(p);
+        return;
+    }
+    threadCache* cache = thread_cache_local();
+    if(cache == nullptr) ::operator delete(p);
+    else cache->deallocate(p, thread_cache_class(bytes));
+}
+
+// 把本线程缓存的对象都交回仓库，长时间空闲的线程可以调用
+inline void thread_cache_flush() {
+    threadCache* cache = thread_cache_local();
+    if(cache) cache->flush();
+}
+
+// 接口和 mystl::allocator 相同，释放时的个数必须和申请时相同
+template<typename T>
+class thread_cache_allocator {
+    static_assert(alignof(T) <= 16, "thread_cache_allocator: use aligned_allocator for over-aligned types");
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* constPointer;
+    typedef T& reference;
+    typedef const T& constReference;
+    typedef size_t sizeType;
+    typedef ptrdiff_t differenceType;
+
+    template<typename U>
+    struct rebind { typedef thread_cache_allocator<U> other; };
+
+public:
+    // 没有状态，任意两个 thread_cache_allocator 都相等，可以互相转换
+    constexpr thread_cache_allocator() noexcept {}
+    template<typename U>
+    constexpr thread_cache_allocator(const thread_cache_allocator<U>&) noexcept {}
+
+    static pointer allocate() { return allocate(1); }
+    static pointer allocate(sizeType n) {
+        return static_cast<pointer>(thread_cache_allocate(n * sizeof(T)));
+    }
+
+    static void deallocate(pointer ptr) { deallocate(ptr, 1); }
+    static void deallocate(pointer ptr, sizeType n) {
+        thread_cache_deallocate(ptr, n * sizeof(T));
+    }
+
+    template<typename... Args>
+    static void construct(pointer ptr, Args&&... args) {
+        mystl::construct(ptr, std::forward<Args>(args)...);
+    }
+
+    static void destory(pointer ptr) { mystl::destory(ptr); }
+    static void destory(pointer first, pointer last) { mystl::destory(first, last); }
+};
+
+template<typename T, typename U>
+constexpr bool operator==(const thread_cache_allocator<T>&, const thread_cache_allocator<U>&) noexcept { return true; }
+
+template<typename T, typename U>
+constexpr bool operator!=(const thread_cache_allocator<T>&, const thread_cache_allocator<U>&) noexcept { return false; }
+
+}   // end of namespace mystl
+
+#endif
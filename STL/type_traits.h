@@ -2,9 +2,36 @@
 #define TYPE_TRAITS_H
 
 #include <type_traits>
+#include <cstddef>
+
+// c++14 起constexpr函数里可以有循环和赋值；c++20 起常量表达式里可以申请内存(用完之前要释放)
+// vector 的核心操作在c++20下是constexpr的，可以在编译期算出查找表
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304L
+#define MYSTL_CONSTEXPR14 constexpr
+#else
+#define MYSTL_CONSTEXPR14
+#endif
+
+#if defined(__cpp_constexpr_dynamic_alloc) && __cpp_constexpr_dynamic_alloc >= 201907L && \
+    defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811L
+#define MYSTL_CONSTEXPR20 constexpr
+#define MYSTL_HAS_CONSTEXPR_VECTOR 1
+#else
+#define MYSTL_CONSTEXPR20
+#define MYSTL_HAS_CONSTEXPR_VECTOR 0
+#endif
 
 namespace mystl {
 
+// 是否在常量求值中，memmove/operator new 这类只能在运行期用的快速路径要先判断
+inline MYSTL_CONSTEXPR20 bool is_constant_evaluated() noexcept {
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
 template<typename _Tp, _Tp v>
 struct my_integral_constant {
     static constexpr _Tp value = v;
@@ -13,6 +40,28 @@ struct my_integral_constant {
 typedef my_integral_constant<bool, true> my_true_type;
 typedef my_integral_constant<bool, false> my_false_type;
 
+// 对象可以直接用memcpy搬到新的地址，并且搬走之后不需要析构旧对象
+// 平凡可拷贝的类型都满足；像basic_string这种不含指向自身的指针的类型可以特化为true
+// 容器扩容时对这样的类型直接memcpy，省去逐个移动构造和析构
+template<typename T>
+struct is_trivially_relocatable
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+// 编译期整数序列，用于展开tuple等参数包(c++14才有std::index_sequence)
+template<size_t... Is>
+struct index_sequence {};
+
+template<size_t N, size_t... Is>
+struct __make_index_sequence : __make_index_sequence<N - 1, N - 1, Is...> {};
+
+template<size_t... Is>
+struct __make_index_sequence<0, Is...> {
+    typedef index_sequence<Is...> type;
+};
+
+template<size_t N>
+using make_index_sequence = typename __make_index_sequence<N>::type;
+
 
 }   // end of mystl
 
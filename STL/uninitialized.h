@@ -6,18 +6,20 @@
 #include "algobase.h"
 #include "construct.h"
 
+#include <string.h>
+
 namespace mystl {
 
 // uninitialized_move
 template<typename InputIter, typename NoThrowForwardIter>
-NoThrowForwardIter
+MYSTL_CONSTEXPR20 NoThrowForwardIter
 _M_uninitialized_move(InputIter first, InputIter last,
                       NoThrowForwardIter result, std::true_type) {
     return std::move(first, last, result);
 }
 
 template<typename InputIter, typename NoThrowForwardIter>
-NoThrowForwardIter
+MYSTL_CONSTEXPR20 NoThrowForwardIter
 _M_uninitialized_move(InputIter first, InputIter last,
                       NoThrowForwardIter result, std::false_type) {
     NoThrowForwardIter cur = result;
@@ -35,14 +37,117 @@ _M_uninitialized_move(InputIter first, InputIter last,
     return cur;
 }
 
+// 常量求值中未构造的内存不能直接赋值，只能逐个构造
 template<typename InputIter, typename NoThrowForwardIter>
-NoThrowForwardIter
+MYSTL_CONSTEXPR20 NoThrowForwardIter
 uninitialized_move(InputIter first, InputIter last, NoThrowForwardIter result) {
+    if(mystl::is_constant_evaluated())
+        return _M_uninitialized_move(first, last, result, std::false_type());
     return _M_uninitialized_move(first, last, result,
                                  std::is_trivially_move_assignable<
                                  typename iterator_traits<
                                  InputIter>::value_type>{});
 }
+
+// uninitialized_copy
+// 原生指针且元素平凡可拷贝时直接memmove，其他情况逐个拷贝构造
+template<typename InputIter, typename ForwardIter>
+MYSTL_CONSTEXPR20 ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result) {
+    ForwardIter cur = result;
+    try {
+        for(; first != last; ++first, ++cur) {
+            mystl::construct(&*cur, *first);
+        }
+    } catch(...) {
+        mystl::destory(result, cur);
+        throw;
+    }
+    return cur;
+}
+
+template<typename T, typename U>
+MYSTL_CONSTEXPR20 typename std::enable_if<
+    std::is_same<typename std::remove_const<T>::type, U>::value &&
+    std::is_trivially_copyable<U>::value, U*>::type
+uninitialized_copy(T* first, T* last, U* result) {
+    if(mystl::is_constant_evaluated()) {
+        for(; first != last; ++first, ++result) mystl::construct(result, *first);
+        return result;
+    }
+    const size_t n = static_cast<size_t>(last - first);
+    if(n) {
+        memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(U));
+    }
+    return result + n;
+}
+
+// uninitialized_move_if_noexcept
+// 扩容时使用：移动构造不抛出异常(或者不能拷贝)时移动，否则拷贝，保证出错时旧的元素不被破坏
+template<typename InputIter, typename ForwardIter>
+MYSTL_CONSTEXPR20 ForwardIter __uninitialized_move_if_noexcept(InputIter first, InputIter last,
+                                                               ForwardIter result, std::true_type) {
+    return mystl::uninitialized_move(first, last, result);
+}
+
+template<typename InputIter, typename ForwardIter>
+MYSTL_CONSTEXPR20 ForwardIter __uninitialized_move_if_noexcept(InputIter first, InputIter last,
+                                                               ForwardIter result, std::false_type) {
+    return mystl::uninitialized_copy(first, last, result);
+}
+
+template<typename InputIter, typename ForwardIter>
+MYSTL_CONSTEXPR20 ForwardIter uninitialized_move_if_noexcept(InputIter first, InputIter last, ForwardIter result) {
+    typedef typename iterator_traits<InputIter>::value_type value_type;
+    return __uninitialized_move_if_noexcept(first, last, result,
+                                            std::integral_constant<bool,
+                                            std::is_nothrow_move_constructible<value_type>::value ||
+                                            !std::is_copy_constructible<value_type>::value>());
+}
+
+// uninitialized_fill_n
+// 和std::uninitialized_fill_n一样，出错时析构已经构造的元素，另外可以用于常量求值
+template<typename ForwardIter, typename Size, typename T>
+MYSTL_CONSTEXPR20 ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value) {
+    ForwardIter cur = first;
+    try {
+        for(; n > 0; --n, ++cur) {
+            mystl::construct(&*cur, value);
+        }
+    } catch(...) {
+        mystl::destory(first, cur);
+        throw;
+    }
+    return cur;
+}
+
+// uninitialized_relocate
+// 把[first, last)搬到result开始的未初始化内存，搬完之后源区间视为未初始化(已经析构)
+template<typename T>
+T* __uninitialized_relocate(T* first, T* last, T* result, std::true_type) {
+    const size_t n = static_cast<size_t>(last - first);
+    if(n) {
+        memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+    }
+    return result + n;
+}
+
+template<typename T>
+T* __uninitialized_relocate(T* first, T* last, T* result, std::false_type) {
+    // 只在移动构造不抛出异常时使用
+    for(; first != last; ++first, ++result) {
+        mystl::construct(result, std::move(*first));
+        mystl::destory(first);
+    }
+    return result;
+}
+
+template<typename T>
+T* uninitialized_relocate(T* first, T* last, T* result) {
+    return __uninitialized_relocate(first, last, result,
+                                    std::integral_constant<bool,
+                                    is_trivially_relocatable<T>::value>());
+}
+
 }   // end of namespace mystl
 
 #endif
\ No newline at end of file
@@ -2,19 +2,47 @@
 #define VECTOR_H
 
 #include "allocator.h"
+#include "aligned_allocator.h"
 #include "algobase.h"
 #include "uninitialized.h"
+#include "stats.h"
 
 #include <memory>
+#include <functional>
 #include <assert.h>
 
 namespace mystl {
 
+/**
+ * @brief vector 的扩容策略：容量翻倍，且至少能放下 required 个元素
+ *        soa_vector 等按列存储的容器也使用同样的策略
+ * @param capacity 当前容量
+ * @param required 扩容后至少需要的容量
+ * @return size_t
+ */
+inline MYSTL_CONSTEXPR20 size_t vector_grow_capacity(size_t capacity, size_t required) {
+    const size_t doubled = capacity ? capacity << 1 : 1;
+    return doubled > required ? doubled : required;
+}
+
+// vector 数据缓冲区的对齐字节数，0 表示按 alignof(T)
+// 可以全局定义 VECTOR_ALIGNMENT(如 64 对齐到缓存行)，也可以只对某种元素类型特化 vector_alignment
+#ifndef VECTOR_ALIGNMENT
+#define VECTOR_ALIGNMENT 0
+#endif
+
 template<typename T>
-class vector {
+struct vector_alignment : std::integral_constant<size_t, VECTOR_ALIGNMENT> {};
+
+// Alloc 默认是无状态的 mystl::allocator(或按 vector_alignment 对齐的 aligned_allocator)，不占空间
+// 也可以是有状态的分配器，比如 pmr::polymorphic_allocator，每个vector运行时选择自己的内存资源
+template<typename T,
+         typename Alloc = typename aligned_allocator_for<T, vector_alignment<T>::value>::type>
+class vector : private allocator_holder<Alloc> {
 public:
     // vector嵌套型别定义
-    typedef mystl::allocator<T>                          data_allocator; 
+    typedef Alloc                                        data_allocator;
+    typedef Alloc                                        allocator_type;
     typedef typename data_allocator::value_type          value_type;
     typedef typename data_allocator::pointer             pointer;
     typedef typename data_allocator::constPointer        constPointer;
@@ -25,6 +53,13 @@ public:
     
     typedef value_type*                                  iterator;
     typedef const value_type*                            constIterator;
+
+    // release() 交出的缓冲区，由 get_allocator() 申请
+    struct raw_buffer {
+        pointer     data;
+        sizeType    size;
+        sizeType    capacity;
+    };
     
 private:
     iterator start;
@@ -33,336 +68,457 @@ private:
 
 public:
     // 构造
-    vector() : start(0), finish(0), endOfStorage(0) {};
-    explicit vector(sizeType);
-    vector(sizeType, const value_type&);
+    MYSTL_CONSTEXPR20 vector() : start(0), finish(0), endOfStorage(0) {};
+    explicit MYSTL_CONSTEXPR20 vector(const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc), start(0), finish(0), endOfStorage(0) {}
+    explicit MYSTL_CONSTEXPR20 vector(sizeType);
+    MYSTL_CONSTEXPR20 vector(sizeType, const allocator_type&);
+    MYSTL_CONSTEXPR20 vector(sizeType, const value_type&);
+    MYSTL_CONSTEXPR20 vector(sizeType, const value_type&, const allocator_type&);
     // 这里为什么用模板的 https://www.zhihu.com/question/62552068
     // 防止和上一个构造函数冲突 -> vec(5, 10)
     // 解决方法就是判断是否是InputIterator
     // 传入普通函数与模板函数的参数类型与之相匹配时，会优先寻找参数完全匹配的普通函数并调用它
     // 当没有找到参数完全匹配的普通函数时会寻找一个函数模板，将其实例化产生一个匹配的模板函数并调用它
-    // TODO 还存在bug不能使用
+    // 前向迭代器先算出距离只申请一次空间，输入迭代器只能逐个push_back
     template<typename Iter,
              typename = mystl::_RequireInputIter<Iter>>
-    vector(Iter first, Iter last) {
-        assert(first <= last);
-        range_init(first, last);   
+    MYSTL_CONSTEXPR20 vector(Iter first, Iter last) : start(0), finish(0), endOfStorage(0) {
+        range_init(first, last, mystl::iterator_category(first));
     }
-    // 拷贝
-    vector(const vector&);
-    vector& operator=(const vector&);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    MYSTL_CONSTEXPR20 vector(Iter first, Iter last, const allocator_type& alloc)
+        : allocator_holder<Alloc>(alloc), start(0), finish(0), endOfStorage(0) {
+        range_init(first, last, mystl::iterator_category(first));
+    }
+    // 拷贝，新vector的分配器由 select_on_container_copy_construction 决定(pmr 用默认资源)
+    // 赋值不改变分配器，只拷贝元素
+    MYSTL_CONSTEXPR20 vector(const vector&);
+    MYSTL_CONSTEXPR20 vector(const vector&, const allocator_type&);
+    MYSTL_CONSTEXPR20 vector& operator=(const vector&);
 
-    // 移动
-    vector(vector&&) noexcept;
-    vector& operator=(vector&&) noexcept;
+    // 移动，分配器不相等时不能接管对方的缓冲区，只能逐个移动元素
+    MYSTL_CONSTEXPR20 vector(vector&&) noexcept;
+    MYSTL_CONSTEXPR20 vector(vector&&, const allocator_type&);
+    MYSTL_CONSTEXPR20 vector& operator=(vector&&) noexcept(std::is_empty<Alloc>::value);
 
-    ~vector();
+    MYSTL_CONSTEXPR20 ~vector();
 
     // 容量操作
-    bool empty() const;
-    sizeType size() const;
-    sizeType capacity() const;
+    MYSTL_CONSTEXPR20 bool empty() const;
+    MYSTL_CONSTEXPR20 sizeType size() const;
+    MYSTL_CONSTEXPR20 sizeType capacity() const;
+    MYSTL_CONSTEXPR20 void reserve(sizeType);
+    // 只改变size，不初始化新的元素，用于马上会被read/memcpy覆盖的缓冲区
+    void resize_for_overwrite(sizeType);
+    void resize_uninitialized(sizeType n) { resize_for_overwrite(n); }
 
     // 元素访问操作
     // 下标运算符必须是成员函数，返回值一般是元素的引用，一般又返回普通引用和const引用两种
     // 下标运算符作用于常量对象时调用的是const版本，因为常量对象只能调用const成员函数
-    value_type& operator[](sizeType);
-    const value_type& operator[](sizeType) const;
-    value_type& front();
-    const value_type& front() const;
-    value_type& back();
-    const value_type& back() const;
+    MYSTL_CONSTEXPR20 value_type& operator[](sizeType);
+    MYSTL_CONSTEXPR20 const value_type& operator[](sizeType) const;
+    MYSTL_CONSTEXPR20 value_type& front();
+    MYSTL_CONSTEXPR20 const value_type& front() const;
+    MYSTL_CONSTEXPR20 value_type& back();
+    MYSTL_CONSTEXPR20 const value_type& back() const;
+    MYSTL_CONSTEXPR20 pointer data() const { return start; }
 
     // push_back / pop_back
-    void push_back(const value_type&);
-    void pop_back();
+    MYSTL_CONSTEXPR20 void push_back(const value_type& value) { emplace_back(value); }
+    MYSTL_CONSTEXPR20 void push_back(value_type&& value)      { emplace_back(std::move(value)); }
+    MYSTL_CONSTEXPR20 void pop_back();
     // insert
-    iterator insert(constIterator, const value_type&);
+    iterator insert(constIterator cpos, const value_type& value) { return emplace(cpos, value); }
+    iterator insert(constIterator cpos, value_type&& value)      { return emplace(cpos, std::move(value)); }
     iterator insert(constIterator, sizeType, const value_type&);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    iterator insert(constIterator, Iter, Iter);
+
+    // assign / append_range
+    MYSTL_CONSTEXPR20 void assign(sizeType, const value_type&);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    void assign(Iter, Iter);
+    template<typename Iter,
+             typename = mystl::_RequireInputIter<Iter>>
+    void append_range(Iter first, Iter last) { insert(cend(), first, last); }
+    template<typename Range>
+    void append_range(const Range& r) { insert(cend(), r.begin(), r.end()); }
 
     // emplace / emplace_back
     template<typename... Args>
     iterator emplace(constIterator, Args&& ...);
     template<typename... Args>
-    void emplace_back(Args&& ...);
+    MYSTL_CONSTEXPR20 void emplace_back(Args&& ...);
 
     // erase / clear
-    iterator erase(constIterator);
-    iterator erase(constIterator, constIterator);
+    MYSTL_CONSTEXPR20 iterator erase(constIterator);
+    MYSTL_CONSTEXPR20 iterator erase(constIterator, constIterator);
     // clear 操作要注意他只析构，并不会释放内存，所以clear之后不要用索引访问元素
-    void clear() { erase(begin(), end()); }
+    MYSTL_CONSTEXPR20 void clear() { erase(begin(), end()); }
+
+    // 分配器跟着缓冲区一起交换
+    MYSTL_CONSTEXPR20 void swap(vector&) noexcept;
 
-    void swap(const vector&) noexcept;
+    MYSTL_CONSTEXPR20 allocator_type get_allocator() const { return this->alloc(); }
+
+    // 接管/交出原始缓冲区，不拷贝元素
+    // from_raw 的缓冲区必须由默认构造的 data_allocator 的 allocate(capacity) 申请，[0, size) 已经构造
+    // release 之后vector为空，调用者负责析构元素并用 get_allocator().deallocate 释放
+    static vector from_raw(pointer, sizeType, sizeType);
+    raw_buffer release() noexcept;
 
 
     // 迭代器操作
-    iterator begin() const { return start; }
-    iterator end() const { return finish; }
-    constIterator cbegin() const { return start; }
-    constIterator cend() const { return finish; }
+    MYSTL_CONSTEXPR20 iterator begin() const { return start; }
+    MYSTL_CONSTEXPR20 iterator end() const { return finish; }
+    MYSTL_CONSTEXPR20 constIterator cbegin() const { return start; }
+    MYSTL_CONSTEXPR20 constIterator cend() const { return finish; }
 
 
 private:
     // helper function
-    void fill_initialize(sizeType, const value_type&);
-    void range_init(iterator, iterator);
-    void init_space(sizeType, sizeType);
+    MYSTL_CONSTEXPR20 void fill_initialize(sizeType, const value_type&);
+    template<typename Iter>
+    MYSTL_CONSTEXPR20 void range_init(Iter, Iter, input_iterator_tag);
+    template<typename Iter>
+    MYSTL_CONSTEXPR20 void range_init(Iter, Iter, forward_iterator_tag);
+    template<typename Iter>
+    void range_insert(iterator, Iter, Iter, input_iterator_tag);
+    template<typename Iter>
+    void range_insert(iterator, Iter, Iter, forward_iterator_tag);
+    template<typename Iter>
+    void range_assign(Iter, Iter, input_iterator_tag);
+    template<typename Iter>
+    MYSTL_CONSTEXPR20 void range_assign(Iter, Iter, forward_iterator_tag);
+    MYSTL_CONSTEXPR20 void init_space(sizeType, sizeType);
 
-    void reallocate_insert(iterator, const value_type&);
     template<typename... Args>
-    void reallocate_emplace(iterator, Args&&...);
+    MYSTL_CONSTEXPR20 void reallocate_emplace(iterator, Args&&...);
+    template<typename... Args>
+    void emplace_in_place(iterator, Args&&...);
+    template<typename... Args>
+    static bool args_alias(constPointer, constPointer, const Args&...);
     void fill_insert(iterator, sizeType, const value_type&);
-    void free();
-    void destoryAndDeallocate(iterator, iterator, sizeType);
+    MYSTL_CONSTEXPR20 void free();
+    MYSTL_CONSTEXPR20 void destoryAndDeallocate(iterator, iterator, sizeType);
+    void relocate_storage(iterator, iterator, sizeType, sizeType);
+    MYSTL_CONSTEXPR20 void reallocate(sizeType);
 
 
 };
 
 // 普通构造函数
-template<typename T>
-vector<T>::vector(sizeType n) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(sizeType n) {
     fill_initialize(n, T());
 }
 
-template<typename T>
-vector<T>::vector(sizeType n, const value_type& value) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(sizeType n, const allocator_type& alloc)
+            : allocator_holder<Alloc>(alloc) {
+    fill_initialize(n, T());
+}
+
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(sizeType n, const value_type& value) {
     fill_initialize(n, value);
 }
 
-// template<typename T>
-// template<typename Iter, typename isInputIter>
-// vector<T>::vector(Iter first, Iter last) {
-//     assert(first <= last);
-//     range_init(first, last);    
-// }
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(sizeType n, const value_type& value, const allocator_type& alloc)
+            : allocator_holder<Alloc>(alloc) {
+    fill_initialize(n, value);
+}
 
 // 析构函数
-template<typename T>
-vector<T>::~vector() {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::~vector() {
     free();
     start = finish = endOfStorage = nullptr;
 }
 
 // 拷贝构造
-template<typename T>
-vector<T>::vector(const vector& vec) {
-    range_init(vec.start, vec.finsh);
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(const vector& vec)
+            : allocator_holder<Alloc>(mystl::alloc_select_on_copy(vec.alloc())) {
+    range_init(vec.start, vec.finish, random_access_iterator_tag());
+}
+
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(const vector& vec, const allocator_type& alloc)
+            : allocator_holder<Alloc>(alloc) {
+    range_init(vec.start, vec.finish, random_access_iterator_tag());
 }
 
 // 拷贝赋值
-template<typename T>
-vector<T>& vector<T>::operator=(const vector& vec) {
-    if(this != &vec) {
-        auto data = data_allocator::allocate(capacity());
-        auto newFinish = std::uninitialized_copy(vec.start, vec.finish, data);
-        free();
-        start = data;
-        finish = newFinish;
-        endOfStorage = data + vec.capacity();
-    }
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>& vector<T, Alloc>::operator=(const vector& vec) {
+    // 容量够时复用已有的空间，在已有元素上拷贝赋值
+    if(this != &vec) range_assign(vec.start, vec.finish, random_access_iterator_tag());
     return *this;
 }
 
 // 移动构造
-template<typename T>
-vector<T>::vector(vector&& vec) noexcept 
-            : start(vec.start),
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(vector&& vec) noexcept 
+            : allocator_holder<Alloc>(vec.alloc()),
+              start(vec.start),
               finish(vec.finish),
               endOfStorage(vec.endOfStorage) {
     vec.start = nullptr;
     vec.finish = nullptr;
-    vec.enOfStorage = nullptr;
+    vec.endOfStorage = nullptr;
+}
+
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>::vector(vector&& vec, const allocator_type& alloc)
+            : allocator_holder<Alloc>(alloc), start(0), finish(0), endOfStorage(0) {
+    if(this->alloc() == vec.alloc()) {
+        swap(vec);
+    } else {
+        range_init(std::make_move_iterator(vec.start), std::make_move_iterator(vec.finish),
+                   random_access_iterator_tag());
+    }
 }
 
 //移动赋值
-template<typename T>
-vector<T>& vector<T>::operator=(vector&& vec) noexcept {
-    if(this != &vec) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& vec) noexcept(std::is_empty<Alloc>::value) {
+    if(this != &vec && !(this->alloc() == vec.alloc())) {
+        // 对方的缓冲区不是自己的分配器申请的
+        range_assign(std::make_move_iterator(vec.start), std::make_move_iterator(vec.finish),
+                     random_access_iterator_tag());
+    } else if(this != &vec) {
         free();
         start = vec.start;
         finish = vec.finish;
         endOfStorage = vec.endOfStorage;
-        vec.start = vec.finish = vec.endOfStroage = nullptr;
+        vec.start = vec.finish = vec.endOfStorage = nullptr;
     }
     return *this;
 }
 
 // 容量
-template<typename T>
-bool vector<T>::empty() const {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 bool vector<T, Alloc>::empty() const {
     return start == finish;
 }
 
-template<typename T>
-typename vector<T>::sizeType vector<T>::size() const {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::sizeType vector<T, Alloc>::size() const {
     return static_cast<sizeType>(finish - start);
 }
 
-template<typename T>
-typename vector<T>::sizeType vector<T>::capacity() const {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::sizeType vector<T, Alloc>::capacity() const {
     return static_cast<sizeType>(endOfStorage - start);
 }
 
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::reserve(sizeType n) {
+    if(n > capacity()) reallocate(n);
+}
+
+template<typename T, typename Alloc>
+void vector<T, Alloc>::resize_for_overwrite(sizeType n) {
+    static_assert(std::is_trivially_default_constructible<T>::value &&
+                  std::is_trivially_destructible<T>::value,
+                  "resize_for_overwrite requires a trivial T");
+    if(n > capacity()) reallocate(vector_grow_capacity(capacity(), n));
+    finish = start + n;
+}
+
 // 访问元素操作
-template<typename T>
-typename vector<T>::value_type& vector<T>::operator[](sizeType n) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::value_type& vector<T, Alloc>::operator[](sizeType n) {
     // [] 不检查元素越界
     // assert(n >= static_cast<sizeType>(0));
     // assert(n < capacity());
     return *(start + n);
 }
 
-template<typename T>
-const typename vector<T>::value_type& vector<T>::operator[](sizeType n) const {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 const typename vector<T, Alloc>::value_type& vector<T, Alloc>::operator[](sizeType n) const {
     // assert(n >= static_cast<sizeType>(0));
     // assert(n < capacity());
     return *(start + n);    // 返回常量引用
 }
 
-template<typename T>
-typename vector<T>::value_type& vector<T>::front() {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::value_type& vector<T, Alloc>::front() {
     assert(!empty());
     return *(start);
 }
 
-template<typename T>
-const typename vector<T>::value_type& vector<T>::front() const {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 const typename vector<T, Alloc>::value_type& vector<T, Alloc>::front() const {
     assert(!empty());
     return *(start);
 }
 
-template<typename T>
-typename vector<T>::value_type& vector<T>::back() {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::value_type& vector<T, Alloc>::back() {
     assert(!empty());
     return *(finish - 1);
 }
 
-template<typename T>
-const typename vector<T>::value_type& vector<T>::back() const {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 const typename vector<T, Alloc>::value_type& vector<T, Alloc>::back() const {
     assert(!empty());
     return *(finish - 1);
 }
 
-// push_back
-template<typename T>
-void vector<T>::push_back(const value_type& value) {
-    if(finish != endOfStorage) {
-        data_allocator::construct(finish, value);
-        finish++;
-    } else {
-        reallocate_insert(finish, value);
-    }
-}
-
 // pop_back
-template<typename T>
-void vector<T>::pop_back() {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::pop_back() {
     assert(size() != 0);
-    data_allocator::destory(--finish);
+    this->alloc().destory(--finish);
 }
 
 // insert
-template<typename T>
-typename vector<T>::iterator
-vector<T>::insert(constIterator cpos, const value_type& value) {
+template<typename T, typename Alloc>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::insert(constIterator cpos, sizeType n, const value_type& value) {
     assert(cpos >= cbegin() && cpos <= cend());
     sizeType offset = cpos - cbegin();
-    // 这里为什么要拷贝一份non-const的pos因为reallocate_insert不接受constIterator
-    // 一个const 实参无法绑定到一个非const的形参
-    // 详见《c++ primer》 p192
-    iterator pos = begin() + offset;
-    if(finish != endOfStorage && pos == end()) {
-        data_allocator::construct(finish++, value);
-    } else if(finish != endOfStorage) {
-        data_allocator::construct(finish, *(finish - 1));
-        mystl::copy_backward(pos, finish - 1, finish);
-        *pos = value;
-        ++finish;
-    } else {
-        reallocate_insert(pos, value);
-    }
+    iterator pos = begin() + (cpos - cbegin());
+    fill_insert(pos, n, value);
     return start + offset;
 }
 
-template<typename T>
-typename vector<T>::iterator
-vector<T>::insert(constIterator cpos, sizeType n, const value_type& value) {
+// 插入[first, last)，迭代器不能指向本vector
+template<typename T, typename Alloc>
+template<typename Iter, typename>
+typename vector<T, Alloc>::iterator
+vector<T, Alloc>::insert(constIterator cpos, Iter first, Iter last) {
     assert(cpos >= cbegin() && cpos <= cend());
     sizeType offset = cpos - cbegin();
-    iterator pos = begin() + (cpos - cbegin());
-    fill_insert(pos, n, value);
+    range_insert(start + offset, first, last, mystl::iterator_category(first));
     return start + offset;
 }
 
+// assign
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::assign(sizeType n, const value_type& value) {
+    if(n > capacity()) {
+        vector temp(n, value, this->alloc());
+        swap(temp);
+    } else if(n > size()) {
+        std::fill(start, finish, value);
+        finish = mystl::uninitialized_fill_n_a(finish, n - size(), value, this->alloc());
+    } else {
+        std::fill_n(start, n, value);
+        erase(start + n, finish);
+    }
+}
+
+template<typename T, typename Alloc>
+template<typename Iter, typename>
+void vector<T, Alloc>::assign(Iter first, Iter last) {
+    range_assign(first, last, mystl::iterator_category(first));
+}
+
 // emplace
-template<typename T>
+template<typename T, typename Alloc>
 template<typename... Args>
-typename vector<T>::iterator vector<T>::emplace(constIterator cpos, Args&&... args) {
+typename vector<T, Alloc>::iterator vector<T, Alloc>::emplace(constIterator cpos, Args&&... args) {
     assert(cpos >= cbegin() && cpos <= cend());
     sizeType offset = cpos - cbegin();
     iterator pos = start + offset;
-    if(finish != endOfStorage && pos == finish) {
-        data_allocator::construct(finish++, std::forward<Args>(args)...);
-    } else if(finish != endOfStorage) {
-        data_allocator::construct(finish, *(finish - 1));
+    if(finish == endOfStorage) {
+        reallocate_emplace(pos, std::forward<Args>(args)...);
+    } else if(pos == finish) {
+        this->alloc().construct(finish++, std::forward<Args>(args)...);
+    } else if(args_alias(pos, finish, args...)) {
+        // 参数引用了要往后挪的元素，只能先构造出临时对象
+        value_type temp(std::forward<Args>(args)...);
+        MYSTL_STAT_ADD(vector_elements_shifted, finish - pos);
+        this->alloc().construct(finish, std::move(*(finish - 1)));
         mystl::move_backward(pos, finish - 1, finish);
-        *pos = value_type(std::forward<Args>(args)...);
         ++finish;
-    } else 
-        reallocate_emplace(pos, std::forward<Args>(args)...);
+        *pos = std::move(temp);
+    } else {
+        emplace_in_place(pos, std::forward<Args>(args)...);
+    }
     return start + offset;
 }
 
 // emplace_back()
-template<typename T>
+template<typename T, typename Alloc>
 template<typename... Args>
-void vector<T>::emplace_back(Args&&... args) {
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::emplace_back(Args&&... args) {
     if(finish != endOfStorage) {
-        data_allocator::construct(finish++, std::forward<Args>(args)...);
+        this->alloc().construct(finish++, std::forward<Args>(args)...);
     } else {
         reallocate_emplace(finish, std::forward<Args>(args)...);
     }
 }
 
 // erase
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(constIterator cpos) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(constIterator cpos) {
     assert(cpos >= cbegin() && cpos <= cend());
     iterator pos = start + (cpos - cbegin());
+    MYSTL_STAT_ADD(vector_elements_shifted, finish - pos - 1);
     std::move(pos + 1, finish, pos);
-    data_allocator::destory(--finish);
+    this->alloc().destory(--finish);
     return pos;
 }
 
-template<typename T>
-typename vector<T>::iterator vector<T>::erase(constIterator cfirst, constIterator clast) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(constIterator cfirst, constIterator clast) {
     assert(cfirst >= start && clast <= finish && cfirst <= clast);
     sizeType n = cfirst - cbegin();
     iterator first = start + n;
-    data_allocator::destory(std::move(first + (clast - cfirst), finish, first),
+    // 空区间直接返回，否则会把元素移动赋值给自己
+    if(cfirst == clast) return first;
+    MYSTL_STAT_ADD(vector_elements_shifted, cend() - clast);
+    this->alloc().destory(std::move(first + (clast - cfirst), finish, first),
                             finish);
     finish -= (clast - cfirst);
     return start + n;
 }
 
-template<typename T>
-void vector<T>::swap(const vector& rhs) noexcept {
-    using std::swap
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::swap(vector& rhs) noexcept {
+    using std::swap;
     if(this != &rhs) {
+        this->swap_alloc(rhs);
         swap(start, rhs.start);
         swap(finish, rhs.finish);
         swap(endOfStorage, rhs.endOfStorage);
     }
 }
 
+template<typename T, typename Alloc>
+vector<T, Alloc> vector<T, Alloc>::from_raw(pointer data, sizeType size, sizeType capacity) {
+    assert(size <= capacity);
+    vector vec;
+    vec.start = data;
+    vec.finish = data + size;
+    vec.endOfStorage = data + capacity;
+    return vec;
+}
+
+template<typename T, typename Alloc>
+typename vector<T, Alloc>::raw_buffer vector<T, Alloc>::release() noexcept {
+    raw_buffer buf = {start, size(), capacity()};
+    start = finish = endOfStorage = nullptr;
+    return buf;
+}
+
 
 /*************************************************************************************/
 // helper function                                                                    /
 /*************************************************************************************/
-template<typename T>
-void vector<T>::init_space(sizeType n, sizeType cap) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::init_space(sizeType n, sizeType cap) {
     try {
-        start = data_allocator::allocate(cap);
+        start = this->alloc().allocate(cap);
         endOfStorage = start + cap;
         finish = start + n;
     } catch (...) {
@@ -372,45 +528,184 @@ void vector<T>::init_space(sizeType n, sizeType cap) {
     }
 }
 
-template<typename T>
-void vector<T>::fill_initialize(sizeType n, const value_type& value) {
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::fill_initialize(sizeType n, const value_type& value) {
     sizeType cap = std::max(static_cast<sizeType>(8), n);
     init_space(n, cap);
-    std::uninitialized_fill_n(start, n, value);
+    mystl::uninitialized_fill_n_a(start, n, value, this->alloc());
 }
 
-template<typename T>
-void vector<T>::range_init(iterator first, iterator last) {
-    sizeType size = static_cast<sizeType>(last - first);
+template<typename T, typename Alloc>
+template<typename Iter>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::range_init(Iter first, Iter last, input_iterator_tag) {
+    try {
+        for(; first != last; ++first) emplace_back(*first);
+    } catch(...) {
+        free();
+        start = finish = endOfStorage = nullptr;
+        throw;
+    }
+}
+
+template<typename T, typename Alloc>
+template<typename Iter>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::range_init(Iter first, Iter last, forward_iterator_tag) {
+    sizeType size = static_cast<sizeType>(mystl::distance(first, last));
     sizeType cap = std::max(size, static_cast<sizeType>(8));
     init_space(size, cap);
-    std::uninitialized_copy(first, last, start);
+    try {
+        mystl::uninitialized_copy_a(first, last, start, this->alloc());
+    } catch(...) {
+        this->alloc().deallocate(start, cap);
+        start = finish = endOfStorage = nullptr;
+        throw;
+    }
 }
 
-template<typename T>
-void vector<T>::destoryAndDeallocate(iterator _start, iterator _finish, sizeType n) {
-    data_allocator::destory(_start, _finish);
-    data_allocator::deallocate(_start, n);
+// 输入迭代器只能遍历一次，先追加到末尾再旋转到pos
+template<typename T, typename Alloc>
+template<typename Iter>
+void vector<T, Alloc>::range_insert(iterator pos, Iter first, Iter last, input_iterator_tag) {
+    const sizeType offset = pos - start;
+    const sizeType oldSize = size();
+    for(; first != last; ++first) emplace_back(*first);
+    std::rotate(start + offset, start + oldSize, finish);
+}
+
+// 空间足够时在原地挪出n个位置，否则只申请一次新空间
+template<typename T, typename Alloc>
+template<typename Iter>
+void vector<T, Alloc>::range_insert(iterator pos, Iter first, Iter last, forward_iterator_tag) {
+    const sizeType n = static_cast<sizeType>(mystl::distance(first, last));
+    if(n == 0) return;
+    if(static_cast<sizeType>(endOfStorage - finish) >= n) {
+        const sizeType afterElem = finish - pos;
+        iterator oldFinish = finish;
+        MYSTL_STAT_ADD(vector_elements_shifted, afterElem);
+        if(afterElem > n) {
+            finish = mystl::uninitialized_move(finish - n, finish, finish);
+            mystl::move_backward(pos, oldFinish - n, oldFinish);
+            mystl::copy(first, last, pos);
+        } else {
+            Iter mid = first;
+            mystl::advance(mid, afterElem);
+            finish = mystl::uninitialized_copy_a(mid, last, finish, this->alloc());
+            finish = mystl::uninitialized_move(pos, oldFinish, finish);
+            mystl::copy(first, mid, pos);
+        }
+        return;
+    }
+    sizeType newCapacity = vector_grow_capacity(capacity(), size() + n);
+    auto newStart = this->alloc().allocate(newCapacity);
+    MYSTL_STAT_ADD(vector_reallocations, 1);
+    MYSTL_STAT_ADD(vector_bytes_relocated, size() * sizeof(T));
+    if(mystl::is_trivially_relocatable<T>::value) {
+        try {
+            mystl::uninitialized_copy_a(first, last, newStart + (pos - start), this->alloc());
+        } catch(...) {
+            this->alloc().deallocate(newStart, newCapacity);
+            throw;
+        }
+        relocate_storage(newStart, pos, n, newCapacity);
+        return;
+    }
+    // 和 reallocate_emplace 一样先构造新元素：[first, last) 可能是这个vector自己的元素
+    // (v.append_range(v))，旧元素搬走之后再拷贝会读到被移走的对象
+    auto newPos = newStart + (pos - start);
+    auto newFinish = newPos;
+    try {
+        newFinish = mystl::uninitialized_copy_a(first, last, newPos, this->alloc());
+    } catch(...) {
+        this->alloc().deallocate(newStart, newCapacity);
+        throw;
+    }
+    try {
+        mystl::uninitialized_move_if_noexcept(start, pos, newStart);
+    } catch(...) {
+        this->alloc().destory(newPos, newFinish);
+        this->alloc().deallocate(newStart, newCapacity);
+        throw;
+    }
+    try {
+        newFinish = mystl::uninitialized_move_if_noexcept(pos, finish, newFinish);
+    } catch(...) {
+        destoryAndDeallocate(newStart, newFinish, newCapacity);
+        throw;
+    }
+    free();
+    start = newStart;
+    finish = newFinish;
+    endOfStorage = newStart + newCapacity;
 }
 
-template<typename T>
-void vector<T>::free() {
+// 先覆盖已有的元素，多出来的删除，不够的追加
+template<typename T, typename Alloc>
+template<typename Iter>
+void vector<T, Alloc>::range_assign(Iter first, Iter last, input_iterator_tag) {
+    iterator cur = start;
+    for(; first != last && cur != finish; ++first, ++cur) *cur = *first;
+    if(first == last) erase(cur, finish);
+    else range_insert(finish, first, last, input_iterator_tag());
+}
+
+template<typename T, typename Alloc>
+template<typename Iter>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::range_assign(Iter first, Iter last, forward_iterator_tag) {
+    const sizeType n = static_cast<sizeType>(mystl::distance(first, last));
+    if(n > capacity()) {
+        vector temp(this->alloc());
+        temp.range_init(first, last, forward_iterator_tag());
+        swap(temp);
+    } else if(n > size()) {
+        Iter mid = first;
+        mystl::advance(mid, size());
+        mystl::copy(first, mid, start);
+        finish = mystl::uninitialized_copy_a(mid, last, finish, this->alloc());
+    } else {
+        erase(mystl::copy(first, last, start), finish);
+    }
+}
+
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::destoryAndDeallocate(iterator _start, iterator _finish, sizeType n) {
+    this->alloc().destory(_start, _finish);
+    this->alloc().deallocate(_start, n);
+}
+
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::free() {
     destoryAndDeallocate(start, finish,
                          static_cast<sizeType>(endOfStorage - start));
 }
 
-template<typename T>
-void vector<T>::reallocate_insert(iterator pos, const value_type& value) {
-    sizeType newCapacity = size() ? capacity() << 1 : 1;
-    auto newStart = data_allocator::allocate(newCapacity);
+// 扩容时T可以平凡重定位：新元素已经构造在新空间中，旧元素直接memcpy过去，旧空间不需要析构
+// [start, pos) 搬到 newStart，[pos, finish) 搬到新元素之后，中间留出gap个位置
+template<typename T, typename Alloc>
+void vector<T, Alloc>::relocate_storage(iterator newStart, iterator pos,
+                                 sizeType gap, sizeType newCapacity) {
+    auto newPos = mystl::uninitialized_relocate(start, pos, newStart);
+    auto newFinish = mystl::uninitialized_relocate(pos, finish, newPos + gap);
+    this->alloc().deallocate(start, capacity());
+    start = newStart;
+    finish = newFinish;
+    endOfStorage = newStart + newCapacity;
+}
+
+// 把已有元素搬到容量为newCapacity的新空间
+template<typename T, typename Alloc>
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::reallocate(sizeType newCapacity) {
+    auto newStart = this->alloc().allocate(newCapacity);
+    MYSTL_STAT_ADD(vector_reallocations, 1);
+    MYSTL_STAT_ADD(vector_bytes_relocated, size() * sizeof(T));
+    if(mystl::is_trivially_relocatable<T>::value && !mystl::is_constant_evaluated()) {
+        relocate_storage(newStart, finish, 0, newCapacity);
+        return;
+    }
     auto newFinish = newStart;
     try {
-        newFinish = std::uninitialized_copy(start, pos, newStart); // uninitialized_move is support in c17
-        data_allocator::construct(newFinish++, value);
-        newFinish = std::uninitialized_copy(pos, finish, newFinish);
+        newFinish = mystl::uninitialized_move_if_noexcept(start, finish, newStart);
     } catch(...) {
-        // TODO 这里不调用destory直接调用deallocate会造成内存泄漏吗? 会
-        destoryAndDeallocate(newStart, newFinish, newCapacity);
+        this->alloc().deallocate(newStart, newCapacity);
         throw;
     }
     free();
@@ -419,18 +714,34 @@ void vector<T>::reallocate_insert(iterator pos, const value_type& value) {
     endOfStorage = newStart + newCapacity;
 }
 
-template<typename T>
+// 先在新空间构造新元素(args 可能引用旧空间里的元素)，再把旧元素搬过去
+template<typename T, typename Alloc>
 template<typename... Args>
-void vector<T>::reallocate_emplace(iterator pos, Args&&... args) {
-    sizeType newCapacity = size() ? capacity() << 1 : 1;
-    auto newStart = data_allocator::allocate(newCapacity);
+MYSTL_CONSTEXPR20 void vector<T, Alloc>::reallocate_emplace(iterator pos, Args&&... args) {
+    sizeType newCapacity = vector_grow_capacity(capacity(), size() + 1);
+    auto newStart = this->alloc().allocate(newCapacity);
+    MYSTL_STAT_ADD(vector_reallocations, 1);
+    MYSTL_STAT_ADD(vector_bytes_relocated, size() * sizeof(T));
+    try {
+        this->alloc().construct(newStart + (pos - start), std::forward<Args>(args)...);
+    } catch(...) {
+        this->alloc().deallocate(newStart, newCapacity);
+        throw;
+    }
+    if(mystl::is_trivially_relocatable<T>::value && !mystl::is_constant_evaluated()) {
+        relocate_storage(newStart, pos, 1, newCapacity);
+        return;
+    }
     auto newFinish = newStart;
     try {
-        newFinish = mystl::uninitialized_move(start, pos, newStart); // std::uninitialized_move is support in c17
-        data_allocator::construct(newFinish++, std::forward<Args>(args)...);
-        newFinish = mystl::uninitialized_move(pos, finish, newFinish);
+        newFinish = mystl::uninitialized_move_if_noexcept(start, pos, newStart);
+        ++newFinish;
+        newFinish = mystl::uninitialized_move_if_noexcept(pos, finish, newFinish);
     } catch(...) {
-        destoryAndDeallocate(newStart, newFinish, newCapacity);
+        // newFinish 没动说明前半段就失败了，只有新元素需要析构
+        if(newFinish == newStart) this->alloc().destory(newStart + (pos - start));
+        else this->alloc().destory(newStart, newFinish);
+        this->alloc().deallocate(newStart, newCapacity);
         throw;
     }
     free();
@@ -439,32 +750,91 @@ void vector<T>::reallocate_emplace(iterator pos, Args&&... args) {
     endOfStorage = newStart + newCapacity;
 }
 
-template<typename T>
+// 空间足够时把[pos, finish)往后挪一个位置，直接在pos上构造新元素，不经过临时对象
+template<typename T, typename Alloc>
+template<typename... Args>
+void vector<T, Alloc>::emplace_in_place(iterator pos, Args&&... args) {
+    MYSTL_STAT_ADD(vector_elements_shifted, finish - pos);
+    if(mystl::is_trivially_relocatable<T>::value) {
+        // pos 上的元素已经搬走，是未初始化的内存
+        const size_t bytes = static_cast<size_t>(finish - pos) * sizeof(T);
+        memmove(static_cast<void*>(pos + 1), static_cast<const void*>(pos), bytes);
+        try {
+            this->alloc().construct(pos, std::forward<Args>(args)...);
+        } catch(...) {
+            memmove(static_cast<void*>(pos), static_cast<const void*>(pos + 1), bytes);
+            throw;
+        }
+        ++finish;
+        return;
+    }
+    this->alloc().construct(finish, std::move(*(finish - 1)));
+    mystl::move_backward(pos, finish - 1, finish);
+    ++finish;
+    this->alloc().destory(pos);
+    try {
+        this->alloc().construct(pos, std::forward<Args>(args)...);
+    } catch(...) {
+        // 把后面的元素挪回来
+        this->alloc().construct(pos, std::move(*(pos + 1)));
+        std::move(pos + 2, finish, pos + 1);
+        this->alloc().destory(--finish);
+        throw;
+    }
+}
+
+// 是否有参数的地址落在[first, last)里(是其中的元素或元素的成员)
+template<typename T, typename Alloc>
+template<typename... Args>
+bool vector<T, Alloc>::args_alias(constPointer first, constPointer last, const Args&... args) {
+    const char* addrs[] = {nullptr, reinterpret_cast<const char*>(std::addressof(args))...};
+    std::less<const char*> less;
+    for(size_t i = 1; i < sizeof...(Args) + 1; ++i) {
+        if(!less(addrs[i], reinterpret_cast<const char*>(first)) &&
+           less(addrs[i], reinterpret_cast<const char*>(last))) return true;
+    }
+    return false;
+}
+
+template<typename T, typename Alloc>
 void
-vector<T>::fill_insert(iterator pos, sizeType n, const value_type& value) {
+vector<T, Alloc>::fill_insert(iterator pos, sizeType n, const value_type& value) {
     if(n) {
-        if(endOfStorage - finish >= n) {
+        if(static_cast<sizeType>(endOfStorage - finish) >= n) {
+            // value 可能引用的是要被挪动的元素
+            const value_type temp(value);
             const sizeType afterElem = finish - pos;
-            auto newFinish = finish;
+            iterator oldFinish = finish;
+            MYSTL_STAT_ADD(vector_elements_shifted, afterElem);
             if(afterElem > n) {
-                newFinish = std::uninitialized_copy(finish - n, finish, finish);
-                mystl::move_backward(pos, finish - n, finish);
-                std::uninitialized_fill_n(pos, n, value);
-                finish = newFinish;
+                finish = mystl::uninitialized_move(finish - n, finish, finish);
+                mystl::move_backward(pos, oldFinish - n, oldFinish);
+                std::fill(pos, pos + n, temp);
             } else {
-                newFinish = std::uninitialized_fill_n(finish, n - afterElem, value);
-                newFinish = std::uninitialized_copy(pos, finish, newFinish);    // TODO move
-                std::uninitialized_fill_n(pos, afterElem, value);
-                finish = newFinish;
+                finish = mystl::uninitialized_fill_n_a(finish, n - afterElem, temp, this->alloc());
+                finish = mystl::uninitialized_move(pos, oldFinish, finish);
+                std::fill(pos, oldFinish, temp);
             }
         } else {
-            sizeType newCapacity = size() ? capacity() * 2 : 1;
-            auto newStart = data_allocator::allocate(newCapacity);
+            sizeType newCapacity = vector_grow_capacity(capacity(), size() + n);
+            auto newStart = this->alloc().allocate(newCapacity);
             auto newFinish = newStart;
+            MYSTL_STAT_ADD(vector_reallocations, 1);
+            MYSTL_STAT_ADD(vector_bytes_relocated, size() * sizeof(T));
+            if(mystl::is_trivially_relocatable<T>::value) {
+                try {
+                    mystl::uninitialized_fill_n_a(newStart + (pos - start), n, value, this->alloc());
+                } catch(...) {
+                    this->alloc().deallocate(newStart, newCapacity);
+                    throw;
+                }
+                relocate_storage(newStart, pos, n, newCapacity);
+                return;
+            }
             try {
-                newFinish = mystl::uninitialized_move(start, pos, newStart);
-                newFinish = std::uninitialized_fill_n(newFinish, n, value);
-                newFinish = mystl::uninitialized_move(pos, finish, newFinish);
+                newFinish = mystl::uninitialized_move_if_noexcept(start, pos, newStart);
+                newFinish = mystl::uninitialized_fill_n_a(newFinish, n, value, this->alloc());
+                newFinish = mystl::uninitialized_move_if_noexcept(pos, finish, newFinish);
             } catch(...) {
                 destoryAndDeallocate(newStart,newFinish, newCapacity);
                 throw;
@@ -478,8 +848,8 @@ vector<T>::fill_insert(iterator pos, sizeType n, const value_type& value) {
 }
 
 // non-member swap
-template<typename T>
-void swap(const vector<T>& x, const vector<T>& y) {
+template<typename T, typename Alloc>
+void swap(vector<T, Alloc>& x, vector<T, Alloc>& y) {
     x.swap(y);
 }
 
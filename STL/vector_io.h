@@ -0,0 +1,73 @@
+#ifndef VECTOR_IO_H
+#define VECTOR_IO_H
+
+// 把文件/socket中的数据直接读进vector的备用空间，不先清零、不经过中间缓冲区
+// 读到的数据追加在vector末尾，出错时vector不变，返回值和errno与read/pread/readv相同
+// 只支持单字节的元素(char/unsigned char/int8_t等)
+
+#include "vector.h"
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace mystl {
+
+#ifndef VECTOR_READV_EXTRA
+#define VECTOR_READV_EXTRA 65536    // vector_readv 栈上额外缓冲区的大小
+#endif
+
+// 最多读maxBytes个字节追加到v的末尾
+template<typename T>
+ssize_t vector_read(int fd, vector<T>& v, size_t maxBytes) {
+    static_assert(sizeof(T) == 1, "vector_read works on byte vectors");
+    const size_t oldSize = v.size();
+    v.resize_for_overwrite(oldSize + maxBytes);
+    const ssize_t n = ::read(fd, v.data() + oldSize, maxBytes);
+    v.resize_for_overwrite(oldSize + (n > 0 ? static_cast<size_t>(n) : 0));
+    return n;
+}
+
+// 从文件的offset处读，不改变文件偏移
+template<typename T>
+ssize_t vector_pread(int fd, vector<T>& v, size_t maxBytes, off_t offset) {
+    static_assert(sizeof(T) == 1, "vector_pread works on byte vectors");
+    const size_t oldSize = v.size();
+    v.resize_for_overwrite(oldSize + maxBytes);
+    const ssize_t n = ::pread(fd, v.data() + oldSize, maxBytes, offset);
+    v.resize_for_overwrite(oldSize + (n > 0 ? static_cast<size_t>(n) : 0));
+    return n;
+}
+
+// 不知道有多少数据可读时使用：先填满v已有的备用空间，多出来的读到栈上的缓冲区再追加，
+// 一次系统调用就能读完，又不需要为偶尔的大包预先扩容
+template<typename T>
+ssize_t vector_readv(int fd, vector<T>& v) {
+    static_assert(sizeof(T) == 1, "vector_readv works on byte vectors");
+    char extra[VECTOR_READV_EXTRA];
+    const size_t oldSize = v.size();
+    const size_t spare = v.capacity() - oldSize;
+    v.resize_for_overwrite(v.capacity());
+
+    struct iovec iov[2];
+    iov[0].iov_base = v.data() + oldSize;
+    iov[0].iov_len = spare;
+    iov[1].iov_base = extra;
+    iov[1].iov_len = sizeof(extra);
+    // 备用空间足够大时不使用额外缓冲区
+    const int iovcnt = spare < sizeof(extra) ? 2 : 1;
+    const ssize_t n = ::readv(fd, iov, iovcnt);
+    if(n <= 0) {
+        v.resize_for_overwrite(oldSize);
+    } else if(static_cast<size_t>(n) <= spare) {
+        v.resize_for_overwrite(oldSize + static_cast<size_t>(n));
+    } else {
+        const T* first = reinterpret_cast<const T*>(extra);
+        v.append_range(first, first + (static_cast<size_t>(n) - spare));
+    }
+    return n;
+}
+
+}   // end of namespace mystl
+
+#endif
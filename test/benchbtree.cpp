@@ -0,0 +1,66 @@
+#include "../STL/btree.h"
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+
+using namespace std;
+
+// 对比 mystl::btree_map 和 std::map 的插入、随机查找、区间扫描
+// 编译: g++ -std=c++11 -O3 benchbtree.cpp
+
+template<typename F>
+double time_ms(F f) {
+    auto begin = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+int main() {
+    const size_t n = 1 << 21;
+    srand(1024);
+    vector<long> keys(n);
+    for(size_t i = 0; i < n; i++) keys[i] = (long(rand()) << 16) ^ rand();
+
+    mystl::btree_map<long, long> bm;
+    map<long, long> sm;
+    double t1 = time_ms([&] { for(size_t i = 0; i < n; i++) bm.insert(keys[i], long(i)); });
+    double t2 = time_ms([&] { for(size_t i = 0; i < n; i++) sm.insert(make_pair(keys[i], long(i))); });
+    cout << "random insert  btree_map " << t1 << " ms, std::map " << t2 << " ms" << endl;
+
+    long sink = 0;
+    t1 = time_ms([&] { for(size_t i = 0; i < n; i++) sink += bm.find(keys[(i * 7919) % n])->second; });
+    t2 = time_ms([&] { for(size_t i = 0; i < n; i++) sink += sm.find(keys[(i * 7919) % n])->second; });
+    cout << "random find    btree_map " << t1 << " ms, std::map " << t2 << " ms" << endl;
+
+    t1 = time_ms([&] { for(int r = 0; r < 10; r++) for(auto it = bm.begin(); it != bm.end(); ++it) sink += it->second; });
+    t2 = time_ms([&] { for(int r = 0; r < 10; r++) for(auto it = sm.begin(); it != sm.end(); ++it) sink += it->second; });
+    cout << "full scan x10  btree_map " << t1 << " ms, std::map " << t2 << " ms" << endl;
+
+    // 时间序列：顺序追加，再做很多短区间查询
+    mystl::btree_map<long, long> bt;
+    map<long, long> st;
+    t1 = time_ms([&] { for(size_t i = 0; i < n; i++) bt.insert(long(i) * 10, long(i)); });
+    t2 = time_ms([&] { for(size_t i = 0; i < n; i++) st.insert(st.end(), make_pair(long(i) * 10, long(i))); });
+    cout << "append         btree_map " << t1 << " ms, std::map " << t2 << " ms" << endl;
+    t1 = time_ms([&] {
+        for(size_t q = 0; q < 100000; q++) {
+            long from = long(rand() % n) * 10;
+            for(auto it = bt.lower_bound(from); it != bt.end() && it->first < from + 1000; ++it) sink += it->second;
+        }
+    });
+    t2 = time_ms([&] {
+        for(size_t q = 0; q < 100000; q++) {
+            long from = long(rand() % n) * 10;
+            for(auto it = st.lower_bound(from); it != st.end() && it->first < from + 1000; ++it) sink += it->second;
+        }
+    });
+    cout << "range query    btree_map " << t1 << " ms, std::map " << t2 << " ms" << endl;
+    cout << "btree_map bytes per entry " << double(bt.memory_usage()) / bt.size()
+         << ", std::map node is about " << sizeof(long) * 2 + 32 << " bytes" << endl;
+    cout << "sink " << sink << endl;
+}
@@ -0,0 +1,88 @@
+#include "../STL/dynamic_bitset.h"
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+
+using namespace std;
+
+// 对比 mystl::dynamic_bitset 和 std::vector<bool> 的批量运算、计数和扫描
+// 编译: g++ -std=c++11 -O3 -march=native benchdynamicbitset.cpp
+
+template<typename F>
+double time_ms(F f) {
+    auto begin = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+int main() {
+    const size_t n = 1 << 24;
+    const int rounds = 20;
+    mystl::dynamic_bitset a(n), b(n);
+    vector<bool> va(n), vb(n);
+    srand(1024);
+    for(size_t i = 0; i < n; i++) {
+        if(rand() % 8 == 0) { a.set(i); va[i] = true; }
+        if(rand() % 2 == 0) { b.set(i); vb[i] = true; }
+    }
+
+    size_t sink = 0;
+    double t1 = time_ms([&] {
+        for(int r = 0; r < rounds; r++) { a &= b; a |= b; sink += a.count(); }
+    });
+    double t2 = time_ms([&] {
+        for(int r = 0; r < rounds; r++) {
+            for(size_t i = 0; i < n; i++) va[i] = va[i] && vb[i];
+            for(size_t i = 0; i < n; i++) va[i] = va[i] || vb[i];
+            size_t c = 0;
+            for(size_t i = 0; i < n; i++) c += va[i];
+            sink += c;
+        }
+    });
+    cout << "and/or/count   dynamic_bitset " << t1 << " ms, vector<bool> " << t2 << " ms" << endl;
+
+    t1 = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = a.find_first(); i != mystl::dynamic_bitset::npos; i = a.find_next(i))
+                sink += i;
+    });
+    double t3 = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            a.for_each_set([&](size_t i) { sink += i; });
+    });
+    t2 = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = 0; i < n; i++)
+                if(va[i]) sink += i;
+    });
+    cout << "scan set bits  find_next " << t1 << " ms, for_each_set " << t3
+         << " ms, vector<bool> " << t2 << " ms" << endl;
+
+    // 稀疏的位图才是过滤器的常见情况
+    a.reset();
+    for(size_t i = 0; i < n; i += 997) { a.set(i); va[i] = true; }
+    for(size_t i = 0; i < n; i++) va[i] = a[i];
+    t1 = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = a.find_first(); i != mystl::dynamic_bitset::npos; i = a.find_next(i))
+                sink += i;
+    });
+    t2 = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = 0; i < n; i++)
+                if(va[i]) sink += i;
+    });
+    cout << "sparse scan    dynamic_bitset " << t1 << " ms, vector<bool> " << t2 << " ms" << endl;
+
+    a.build_rank_index();
+    t1 = time_ms([&] {
+        for(size_t k = 0; k < 1000000; k++) sink += a.select(k);
+    });
+    cout << "1e6 select     dynamic_bitset " << t1 << " ms" << endl;
+    cout << "memory         dynamic_bitset " << a.num_words() * 8 << " bytes" << endl;
+    cout << sink % 10 << endl;
+}
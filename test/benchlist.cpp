@@ -0,0 +1,83 @@
+#include "../STL/list.h"
+
+#include <iostream>
+#include <list>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+
+using namespace std;
+
+// 对比 intrusive_list、mystl::list 和 std::list 的插入、遍历、从中间摘除
+// 编译: g++ -std=c++11 -O3 benchlist.cpp
+
+struct Item : public mystl::list_hook {
+    long value;
+    explicit Item(long v) : value(v) {}
+};
+
+template<typename F>
+double time_ms(F f) {
+    auto begin = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+int main() {
+    const size_t n = 1 << 20;
+    const int rounds = 20;
+    srand(1024);
+    vector<size_t> order(n);
+    for(size_t i = 0; i < n; i++) order[i] = i;
+    for(size_t i = n - 1; i > 0; i--) swap(order[i], order[rand() % (i + 1)]);
+
+    vector<Item> items;
+    items.reserve(n);
+    for(size_t i = 0; i < n; i++) items.emplace_back(long(i));
+
+    mystl::intrusive_list<Item> il;
+    mystl::list<long> ml;
+    std::list<long> sl;
+    vector<mystl::list<long>::iterator> mit(n);
+    vector<std::list<long>::iterator> sit(n);
+
+    double t1 = time_ms([&] { for(size_t i = 0; i < n; i++) il.push_back(items[i]); });
+    double t2 = time_ms([&] {
+        for(size_t i = 0; i < n; i++) { ml.push_back(long(i)); mit[i] = --ml.end(); }
+    });
+    double t3 = time_ms([&] {
+        for(size_t i = 0; i < n; i++) { sl.push_back(long(i)); sit[i] = --sl.end(); }
+    });
+    cout << "push_back   intrusive " << t1 << " ms, mystl::list " << t2
+         << " ms, std::list " << t3 << " ms" << endl;
+
+    long sink = 0;
+    t1 = time_ms([&] {
+        for(int r = 0; r < rounds; r++) for(auto& x : il) sink += x.value;
+    });
+    t2 = time_ms([&] {
+        for(int r = 0; r < rounds; r++) for(auto it = ml.begin(); it != ml.end(); ++it) sink += *it;
+    });
+    t3 = time_ms([&] {
+        for(int r = 0; r < rounds; r++) for(auto x : sl) sink += x;
+    });
+    cout << "iterate     intrusive " << t1 << " ms, mystl::list " << t2
+         << " ms, std::list " << t3 << " ms" << endl;
+
+    // 按随机顺序摘除一半元素
+    t1 = time_ms([&] { for(size_t i = 0; i < n / 2; i++) il.erase(items[order[i]]); });
+    t2 = time_ms([&] { for(size_t i = 0; i < n / 2; i++) ml.erase(mit[order[i]]); });
+    t3 = time_ms([&] { for(size_t i = 0; i < n / 2; i++) sl.erase(sit[order[i]]); });
+    cout << "unlink      intrusive " << t1 << " ms, mystl::list " << t2
+         << " ms, std::list " << t3 << " ms" << endl;
+
+    // 摘除后重新插入，mystl::list复用池中的结点
+    t2 = time_ms([&] { for(size_t i = 0; i < n / 2; i++) ml.push_front(long(i)); });
+    t3 = time_ms([&] { for(size_t i = 0; i < n / 2; i++) sl.push_front(long(i)); });
+    cout << "reinsert    mystl::list " << t2 << " ms, std::list " << t3 << " ms" << endl;
+
+    il.clear();
+    cout << "sink " << sink << endl;
+}
@@ -0,0 +1,74 @@
+#include "../STL/packed_vector.h"
+#include "../STL/vector.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+
+using namespace std;
+
+// 对比 mystl::vector<uint64_t> 和 packed_vector / sorted_packed_vector 的内存、顺序扫描和随机访问
+// 编译: g++ -std=c++11 -O3 -march=native benchpackedvector.cpp
+
+template<typename F>
+double time_ms(F f) {
+    auto begin = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+int main() {
+    const size_t n = size_t(1) << 24;
+    const int rounds = 10;
+    srand(2024);
+    mystl::vector<uint64_t> ids, stamps;
+    ids.reserve(n);
+    stamps.reserve(n);
+    uint64_t t = 1700000000000ull;
+    for(size_t i = 0; i < n; i++) {
+        ids.push_back(static_cast<uint64_t>(rand()) % 1000000);
+        t += static_cast<uint64_t>(rand() % 1000);
+        stamps.push_back(t);
+    }
+    mystl::packed_vector packed(ids.data(), ids.data() + n);
+    mystl::sorted_packed_vector sorted(stamps.data(), stamps.data() + n);
+    cout << "memory  vector " << n * sizeof(uint64_t) / 1024 << " KB, packed(" << packed.bit_width() << " bit) "
+         << packed.memory_bytes() / 1024 << " KB, sorted delta " << sorted.memory_bytes() / 1024 << " KB" << endl;
+
+    // 顺序扫描：每次解码4096个到调用者的缓冲区
+    const size_t chunk = 4096;
+    mystl::vector<uint64_t> buf(chunk, 0);
+    uint64_t sink = 0;
+    double tv = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = 0; i < n; i++) sink += ids[i];
+    });
+    double tp = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = 0; i < n; i += chunk) {
+                size_t k = packed.decode(i, chunk, buf.data());
+                for(size_t j = 0; j < k; j++) sink += buf[j];
+            }
+    });
+    double ts = time_ms([&] {
+        for(int r = 0; r < rounds; r++)
+            for(size_t i = 0; i < n; i += chunk) {
+                size_t k = sorted.decode(i, chunk, buf.data());
+                for(size_t j = 0; j < k; j++) sink += buf[j];
+            }
+    });
+    cout << "scan    vector " << tv << " ms, packed decode " << tp << " ms, sorted decode " << ts << " ms" << endl;
+
+    // 随机访问
+    const size_t probes = 1 << 22;
+    mystl::vector<size_t> idx;
+    idx.reserve(probes);
+    for(size_t i = 0; i < probes; i++) idx.push_back(static_cast<size_t>(rand()) % n);
+    tv = time_ms([&] { for(size_t i : idx) sink += ids[i]; });
+    tp = time_ms([&] { for(size_t i : idx) sink += packed[i]; });
+    ts = time_ms([&] { for(size_t i : idx) sink += sorted[i]; });
+    cout << "random  vector " << tv << " ms, packed " << tp << " ms, sorted " << ts << " ms" << endl;
+    cout << "sink " << sink % 10 << endl;
+}
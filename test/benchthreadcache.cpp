@@ -0,0 +1,98 @@
+#include "../STL/thread_cache.h"
+#include "../STL/allocator.h"
+#include "../STL/vector.h"
+#include "../STL/deque.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+
+using namespace std;
+
+// 多线程申请释放：mystl::allocator(直接 ::operator new) 对比 thread_cache_allocator
+// 编译: g++ -std=c++11 -O3 -pthread benchthreadcache.cpp
+// 加上 -DMYSTL_THREAD_CACHE 后最后一项容器测试也走线程缓存，分别编译两次对比
+
+template<typename F>
+double time_ms(F f) {
+    auto begin = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+template<typename F>
+double run_threads(int nthreads, F f) {
+    return time_ms([&] {
+        vector<thread> workers;
+        for(int t = 0; t < nthreads; t++) workers.emplace_back(f, t);
+        for(auto& w : workers) w.join();
+    });
+}
+
+// 模拟vector扩容：8, 16, ..., 1024 个int依次申请，再倒序释放
+template<typename Alloc>
+void growth_churn(int rounds) {
+    int* blocks[8];
+    for(int r = 0; r < rounds; r++) {
+        for(int i = 0; i < 8; i++) {
+            blocks[i] = Alloc::allocate(size_t(8) << i);
+            blocks[i][0] = i;
+        }
+        for(int i = 7; i >= 0; i--) Alloc::deallocate(blocks[i], size_t(8) << i);
+    }
+}
+
+// 每个线程申请一批，交给下一个线程释放
+template<typename Alloc>
+double cross_thread(int nthreads, size_t perThread) {
+    vector<vector<int*>> batches(nthreads, vector<int*>(perThread));
+    double t1 = run_threads(nthreads, [&](int t) {
+        for(size_t i = 0; i < perThread; i++) batches[t][i] = Alloc::allocate(16);
+    });
+    double t2 = run_threads(nthreads, [&](int t) {
+        vector<int*>& batch = batches[(t + 1) % nthreads];
+        for(size_t i = 0; i < perThread; i++) Alloc::deallocate(batch[i], 16);
+    });
+    return t1 + t2;
+}
+
+int main() {
+    const int nthreads = 8;
+    const int rounds = 200000;
+    const size_t perThread = 1 << 18;
+    typedef mystl::allocator<int> plain;
+    typedef mystl::thread_cache_allocator<int> cached;
+
+    double t1 = run_threads(nthreads, [&](int) { growth_churn<plain>(rounds); });
+    double t2 = run_threads(nthreads, [&](int) { growth_churn<cached>(rounds); });
+    cout << "growth churn   allocator " << t1 << " ms, thread_cache " << t2 << " ms" << endl;
+
+    for(int r = 0; r < 3; r++) {
+        t1 = cross_thread<plain>(nthreads, perThread);
+        t2 = cross_thread<cached>(nthreads, perThread);
+        cout << "cross thread   allocator " << t1 << " ms, thread_cache " << t2 << " ms" << endl;
+    }
+
+    long sink = 0;
+    double t3 = run_threads(nthreads, [&](int t) {
+        long local = 0;
+        for(int r = 0; r < rounds / 20; r++) {
+            mystl::vector<int> vec;
+            for(int i = 0; i < 200; i++) vec.push_back(i + t);
+            mystl::deque<int> dq;
+            for(int i = 0; i < 300; i++) dq.push_back(i);
+            while(!dq.empty()) dq.pop_front();
+            local += vec.back();
+        }
+        if(local == 0) sink++;
+    });
+#ifdef MYSTL_THREAD_CACHE
+    cout << "containers     thread_cache " << t3 << " ms" << endl;
+#else
+    cout << "containers     allocator " << t3 << " ms" << endl;
+#endif
+    return static_cast<int>(sink);
+}
@@ -0,0 +1,80 @@
+#include "../STL/vector.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+
+
+using namespace std;
+
+// 统计 mystl::vector 和 std::vector 在扩容、中间插入、emplace 时的拷贝和移动次数
+// NoexceptMove 为false时扩容只能拷贝(move_if_noexcept)，两边的结果应该一致
+// 编译: g++ -std=c++11 -O3 benchvector.cpp
+
+struct counter {
+    long copies;
+    long moves;
+    long constructs;
+};
+
+template<bool NoexceptMove>
+struct counted {
+    static counter count;
+    string payload;
+
+    explicit counted(int i) : payload(32, char('a' + i % 26)) { ++count.constructs; }
+    counted(const counted& rhs) : payload(rhs.payload) { ++count.copies; }
+    counted(counted&& rhs) noexcept(NoexceptMove) : payload(std::move(rhs.payload)) { ++count.moves; }
+    counted& operator=(const counted& rhs) { payload = rhs.payload; ++count.copies; return *this; }
+    counted& operator=(counted&& rhs) noexcept(NoexceptMove) {
+        payload = std::move(rhs.payload);
+        ++count.moves;
+        return *this;
+    }
+};
+
+template<bool NoexceptMove>
+counter counted<NoexceptMove>::count;
+
+template<typename F>
+double time_ms(F f) {
+    auto begin = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - begin).count();
+}
+
+template<typename Vec, typename T>
+void run(const char* name) {
+    const int n = 100000;
+    const int middle = 2000;
+    Vec v;
+    T::count = counter();
+    double t = time_ms([&] { for(int i = 0; i < n; i++) v.push_back(T(i)); });
+    cout << name << " push_back(T&&) " << t << " ms, copies " << T::count.copies
+         << " moves " << T::count.moves << endl;
+
+    T::count = counter();
+    t = time_ms([&] { for(int i = 0; i < middle; i++) v.emplace(v.begin() + v.size() / 2, i); });
+    cout << name << " emplace middle " << t << " ms, constructs " << T::count.constructs
+         << " copies " << T::count.copies << " moves " << T::count.moves << endl;
+
+    T::count = counter();
+    t = time_ms([&] { for(int i = 0; i < middle; i++) v.insert(v.begin() + v.size() / 2, T(i)); });
+    cout << name << " insert(T&&) middle " << t << " ms, copies " << T::count.copies
+         << " moves " << T::count.moves << endl;
+
+    T::count = counter();
+    const T value(7);
+    t = time_ms([&] { v.insert(v.begin() + v.size() / 2, 1000, value); });
+    cout << name << " fill insert " << t << " ms, copies " << T::count.copies
+         << " moves " << T::count.moves << endl;
+}
+
+int main() {
+    run<mystl::vector<counted<true>>, counted<true>>("mystl noexcept ");
+    run<std::vector<counted<true>>, counted<true>>("std   noexcept ");
+    run<mystl::vector<counted<false>>, counted<false>>("mystl throwing ");
+    run<std::vector<counted<false>>, counted<false>>("std   throwing ");
+}
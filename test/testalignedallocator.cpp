@@ -0,0 +1,72 @@
+#include "../STL/vector.h"
+#include "../STL/deque.h"
+#include "../STL/aligned_allocator.h"
+
+#include <iostream>
+#include <stdint.h>
+
+
+using namespace std;
+
+// 超过 operator new 默认对齐的类型，比如一个 AVX-512 寄存器宽度的向量
+struct alignas(64) lane {
+    float v[16];
+};
+
+// 每个线程一个计数槽，相邻的槽不能落在同一个缓存行
+struct alignas(mystl::cache_line_size) padded_counter {
+    long value;
+};
+
+// 只让 float 的 vector 按页对齐，double 的 deque 缓冲区按缓存行对齐
+namespace mystl {
+template<> struct vector_alignment<float> : std::integral_constant<size_t, page_size> {};
+template<> struct deque_buf_alignment<double> : std::integral_constant<size_t, cache_line_size> {};
+}
+
+template<typename T>
+bool aligned_to(const T* ptr, size_t align) {
+    return reinterpret_cast<uintptr_t>(ptr) % align == 0;
+}
+
+int main() {
+    cout << "default new alignment " << mystl::default_new_alignment << endl;
+
+    mystl::vector<lane> lanes;
+    bool allAligned = true;
+    for(int i = 0; i < 100; i++) {
+        lanes.push_back(lane());
+        allAligned = allAligned && aligned_to(lanes.data(), 64);
+    }
+    cout << "over-aligned vector aligned " << allAligned << " sizeof " << sizeof(lane) << endl;
+
+    mystl::vector<padded_counter> counters(8);
+    cout << "counters on separate lines "
+         << (reinterpret_cast<char*>(&counters[1]) - reinterpret_cast<char*>(&counters[0]) == 64)
+         << " aligned " << aligned_to(counters.data(), 64) << endl;
+
+    mystl::vector<float> samples;
+    for(int i = 0; i < 5000; i++) {
+        samples.push_back(float(i));
+        if(!aligned_to(samples.data(), mystl::page_size)) allAligned = false;
+    }
+    cout << "float vector page aligned " << allAligned << " size " << samples.size() << endl;
+
+    mystl::deque<double> dq;
+    for(int i = 0; i < 1000; i++) {
+        dq.push_back(i);
+        dq.push_front(-i);
+    }
+    bool buffersAligned = true;
+    for(auto it = dq.begin(); it != dq.end(); ++it) {
+        if(it.cur == it.first && !aligned_to(it.first, mystl::cache_line_size)) buffersAligned = false;
+    }
+    cout << "deque buffers aligned " << buffersAligned << " size " << dq.size() << endl;
+
+    // 直接使用 aligned_allocator
+    typedef mystl::aligned_allocator<char, 256> alloc;
+    char* buf = alloc::allocate(10);
+    cout << "aligned_allocator<char, 256> " << aligned_to(buf, 256) << " alignment " << alloc::alignment << endl;
+    alloc::deallocate(buf, 10);
+    cout << "aligned_allocator<lane, 16> alignment " << mystl::aligned_allocator<lane, 16>::alignment << endl;
+}
@@ -0,0 +1,41 @@
+#include "../STL/basic_string.h"
+#include "../STL/vector.h"
+
+#include <iostream>
+
+
+using namespace std;
+
+int main() {
+    // 短字符串放在对象内部
+    mystl::string s("hello");
+    cout << "sizeof(string) is " << sizeof(mystl::string) << endl;
+    cout << s << " size is " << s.size() << " capacity is " << s.capacity() << endl;
+
+    s += ", world";
+    s.append(" and everyone in it");
+    cout << s << " size is " << s.size() << " capacity is " << s.capacity() << endl;
+
+    cout << "find world at " << s.find("world") << endl;
+    cout << "find 'e' from 2 at " << s.find('e', 2) << endl;
+    cout << "rfind 'e' at " << s.rfind('e') << endl;
+    cout << "substr(7, 5) is " << s.substr(7, 5) << endl;
+
+    s.erase(5, 7);
+    cout << "after erase " << s << endl;
+    s.resize(5);
+    s.shrink_to_fit();
+    cout << "after resize " << s << " capacity is " << s.capacity() << endl;
+
+    mystl::string t(30, 'x');
+    cout << t << " size is " << t.size() << endl;
+    cout << "compare " << (s < t) << " " << (s == "hello") << endl;
+    cout << s + t << endl;
+
+    // vector扩容时string直接memcpy搬移
+    mystl::vector<mystl::string> v;
+    for(int i = 0; i < 10; i++) {
+        v.push_back(mystl::string(size_t(i * 4), char('a' + i)));
+    }
+    for(auto it = v.begin(); it != v.end(); ++it) cout << *it << endl;
+}
@@ -0,0 +1,87 @@
+#include "../STL/btree.h"
+
+#include <iostream>
+#include <string>
+
+
+using namespace std;
+
+// 第 failAt 次拷贝时抛出异常
+struct fragile_key {
+    static int copies;
+    static int failAt;
+    string name;
+    fragile_key(const string& n) : name(n) {}
+    fragile_key(const fragile_key& rhs) : name(rhs.name) {
+        if(++copies == failAt) throw runtime_error("key copy failed");
+    }
+    bool operator<(const fragile_key& rhs) const { return name < rhs.name; }
+};
+int fragile_key::copies = 0;
+int fragile_key::failAt = 0;
+
+int main() {
+    mystl::btree_map<int, string> m;
+    m.insert(3, "three");
+    m.insert(make_pair(1, string("one")));
+    m[2] = "two";
+    m.emplace(5, "five");
+    m.insert_or_assign(3, "THREE");
+    for(auto it = m.begin(); it != m.end(); ++it) cout << it->first << ":" << it->second << " ";
+    cout << endl << "size is " << m.size() << " at(2) is " << m.at(2) << endl;
+
+    auto lb = m.lower_bound(4);
+    cout << "lower_bound(4) is " << lb->first << endl;
+    cout << "erase 2 returns " << m.erase(2) << ", contains 2 is " << m.contains(2) << endl;
+
+    // 时间序列：按时间戳批量构建，再做区间扫描
+    mystl::vector<pair<long, double>> samples;
+    for(long t = 0; t < 100000; t += 10) samples.push_back(make_pair(t, t * 0.5));
+    mystl::btree_map<long, double> series(samples);
+    cout << "series size is " << series.size() << " height is " << series.height()
+         << " leaves " << series.leaf_count() << endl;
+    double sum = 0;
+    for(auto it = series.lower_bound(5000); it != series.end() && it->first < 6000; ++it) sum += it->second;
+    cout << "sum of [5000, 6000) is " << sum << endl;
+    cout << "bytes per entry " << double(series.memory_usage()) / series.size() << endl;
+
+    mystl::btree_set<string> s;
+    s.insert("pear");
+    s.insert("apple");
+    s.insert("fig");
+    s.insert("apple");
+    for(auto it = s.begin(); it != s.end(); ++it) cout << *it << " ";
+    cout << endl << "set size is " << s.size() << endl;
+
+    // 没有排好序的输入抛出异常，树保持为空
+    mystl::vector<int> unsorted;
+    for(int i = 0; i < 1000; i++) unsorted.push_back(i == 700 ? 3 : i);
+    mystl::btree_set<int> checked;
+    try {
+        checked.bulk_load(unsorted.begin(), unsorted.end());
+    } catch(const invalid_argument& e) {
+        cout << "invalid_argument: " << e.what() << ", size is " << checked.size() << endl;
+    }
+    checked.insert(42);
+    try {
+        mystl::btree_set<int> bad(unsorted);
+    } catch(const invalid_argument& e) {
+        cout << "ctor invalid_argument, checked size is " << checked.size() << endl;
+    }
+
+    // 拷贝中途抛出异常，已经拷贝的叶子被释放(由ASan检查泄漏)
+    mystl::btree_set<fragile_key> keys;
+    for(int i = 0; i < 2000; i++) keys.insert(fragile_key("key number " + to_string(i) + " with a heap buffer"));
+    for(int failAt : {1000, 1995, 2010}) {
+        fragile_key::copies = 0;
+        fragile_key::failAt = failAt;
+        try {
+            mystl::btree_set<fragile_key> copy(keys);
+        } catch(const runtime_error& e) {
+            cout << "copy failed at " << failAt << ": " << e.what() << endl;
+        }
+    }
+    fragile_key::failAt = 0;
+    mystl::btree_set<fragile_key> copy(keys);
+    cout << "copy size is " << copy.size() << " height is " << copy.height() << endl;
+}
@@ -0,0 +1,95 @@
+#include "../STL/concurrent_vector.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <string>
+
+
+using namespace std;
+
+// 构造第n个对象时抛出异常
+struct fragile {
+    static atomic<int> countdown;
+    int value;
+    explicit fragile(int v) : value(v) {
+        if(--countdown == 0) throw runtime_error("fragile");
+    }
+};
+atomic<int> fragile::countdown(0);
+
+int main() {
+    cout << "segment of 0 " << mystl::concurrent_vector<int>::segment_index(0)
+         << ", of 16 " << mystl::concurrent_vector<int>::segment_index(16)
+         << ", of 100 " << mystl::concurrent_vector<int>::segment_index(100)
+         << " base " << mystl::concurrent_vector<int>::segment_base(mystl::concurrent_vector<int>::segment_index(100)) << endl;
+
+    // 多个线程同时追加，另一个线程同时读取已经构造好的元素
+    mystl::concurrent_vector<string> cv;
+    const int nthreads = 4;
+    const int perThread = 20000;
+    atomic<bool> done(false);
+    long seen = 0;
+    thread reader([&] {
+        while(!done.load()) {
+            size_t n = cv.size();
+            for(size_t i = 0; i < n; i += 97) {
+                if(cv.ready(i)) seen += static_cast<long>(cv[i].size());
+            }
+        }
+    });
+    vector<thread> writers;
+    for(int t = 0; t < nthreads; t++) {
+        writers.emplace_back([&cv, t, perThread] {
+            for(int i = 0; i < perThread; i++) {
+                if(i % 100 == 0) cv.grow_by(10, string("batch"));
+                else cv.push_back("t" + to_string(t) + ":" + to_string(i));
+            }
+        });
+    }
+    const string* first = nullptr;
+    while(cv.size() == 0) this_thread::yield();
+    while(!cv.ready(0)) this_thread::yield();
+    first = &cv[0];
+    for(auto& w : writers) w.join();
+    done = true;
+    reader.join();
+
+    size_t expected = nthreads * (perThread / 100 * 109);
+    size_t batches = 0;
+    cv.for_each_segment([&](string* p, size_t n) {
+        for(size_t i = 0; i < n; i++) if(p[i] == "batch") batches++;
+    });
+    cout << "size " << cv.size() << " expected " << expected << " batches " << batches
+         << " capacity " << cv.capacity() << endl;
+    cout << "address stable " << (first == &cv[0]) << " reader saw something " << (seen > 0) << endl;
+
+    // 构造失败的位置不可用，其他位置不受影响
+    mystl::concurrent_vector<fragile> fv;
+    fragile::countdown = 3;
+    fv.emplace_back(1);
+    fv.emplace_back(2);
+    try {
+        fv.emplace_back(3);
+    } catch(const runtime_error& e) {
+        cout << "exception " << e.what() << endl;
+    }
+    fv.emplace_back(4);
+    cout << "ready " << fv.ready(0) << fv.ready(1) << fv.ready(2) << fv.ready(3)
+         << " value[3] " << fv[3].value << endl;
+    try {
+        fv.at(2);
+    } catch(const out_of_range& e) {
+        cout << "out_of_range: " << e.what() << endl;
+    }
+
+    mystl::concurrent_vector<int> iv;
+    iv.reserve(100);
+    vector<int> src = {1, 2, 3, 4, 5};
+    size_t at = iv.grow_by(src.begin(), src.end());
+    iv.grow_to_at_least(8, -1);
+    cout << "grow_by at " << at << " size " << iv.size() << " iv[7] " << iv[7] << " capacity " << iv.capacity() << endl;
+    iv.clear();
+    cout << "after clear size " << iv.size() << endl;
+}
@@ -0,0 +1,102 @@
+// 用 -std=c++20 编译时查找表在编译期算好，放在.rodata中；更低的标准下只测试fixed_vector的运行期行为
+#include "../STL/vector.h"
+#include "../STL/fixed_vector.h"
+
+#include <iostream>
+#include <stdint.h>
+
+
+using namespace std;
+
+struct token {
+    int kind;
+    int weight;
+    MYSTL_CONSTEXPR14 token() : kind(0), weight(0) {}
+    constexpr token(int k, int w) : kind(k), weight(w) {}
+    constexpr bool operator==(const token& rhs) const { return kind == rhs.kind && weight == rhs.weight; }
+};
+
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+
+constexpr mystl::vector<uint32_t> crc32_table() {
+    mystl::vector<uint32_t> table;
+    table.reserve(16);  // 后面的push_back会扩容几次
+    for(uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for(int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table.push_back(c);
+    }
+    return table;
+}
+
+// 字符分类：数字1，字母2，其他0；erase/pop_back/拷贝也可以在编译期使用
+constexpr mystl::vector<token> char_classes() {
+    mystl::vector<token> classes(128, token(0, 0));
+    for(int c = 0; c < 128; c++) {
+        if(c >= '0' && c <= '9') classes[c] = token(1, c - '0');
+        else if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) classes[c] = token(2, c);
+    }
+    mystl::vector<token> copy = classes;
+    copy.erase(copy.begin(), copy.begin() + 32);
+    copy.pop_back();
+    classes = copy;
+    return classes;
+}
+
+static constexpr auto crcTable = mystl::make_fixed_vector<256>(crc32_table);
+static constexpr auto classTable = mystl::make_fixed_vector<128>(char_classes);
+
+static_assert(crcTable.size() == 256, "crc table size");
+static_assert(crcTable[1] == 0x77073096u, "crc table value");
+static_assert(classTable.size() == 95, "class table size");
+static_assert(classTable['7' - 32].kind == 1 && classTable['7' - 32].weight == 7, "class table value");
+
+constexpr size_t vector_ops() {
+    mystl::vector<int> vec;
+    for(int i = 0; i < 100; i++) vec.emplace_back(i);
+    vec.erase(vec.begin() + 10, vec.begin() + 20);
+    vec.erase(vec.begin());
+    mystl::vector<int> other(std::move(vec));
+    other.swap(vec);
+    vec.assign(5, 1);
+    return vec.size() + other.capacity();
+}
+static_assert(vector_ops() == 5 + 0, "constexpr vector operations");
+
+static uint32_t crc32(const char* s, size_t n) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for(size_t i = 0; i < n; i++) crc = crcTable[(crc ^ static_cast<uint8_t>(s[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+#endif
+
+int main() {
+    mystl::fixed_vector<token, 8> fv;
+    fv.push_back(token(1, 2));
+    fv.emplace_back(3, 4);
+    fv.resize(4, token(9, 9));
+    cout << "size " << fv.size() << " capacity " << fv.capacity() << " back " << fv.back().kind << endl;
+    fv.pop_back();
+    mystl::fixed_vector<token, 8> copy(fv.begin(), fv.end());
+    cout << "equal " << (copy == fv) << endl;
+    try {
+        fv.resize(9);
+    } catch(const std::length_error& e) {
+        cout << "length_error: " << e.what() << endl;
+    }
+    try {
+        fv.at(5);
+    } catch(const std::out_of_range& e) {
+        cout << "out_of_range: " << e.what() << endl;
+    }
+    mystl::fixed_vector<int, 4> small = {1, 2, 3};
+    for(auto x : small) cout << x << " ";
+    cout << endl;
+
+#if MYSTL_HAS_CONSTEXPR_VECTOR
+    const char msg[] = "123456789";
+    cout << hex << "crc32 " << crc32(msg, sizeof(msg) - 1) << dec << endl;   // cbf43926
+    cout << "class of 'x' " << classTable['x' - 32].kind << endl;
+#endif
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <deque>
+#include <stdexcept>
 
 
 using namespace std;
@@ -19,6 +20,34 @@ void print_deque(const mystl::deque<T>& deq) {
     }
 }
 
+// 统计拷贝和移动的次数
+struct message {
+    static int copies;
+    static int moves;
+    string body;
+    message(const string& s) : body(s) {}
+    message(const message& rhs) : body(rhs.body) { ++copies; }
+    message(message&& rhs) noexcept : body(std::move(rhs.body)) { ++moves; }
+};
+int message::copies = 0;
+int message::moves = 0;
+
+// 移动构造可能抛出异常，countdown 减到0时拷贝/移动抛出异常，live 记录存活的对象个数
+struct fragile {
+    static int live;
+    static int countdown;
+    int value;
+    explicit fragile(int v) : value(v) { ++live; }
+    fragile(const fragile& rhs) : value(rhs.value) { tick(); ++live; }
+    fragile(fragile&& rhs) : value(rhs.value) { tick(); ++live; }
+    fragile& operator=(const fragile& rhs) { tick(); value = rhs.value; return *this; }
+    fragile& operator=(fragile&& rhs) { tick(); value = rhs.value; return *this; }
+    ~fragile() { --live; }
+    static void tick() { if(countdown > 0 && --countdown == 0) throw std::runtime_error("fragile"); }
+};
+int fragile::live = 0;
+int fragile::countdown = 0;
+
 int main() {
     mystl::deque<int> deq1(5, 9);
     print_deque(deq1);
@@ -41,6 +70,75 @@ int main() {
     deq4.push_front("Cpp yyds!");
     print_deque(deq4);
     
+    cout << "insert !" << endl;
+    deq4.insert(deq4.begin() + 2, "Inserted");
+    deq4.insert(deq4.end() - 1, 2, "Twice");
+    string arr[] = {"a", "b", "c"};
+    deq4.insert(deq4.begin() + 1, arr, arr + 3);
+    deq4.emplace(deq4.begin(), 3, 'z');
+    deq4.emplace_back("Emplace back");
+    deq4.emplace_front("Emplace front");
+    print_deque(deq4);
+
+    // 入队和中间插入都不会拷贝
+    mystl::deque<message> queue;
+    for(int i = 0; i < 1000; i++) queue.emplace_back("message " + to_string(i));
+    queue.push_front(message("first"));
+    queue.insert(queue.begin() + 10, message("tenth"));
+    queue.erase(queue.begin() + 5, queue.begin() + 8);
+    cout << "queue size " << queue.size() << " copies " << message::copies
+         << " moves " << message::moves << endl;
+
+    // 流量高峰之后收缩map和缓冲区
+    mystl::deque<int> spike;
+    for(int i = 0; i < 100000; i++) spike.push_back(i);
+    cout << "peak map capacity " << spike.map_capacity() << " blocks " << spike.block_count() << endl;
+    while(spike.size() > 100) spike.pop_front();
+    spike.shrink_to_fit();
+    cout << "after shrink_to_fit map capacity " << spike.map_capacity() << " blocks " << spike.block_count()
+         << " front " << spike[0] << endl;
+
+    // 批量追加，按缓冲区整块拷贝
+    mystl::deque<int> batch;
+    batch.reserve_back(1000);
+    cout << "after reserve_back blocks " << batch.block_count() << endl;
+    int nums[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    batch.append(nums, nums + 8);
+    batch.prepend(nums, nums + 3);
+    batch.resize(14, -1);
+    print_deque(batch);
+    batch.assign(nums + 4, nums + 8);
+    print_deque(batch);
+    batch.assign(3, 0);
+    print_deque(batch);
+
+    // 中间插入/删除时元素的移动抛出异常，deque 里不会留下未构造的位置
+    {
+        int failures = 0;
+        bool consistent = true;
+        for(int trial = 1; trial < 400; trial += 7) {
+            {
+                mystl::deque<fragile> fq;
+                for(int i = 0; i < 300; i++) fq.emplace_back(i);
+                fragile::countdown = trial;
+                try {
+                    fq.insert(fq.begin() + (trial % 2 ? 40 : 260), 3, fragile(-1));
+                    fq.erase(fq.begin() + (trial % 3 ? 20 : 250), fq.begin() + (trial % 3 ? 30 : 260));
+                    fq.emplace(fq.begin() + 100, -2);
+                } catch(const std::runtime_error&) {
+                    ++failures;
+                }
+                fragile::countdown = 0;
+                consistent = consistent && fragile::live == static_cast<int>(fq.size());
+                long sum = 0;
+                for(auto it = fq.begin(); it != fq.end(); ++it) sum += (*it).value;
+                (void)sum;
+            }
+            consistent = consistent && fragile::live == 0;
+        }
+        cout << "throwing moves: failures " << (failures > 0) << " consistent " << consistent << endl;
+    }
+
     cout << "clear !" << endl;
     deq4.clear();
     cout << "after clear deq4 size is " << deq4.size() << endl;
@@ -0,0 +1,43 @@
+#include "../STL/dynamic_bitset.h"
+
+#include <iostream>
+
+
+using namespace std;
+
+void print_bitset(const mystl::dynamic_bitset& bs) {
+    cout << "size is " << bs.size() << " count is " << bs.count() << endl;
+    for(size_t i = 0; i < bs.size(); i++) cout << bs[i];
+    cout << endl;
+}
+
+int main() {
+    mystl::dynamic_bitset a(70);
+    mystl::dynamic_bitset b(70, true);
+    a.set(1).set(3).set(64).set(69);
+    print_bitset(a);
+    b.reset(3);
+    print_bitset(b);
+
+    mystl::dynamic_bitset c = a & b;
+    print_bitset(c);
+    c = a | b;
+    print_bitset(c);
+    c = a ^ b;
+    print_bitset(c);
+    c = a;
+    c.andnot(b);
+    print_bitset(c);
+
+    cout << "set bits of a:";
+    for(size_t i = a.find_first(); i != mystl::dynamic_bitset::npos; i = a.find_next(i))
+        cout << " " << i;
+    cout << endl;
+
+    a.build_rank_index();
+    cout << "rank(64) = " << a.rank(64) << " select(2) = " << a.select(2) << endl;
+
+    a.resize(80, true);
+    a.push_back(false);
+    print_bitset(a);
+}
@@ -0,0 +1,47 @@
+#include "../STL/hive.h"
+#include "../STL/vector.h"
+
+#include <iostream>
+#include <string>
+
+
+using namespace std;
+
+template<typename T>
+void print_hive(const mystl::hive<T>& h) {
+    cout << "hive size is " << h.size() << " blocks " << h.block_count() << endl;
+    for(auto it = h.begin(); it != h.end(); ++it)
+        cout << *it << " ";
+    cout << endl;
+}
+
+int main() {
+    mystl::hive<int> h;
+    mystl::vector<int*> addr;
+    for(int i = 0; i < 20; i++) addr.push_back(&*h.insert(i));
+    print_hive(h);
+
+    // 删除偶数，其余元素的地址不变
+    for(auto it = h.begin(); it != h.end();) {
+        if(*it % 2 == 0) it = h.erase(it);
+        else ++it;
+    }
+    print_hive(h);
+    cout << "address of 7 unchanged: " << (addr[7] == &*h.get_iterator(addr[7])) << endl;
+    int outside = 0;
+    cout << "erased 8 gives end: " << (h.get_iterator(addr[8]) == h.end())
+         << " outside gives end: " << (h.get_iterator(&outside) == h.end()) << endl;
+
+    // 新元素复用被删除的位置
+    h.insert(100);
+    h.insert(200);
+    print_hive(h);
+
+    mystl::hive<string> sh(3, "Hello");
+    auto it = sh.insert("my tiny STL");
+    sh.erase(sh.begin());
+    print_hive(sh);
+    cout << "it still points to " << *it << endl;
+    sh.clear();
+    cout << "after clear size is " << sh.size() << endl;
+}
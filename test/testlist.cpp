@@ -0,0 +1,122 @@
+#include "../STL/list.h"
+
+#include <iostream>
+#include <string>
+
+
+using namespace std;
+
+// 连接对象同时挂在两个侵入式链表上：全部连接 和 LRU
+struct Connection : public mystl::list_hook {
+    int                 fd;
+    mystl::list_hook    lru;
+    explicit Connection(int f) : fd(f) {}
+};
+
+typedef mystl::intrusive_list<Connection>                                           connList;
+typedef mystl::intrusive_list<Connection, mystl::member_hook<Connection, &Connection::lru>> lruList;
+
+// 第 failAt 次拷贝时抛出异常
+struct throwing_copy {
+    static int copies;
+    static int failAt;
+    string name;
+    throwing_copy(const char* n) : name(n) {}
+    throwing_copy(const throwing_copy& rhs) : name(rhs.name) {
+        if(++copies == failAt) throw runtime_error("copy failed");
+    }
+};
+int throwing_copy::copies = 0;
+int throwing_copy::failAt = 0;
+
+struct alignas(128) wide {
+    int value;
+    explicit wide(int v) : value(v) {}
+};
+
+template<typename List>
+void print(const List& l) {
+    for(auto it = l.begin(); it != l.end(); ++it) cout << *it << " ";
+    cout << endl;
+}
+
+int main() {
+    mystl::list<string> lst = {"Hello,", "world!"};
+    lst.push_back("This is");
+    lst.emplace_back("my tiny STL!");
+    lst.push_front("Cpp yyds!");
+    print(lst);
+    cout << "lst size is " << lst.size() << endl;
+
+    lst.pop_front();
+    lst.erase(++lst.begin());
+    print(lst);
+
+    // splice整个链表，O(1)
+    mystl::list<string> other(2, "Happy 1024!");
+    lst.splice(lst.begin(), other);
+    print(lst);
+    cout << "other size is " << other.size() << endl;
+
+    // 链表内部移动：把最后一个元素移到最前
+    lst.splice(lst.begin(), lst, --lst.end());
+    print(lst);
+
+    mystl::list<string> a = {"apple", "cherry", "grape"};
+    mystl::list<string> b = {"banana", "date", "fig"};
+    a.merge(b);
+    print(a);
+    a.reverse();
+    print(a);
+
+    // 侵入式链表，不申请内存
+    Connection conns[] = {Connection(3), Connection(4), Connection(5), Connection(6)};
+    connList all;
+    lruList  lru;
+    for(auto& c : conns) {
+        all.push_back(c);
+        lru.push_front(c);
+    }
+    // 连接5有新数据，移到LRU头部
+    lru.splice(lru.begin(), lru, lru.iterator_to(conns[2]));
+    // 连接4关闭，O(1)从两个链表上摘下
+    all.erase(conns[1]);
+    lru.erase(conns[1]);
+    cout << "all:";
+    for(auto& c : all) cout << " " << c.fd;
+    cout << endl << "lru:";
+    for(auto& c : lru) cout << " " << c.fd;
+    cout << endl;
+    all.clear();
+    lru.clear();
+
+    // 构造时元素拷贝抛出异常，已经构造的结点被释放(由ASan检查泄漏)
+    {
+        throwing_copy src[] = {"first element with a long name", "second element with a long name", "third"};
+        throwing_copy::copies = 0;
+        throwing_copy::failAt = 3;
+        try {
+            mystl::list<throwing_copy> l(src, src + 3);
+        } catch(const runtime_error& e) {
+            cout << "range ctor: " << e.what() << endl;
+        }
+        mystl::list<throwing_copy> ok(src, src + 2);
+        throwing_copy::copies = 0;
+        try {
+            mystl::list<throwing_copy> copy(ok);
+            mystl::list<throwing_copy> again(copy);
+        } catch(const runtime_error& e) {
+            cout << "copy ctor: " << e.what() << endl;
+        }
+        throwing_copy::failAt = 0;
+    }
+
+    // 对齐超过 operator new 保证的结点
+    mystl::list<wide> wl;
+    bool aligned = true;
+    for(int i = 0; i < 100; i++) {
+        wl.emplace_back(i);
+        aligned = aligned && reinterpret_cast<size_t>(&wl.back()) % 128 == 0;
+    }
+    cout << "over-aligned nodes aligned " << aligned << " back " << wl.back().value << endl;
+}
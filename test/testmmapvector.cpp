@@ -0,0 +1,63 @@
+#include "../STL/mmap_vector.h"
+
+#include <iostream>
+#include <unistd.h>
+
+
+using namespace std;
+
+struct point {
+    int x;
+    int y;
+};
+
+int main() {
+    const char* path = "/tmp/mystl_testmmapvector.bin";
+    {
+        mystl::mmap_vector<point> vec(path, mystl::mmap_mode::truncate);
+        cout << "capacity " << vec.capacity() << " size " << vec.size() << endl;
+        for(int i = 0; i < 10; i++) vec.push_back(point{i, i * i});
+        vec.emplace_back(point{100, 200});
+        cout << "capacity " << vec.capacity() << " size " << vec.size() << endl;
+        vec.append(vec.begin(), vec.begin() + 3);   // 追加自己的元素
+        vec.resize(20, point{-1, -1});
+        vec.pop_back();
+        vec.flush();
+        cout << "capacity " << vec.capacity() << " size " << vec.size() << endl;
+        vec.shrink_to_fit();
+        cout << "after shrink capacity " << vec.capacity() << endl;
+    }
+
+    // 重新以只读方式打开，数据还在
+    mystl::mmap_vector<point> ro(path, mystl::mmap_mode::read_only);
+    ro.advise(mystl::mmap_advice::sequential);
+    cout << "reopen size " << ro.size() << " writable " << ro.is_writable() << endl;
+    // const 对象只能拿到 const 指针
+    const mystl::mmap_vector<point>& cro = ro;
+    static_assert(std::is_same<decltype(cro.data()), const point*>::value, "const data() must be const");
+    static_assert(std::is_same<decltype(cro.begin()), const point*>::value, "const begin() must be const");
+    for(auto it = cro.begin(); it != cro.end(); ++it) cout << "(" << it->x << "," << it->y << ") ";
+    cout << endl;
+    cout << "front " << ro.front().x << " back " << ro.back().x << " at(10) " << ro.at(10).y << endl;
+    try {
+        ro.at(100);
+    } catch(const std::out_of_range& e) {
+        cout << "out_of_range: " << e.what() << endl;
+    }
+
+    // 元素大小不同的类型不能打开这个文件
+    try {
+        mystl::mmap_vector<char> bad(path, mystl::mmap_mode::read_only);
+    } catch(const std::runtime_error& e) {
+        cout << "runtime_error: " << e.what() << endl;
+    }
+
+    // 继续追加，随机访问
+    mystl::mmap_vector<point> rw(path);
+    rw.advise(mystl::mmap_advice::random);
+    for(int i = 0; i < 100000; i++) rw.push_back(point{i, -i});
+    rw.advise(mystl::mmap_advice::willneed, 1000, 5000);
+    cout << "size " << rw.size() << " capacity " << rw.capacity() << " rw[50019].y " << rw[50019].y << endl;
+    rw.flush(true);
+    unlink(path);
+}
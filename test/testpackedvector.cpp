@@ -0,0 +1,92 @@
+#include "../STL/packed_vector.h"
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+
+using namespace std;
+
+int main() {
+    // 每种位宽打包再解包，结果不变
+    bool roundTrip = true;
+    for(unsigned w = 0; w <= 64; w++) {
+        uint64_t in[64], packed[65], out[64];
+        for(int j = 0; j < 64; j++) in[j] = (uint64_t(j) * 0x9E3779B97F4A7C15ull) & mystl::packed_mask(w);
+        mystl::packed_pack(w, in, packed);
+        mystl::packed_unpack(w, packed, out);
+        for(int j = 0; j < 64; j++) roundTrip = roundTrip && in[j] == out[j];
+    }
+    cout << "pack/unpack round trip for widths 0..64 " << roundTrip << endl;
+
+    // push_back 时位宽自动加宽
+    mystl::packed_vector pv(3);
+    for(uint64_t i = 0; i < 200; i++) pv.push_back(i % 8);
+    cout << "width " << pv.bit_width() << " size " << pv.size() << " pv[13] " << pv[13];
+    pv.push_back(1000);
+    cout << " -> width " << pv.bit_width() << " pv[13] " << pv[13] << " back " << pv.back() << endl;
+    pv.set(5, uint64_t(1) << 40);
+    cout << "after set width " << pv.bit_width() << " pv[5] " << pv[5] << " pv[6] " << pv[6] << endl;
+
+    // 批量追加和顺序解码
+    srand(7);
+    vector<uint64_t> ids(100003);
+    for(auto& x : ids) x = static_cast<uint64_t>(rand() % 100000);
+    mystl::packed_vector packed(ids.data(), ids.data() + ids.size());
+    vector<uint64_t> decoded(ids.size());
+    size_t n = packed.decode(0, ids.size(), decoded.data());
+    bool same = n == ids.size() && decoded == ids;
+    vector<uint64_t> part(1000);
+    n = packed.decode(12345, 1000, part.data());
+    for(size_t i = 0; i < n; i++) same = same && part[i] == ids[12345 + i];
+    for(size_t i = 0; i < ids.size(); i += 997) same = same && packed[i] == ids[i];
+    cout << "ids width " << packed.bit_width() << " bytes " << packed.memory_bytes()
+         << " vs " << ids.size() * sizeof(uint64_t) << " same " << same
+         << " decode past end " << packed.decode(ids.size() - 3, 10, part.data()) << endl;
+    try {
+        packed.at(ids.size());
+    } catch(const out_of_range& e) {
+        cout << "out_of_range: " << e.what() << endl;
+    }
+
+    // 有序序列：差分编码
+    vector<uint64_t> stamps;
+    uint64_t t = 1700000000000ull;
+    for(int i = 0; i < 100000; i++) {
+        t += static_cast<uint64_t>(rand() % 50);
+        stamps.push_back(t);
+    }
+    mystl::sorted_packed_vector sorted(stamps.data(), stamps.data() + stamps.size());
+    same = true;
+    for(size_t i = 0; i < stamps.size(); i += 13) same = same && sorted[i] == stamps[i];
+    vector<uint64_t> out(stamps.size());
+    n = sorted.decode(0, stamps.size(), out.data());
+    same = same && n == stamps.size() && out == stamps;
+    n = sorted.decode(99990, 100, out.data());
+    for(size_t i = 0; i < n; i++) same = same && out[i] == stamps[99990 + i];
+    cout << "sorted bytes " << sorted.memory_bytes() << " vs " << stamps.size() * sizeof(uint64_t)
+         << " same " << same << " tail decode " << n << endl;
+
+    // lower_bound 和 std::lower_bound 一致
+    bool bounds = true;
+    for(int k = 0; k < 2000; k++) {
+        uint64_t probe = stamps.front() - 10 + static_cast<uint64_t>(rand()) % (stamps.back() - stamps.front() + 20);
+        size_t expect = static_cast<size_t>(std::lower_bound(stamps.begin(), stamps.end(), probe) - stamps.begin());
+        bounds = bounds && sorted.lower_bound(probe) == expect;
+    }
+    bounds = bounds && sorted.lower_bound(stamps[64]) == size_t(std::lower_bound(stamps.begin(), stamps.end(), stamps[64]) - stamps.begin());
+    cout << "lower_bound matches " << bounds << " contains " << sorted.contains(stamps[777])
+         << sorted.contains(stamps.back() + 1) << endl;
+
+    try {
+        sorted.push_back(1);
+    } catch(const invalid_argument& e) {
+        cout << "invalid_argument: " << e.what() << endl;
+    }
+
+    // 全部相同的值，差值位宽为0
+    mystl::sorted_packed_vector flat;
+    for(int i = 0; i < 130; i++) flat.push_back(42);
+    cout << "flat " << flat[0] << " " << flat[100] << " " << flat[129] << " lower_bound(42) " << flat.lower_bound(42)
+         << " lower_bound(43) " << flat.lower_bound(43) << endl;
+}
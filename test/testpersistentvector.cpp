@@ -0,0 +1,43 @@
+#include "../STL/persistent_vector.h"
+
+#include <iostream>
+#include <string>
+
+
+using namespace std;
+
+template<typename T>
+void print_pvector(const mystl::persistent_vector<T>& vec) {
+    cout << "size is " << vec.size() << endl;
+    for(auto it = vec.begin(); it != vec.end(); ++it)
+        cout << *it << " ";
+    cout << endl;
+}
+
+int main() {
+    mystl::persistent_vector<int> vec;
+    for(int i = 0; i < 100; i++) vec.push_back(i);
+    // 快照只增加引用计数
+    mystl::persistent_vector<int> snap(vec);
+    vec.set(0, -1);
+    vec.set(99, -99);
+    vec.pop_back();
+    cout << "vec[0] = " << vec[0] << " snap[0] = " << snap[0] << endl;
+    cout << "vec size " << vec.size() << " snap size " << snap.size() << endl;
+
+    // transient 批量修改
+    mystl::transient_vector<int> t = snap.transient();
+    for(int i = 0; i < 2000; i++) t.push_back(i);
+    mystl::persistent_vector<int> big = t.persistent();
+    cout << "big size " << big.size() << " big[2099] = " << big[2099] << endl;
+    while(big.size() > 10) big.pop_back();
+    print_pvector(big);
+
+    mystl::persistent_vector<string> strVec;
+    strVec.push_back("Hello");
+    strVec.push_back("world");
+    mystl::persistent_vector<string> strSnap = strVec;
+    strVec.set(1, "my tiny STL");
+    print_pvector(strVec);
+    print_pvector(strSnap);
+}
@@ -0,0 +1,190 @@
+#include "../STL/memory_resource.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+
+// 记录经过自己的申请次数和当前未释放的字节数，其余交给上游
+class counting_resource : public mystl::pmr::memory_resource {
+public:
+    explicit counting_resource(mystl::pmr::memory_resource* up = mystl::pmr::new_delete_resource())
+        : upstream(up) {}
+    size_t allocations = 0;
+    long outstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        outstanding += static_cast<long>(bytes);
+        return upstream->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        outstanding -= static_cast<long>(bytes);
+        upstream->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override { return &other == this; }
+
+    mystl::pmr::memory_resource* upstream;
+};
+
+int main() {
+    cout << "sizeof vector " << sizeof(mystl::vector<int>) << " pmr::vector " << sizeof(mystl::pmr::vector<int>) << endl;
+
+    // 栈上的缓冲区够用时不会向上游申请
+    {
+        counting_resource upstream;
+        alignas(16) char buffer[4096];
+        mystl::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+        mystl::pmr::vector<int> v(&arena);
+        for(int i = 0; i < 100; i++) v.push_back(i);
+        bool inBuffer = reinterpret_cast<char*>(v.data()) >= buffer &&
+                        reinterpret_cast<char*>(v.data()) < buffer + sizeof(buffer);
+        cout << "arena: in buffer " << inBuffer << " upstream allocations " << upstream.allocations << endl;
+        for(int i = 0; i < 2000; i++) v.push_back(i);
+        cout << "arena grown: upstream allocations " << upstream.allocations << " back " << v.back() << endl;
+        arena.release();
+        cout << "after release outstanding " << upstream.outstanding << endl;
+    }
+
+    // 嵌套的容器通过 uses-allocator 构造使用外层的资源
+    {
+        counting_resource counter;
+        mystl::pmr::vector<mystl::pmr::vector<int>> outer(&counter);
+        outer.emplace_back();
+        outer.emplace_back(size_t(3), 7);
+        mystl::pmr::vector<int> fromDefault(size_t(5), 1);
+        outer.push_back(fromDefault);
+        outer[0].push_back(42);
+        bool same = true;
+        for(auto& inner : outer) same = same && inner.get_allocator().resource() == &counter;
+        cout << "nested share resource " << same << " default resource untouched "
+             << (fromDefault.get_allocator().resource() == mystl::pmr::get_default_resource()) << endl;
+
+        // 拷贝构造的容器用默认资源，带分配器的拷贝用指定的资源
+        mystl::pmr::vector<mystl::pmr::vector<int>> copy(outer);
+        mystl::pmr::vector<mystl::pmr::vector<int>> copyHere(outer, &counter);
+        cout << "copy uses default " << (copy.get_allocator().resource() == mystl::pmr::get_default_resource())
+             << " inner " << (copy[1].get_allocator().resource() == mystl::pmr::get_default_resource())
+             << ", copyHere inner " << (copyHere[1].get_allocator().resource() == &counter)
+             << " value " << copyHere[1][2] << endl;
+
+        // 资源不同的移动赋值只能逐个移动元素
+        mystl::pmr::vector<int> other(size_t(4), 9);
+        outer[0] = std::move(other);
+        cout << "move across resources: size " << outer[0].size() << " resource kept "
+             << (outer[0].get_allocator().resource() == &counter) << endl;
+
+        mystl::pmr::deque<mystl::pmr::vector<int>> dq(&counter);
+        for(int i = 0; i < 300; i++) dq.emplace_back(size_t(2), i);
+        mystl::pmr::stack<int> st(&counter);
+        for(int i = 0; i < 1000; i++) st.push(i);
+        mystl::pmr::vector<mystl::pmr::stack<int>> stacks(&counter);
+        stacks.emplace_back();
+        stacks[0].push(5);
+        cout << "deque inner resource " << (dq[299].get_allocator().resource() == &counter)
+             << " dq[299][1] " << dq[299][1] << " stack top " << st.top() << " nested stack top " << stacks[0].top() << endl;
+    }
+
+    // 外层扩容时内层的 deque/stack 被移动而不是拷贝，资源不变
+    {
+        counting_resource counter;
+        mystl::pmr::vector<mystl::pmr::deque<int>> deques(&counter);
+        mystl::pmr::vector<mystl::pmr::stack<int>> stacks(&counter);
+        for(int i = 0; i < 20; i++) {
+            deques.emplace_back();
+            deques.back().push_back(i);
+            stacks.emplace_back();
+            stacks.back().push(i);
+        }
+        bool same = true;
+        int values = 0;
+        for(auto& d : deques) {
+            same = same && d.get_allocator().resource() == &counter;
+            values += d[0];
+        }
+        cout << "after reallocations inner deques on resource " << same << " values " << values
+             << " capacity " << deques.capacity() << " stack top " << stacks[19].top() << endl;
+
+        // 移动赋值：资源相同时接管缓冲区，不同时逐个移动元素；被移动的deque还可以继续使用
+        mystl::pmr::deque<int> src(&counter);
+        for(int i = 0; i < 1000; i++) src.push_back(i);
+        const size_t before = counter.allocations;
+        deques[0] = std::move(src);
+        cout << "same resource move allocations " << counter.allocations - before << " size " << deques[0].size()
+             << " moved-from size " << src.size() << endl;
+        src.push_back(7);
+        src.push_front(6);
+        mystl::pmr::deque<int> elsewhere(size_t(3), 1);
+        deques[1] = std::move(elsewhere);
+        cout << "moved-from reuse " << src[0] << src[src.size() - 1] << " cross resource move size " << deques[1].size()
+             << " resource kept " << (deques[1].get_allocator().resource() == &counter) << endl;
+    }
+
+    // 池：释放的块被复用，不会再向上游申请
+    {
+        counting_resource upstream;
+        mystl::pmr::pool_options opts;
+        opts.largest_required_pool_block = 1000;
+        mystl::pmr::unsynchronized_pool_resource pool(opts, &upstream);
+        cout << "pool largest block " << pool.options().largest_required_pool_block
+             << " max blocks " << pool.options().max_blocks_per_chunk << endl;
+        for(int round = 0; round < 3; round++) {
+            mystl::pmr::deque<int> q(&pool);
+            for(int i = 0; i < 10000; i++) q.push_back(i);
+            while(q.size() > 10) q.pop_front();
+            if(round == 0) cout << "after first round upstream allocations " << upstream.allocations << endl;
+        }
+        cout << "after three rounds upstream allocations " << upstream.allocations << endl;
+        void* big = pool.allocate(100000, 64);
+        cout << "oversized aligned " << (reinterpret_cast<size_t>(big) % 64 == 0) << endl;
+        pool.deallocate(big, 100000, 64);
+        void* aligned = pool.allocate(24, 256);
+        cout << "pooled aligned " << (reinterpret_cast<size_t>(aligned) % 256 == 0) << endl;
+        pool.deallocate(aligned, 24, 256);
+        pool.release();
+        cout << "pool after release outstanding " << upstream.outstanding << endl;
+    }
+
+    // 多个线程共享一个加锁的池
+    {
+        mystl::pmr::synchronized_pool_resource shared;
+        vector<thread> workers;
+        vector<long> sums(4);
+        for(int t = 0; t < 4; t++) {
+            workers.emplace_back([&shared, &sums, t] {
+                for(int r = 0; r < 100; r++) {
+                    mystl::pmr::vector<mystl::pmr::vector<int>> v(&shared);
+                    for(int i = 0; i < 50; i++) v.emplace_back(size_t(i % 7 + 1), i);
+                    sums[t] += static_cast<long>(v.size()) + v[49][0];
+                }
+            });
+        }
+        for(auto& w : workers) w.join();
+        cout << "synchronized pool sums " << sums[0] << " " << sums[1] << " " << sums[2] << " " << sums[3] << endl;
+    }
+
+    // 替换默认资源
+    {
+        mystl::pmr::monotonic_buffer_resource arena;
+        mystl::pmr::memory_resource* old = mystl::pmr::set_default_resource(&arena);
+        mystl::pmr::vector<int> v;
+        v.push_back(1);
+        cout << "default replaced " << (v.get_allocator().resource() == &arena) << endl;
+        mystl::pmr::set_default_resource(old);
+    }
+
+    // null_memory_resource 作为上游，缓冲区用完就抛出异常
+    {
+        char buffer[64];
+        mystl::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), mystl::pmr::null_memory_resource());
+        mystl::pmr::vector<char> v(&arena);
+        try {
+            for(int i = 0; i < 1000; i++) v.push_back('x');
+        } catch(const std::bad_alloc&) {
+            cout << "bad_alloc at size " << v.size() << endl;
+        }
+    }
+}
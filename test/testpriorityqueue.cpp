@@ -0,0 +1,44 @@
+#include "../STL/priority_queue.h"
+
+#include <iostream>
+#include <string>
+#include <functional>
+
+
+using namespace std;
+
+int main() {
+    // 默认4叉大顶堆
+    mystl::priority_queue<int> pq;
+    int data[] = {5, 1, 9, 3, 7, 2, 8};
+    pq.push_range(data, data + 7);
+    pq.push(6);
+    pq.emplace(4);
+    cout << "size is " << pq.size() << " top is " << pq.top() << endl;
+    while(!pq.empty()) {
+        cout << pq.top() << " ";
+        pq.pop();
+    }
+    cout << endl;
+
+    // 8叉小顶堆
+    mystl::priority_queue<string, mystl::vector<string>, greater<string>, 8> spq;
+    spq.push("world");
+    spq.push("Hello");
+    spq.push("tiny STL");
+    while(!spq.empty()) {
+        cout << spq.top() << endl;
+        spq.pop();
+    }
+
+    // 定时器：带句柄的小顶堆，decrease_key 提前到期时间
+    mystl::indexed_priority_queue<int, greater<int>> timers;
+    size_t t1 = timers.push(100);
+    size_t t2 = timers.push(50);
+    size_t t3 = timers.push(80);
+    timers.decrease_key(t1, 10);
+    timers.erase(t3);
+    cout << "top handle " << timers.top_handle() << " (t1 = " << t1 << ") expires at " << timers.top() << endl;
+    timers.pop();
+    cout << "then handle " << timers.top_handle() << " (t2 = " << t2 << ") expires at " << timers.top() << endl;
+}
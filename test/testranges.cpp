@@ -0,0 +1,120 @@
+#include "../STL/ranges.h"
+#include "../STL/vector.h"
+#include "../STL/deque.h"
+#include "../STL/list.h"
+
+#include <iostream>
+#include <string>
+
+
+using namespace std;
+
+struct is_odd {
+    bool operator()(int x) const { return x % 2 != 0; }
+};
+
+struct square {
+    long operator()(int x) const { return long(x) * x; }
+};
+
+struct by_reference {
+    const int& operator()(const int& x) const { return x; }
+};
+
+template<typename R>
+void print(const char* title, const R& r) {
+    cout << title;
+    for(auto it = r.begin(); it != r.end(); ++it) cout << " " << *it;
+    cout << endl;
+}
+
+template<typename Iter>
+const char* category_name(Iter) {
+    return mystl::is_random_access_iterator<Iter>::value ? "random_access" : "not random_access";
+}
+
+int main() {
+    mystl::vector<int> vec;
+    for(int i = 0; i < 20; i++) vec.push_back(i);
+
+    auto odd_squares = vec | mystl::views::filter(is_odd()) | mystl::views::transform(square());
+    print("odd squares:", odd_squares);
+
+    auto middle = vec | mystl::views::drop(5) | mystl::views::take(6);
+    print("drop 5 take 6:", middle);
+    cout << "distance " << mystl::distance(middle.begin(), middle.end())
+         << " " << category_name(middle.begin()) << endl;
+
+    // transform 返回值时只能是输入迭代器，仍然可以 O(1) 地相减和下标访问
+    auto strided = vec | mystl::views::stride(3) | mystl::views::transform(square());
+    print("stride 3 squared:", strided);
+    cout << "stride size " << (strided.end() - strided.begin()) << " strided[2] " << strided.begin()[2]
+         << " " << category_name(strided.begin()) << endl;
+
+    cout << "chunks of 6:";
+    for(auto c : vec | mystl::views::chunk(6)) {
+        cout << " [";
+        for(int x : c) cout << x << (x == *(c.end() - 1) ? "" : ",");
+        cout << "]";
+    }
+    cout << endl;
+
+    // deque 的迭代器也是随机访问
+    mystl::deque<int> dq;
+    for(int i = 0; i < 1000; i++) dq.push_back(i);
+    auto tail = mystl::make_subrange(dq.begin() + 990, dq.end()) | mystl::views::enumerate;
+    for(auto p : tail) cout << "(" << p.first << "," << p.second << ")";
+    cout << " " << category_name(tail.begin()) << endl;
+
+    // zip，长度取较短的，可以通过引用修改元素
+    mystl::vector<string> names;
+    names.push_back("a");
+    names.push_back("b");
+    names.push_back("c");
+    auto zipped = mystl::views::zip(names, dq);
+    cout << "zip size " << (zipped.end() - zipped.begin()) << ":";
+    for(auto p : zipped) {
+        p.second += 100;
+        cout << " " << p.first << "=" << p.second;
+    }
+    cout << " dq[0] " << dq[0] << endl;
+
+    // 物化：随机访问时只reserve一次
+    mystl::vector<long> out = vec | mystl::views::stride(2) | mystl::views::transform(square()) | mystl::to<mystl::vector>();
+    cout << "to<vector> size " << out.size() << " capacity " << out.capacity() << " back " << out.back() << endl;
+    mystl::deque<int> fromFilter = mystl::to<mystl::deque>(vec | mystl::views::filter(is_odd()));
+    cout << "to<deque> size " << fromFilter.size() << endl;
+
+    // list 是双向迭代器，视图退化成对应的分类，take/chunk/stride 仍然可以用
+    mystl::list<int> lst;
+    for(int i = 0; i < 10; i++) lst.push_back(i);
+    auto lv = lst | mystl::views::stride(4);
+    print("list stride 4:", lv);
+    print("list take 3:", lst | mystl::views::take(3));
+    // 没有 operator-- 的迭代器最多是前向的
+    auto lt = lst | mystl::views::take(3);
+    cout << "list take/stride forward "
+         << std::is_same<mystl::iterator_traits<decltype(lt.begin())>::iterator_category, mystl::forward_iterator_tag>::value
+         << std::is_same<mystl::iterator_traits<decltype(lv.begin())>::iterator_category, mystl::forward_iterator_tag>::value << endl;
+    // zip 两个长度不同的 list，不能从 end() 往回走，最多是前向的
+    mystl::list<int> shortList;
+    shortList.push_back(100);
+    shortList.push_back(200);
+    auto lz = mystl::views::zip(lst, shortList);
+    cout << "list zip forward "
+         << std::is_same<mystl::iterator_traits<decltype(lz.begin())>::iterator_category, mystl::forward_iterator_tag>::value
+         << " length " << mystl::distance(lz.begin(), lz.end()) << endl;
+    // 返回引用的 transform 保持底层的分类
+    cout << "transform by reference " << category_name((vec | mystl::views::transform(by_reference())).begin()) << endl;
+    cout << "list chunks:";
+    for(auto c : lst | mystl::views::chunk(4)) cout << " " << mystl::distance(c.begin(), c.end());
+    cout << endl;
+
+    // 右值容器被视图接管
+    mystl::vector<int> temp(5, 7);
+    auto owned = std::move(temp) | mystl::views::enumerate;
+    cout << "owned:";
+    for(auto p : mystl::views::zip(owned | mystl::views::transform([](std::pair<ptrdiff_t, int&> p) { return p.first; }), vec))
+        cout << " " << p.first << "+" << p.second;
+    cout << endl;
+}
@@ -0,0 +1,99 @@
+#include "../STL/serialize.h"
+
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+using namespace std;
+
+struct message {
+    int     id;
+    double  price;
+};
+
+// 平凡可拷贝，但默认构造不平凡
+struct tagged {
+    int id;
+    int tag;
+    tagged() : id(0), tag(7) {}
+    tagged(int i, int t) : id(i), tag(t) {}
+};
+
+int main() {
+    const char* path = "/tmp/mystl_testserialize.bin";
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) return 1;
+
+    // vector 和 deque 写到同一个文件
+    mystl::vector<int> vec;
+    for(int i = 0; i < 10; i++) vec.push_back(i * i);
+    mystl::deque<message> dq;
+    for(int i = 0; i < 1000; i++) dq.push_back(message{i, i * 0.5});
+    for(int i = 1; i <= 5; i++) dq.push_front(message{-i, -i * 0.5});
+    mystl::serialize(fd, vec);
+    mystl::serialize(fd, dq);
+
+    // 流式写，元素个数事先不知道
+    {
+        mystl::serial_writer<int> writer(fd);
+        for(int i = 0; i < 100; i++) writer.write(i);
+        writer.write(vec);
+        writer.finish();
+        cout << "stream wrote " << writer.size() << " elements" << endl;
+    }
+
+    lseek(fd, 0, SEEK_SET);
+    mystl::vector<int> vec2;
+    mystl::deserialize(fd, vec2);
+    cout << "vector size " << vec2.size() << " : ";
+    for(size_t i = 0; i < vec2.size(); i++) cout << vec2[i] << " ";
+    cout << endl;
+
+    mystl::deque<message> dq2;
+    mystl::deserialize(fd, dq2);
+    cout << "deque size " << dq2.size() << " front " << dq2[0].id << " back " << dq2[dq2.size() - 1].id
+         << " equal " << (dq2.size() == dq.size() && dq2[500].price == dq[500].price) << endl;
+
+    mystl::serial_reader<int> reader(fd);
+    cout << "stream has " << reader.size() << " elements" << endl;
+    mystl::vector<int> chunk;
+    while(reader.read(chunk, 32)) cout << "chunk, size is " << chunk.size() << endl;
+    cout << "last " << chunk[chunk.size() - 1] << endl;
+
+    // 改坏一个字节，校验失败
+    lseek(fd, 0, SEEK_SET);
+    mystl::vector<int> bad(vec);
+    bad[3] = 0;
+    lseek(fd, 32 + 3 * sizeof(int), SEEK_SET);
+    write(fd, &bad[3], sizeof(int));
+    lseek(fd, 0, SEEK_SET);
+    try {
+        mystl::deserialize(fd, vec2);
+    } catch(const std::runtime_error& e) {
+        cout << e.what() << endl;
+    }
+    // 类型不匹配
+    lseek(fd, 0, SEEK_SET);
+    try {
+        mystl::deserialize(fd, dq2);
+    } catch(const std::runtime_error& e) {
+        cout << e.what() << endl;
+    }
+
+    // 默认构造不平凡的类型也可以读写
+    lseek(fd, 0, SEEK_SET);
+    mystl::vector<tagged> tv;
+    mystl::deque<tagged> td;
+    for(int i = 0; i < 600; i++) tv.push_back(tagged(i, -i));
+    mystl::serialize(fd, tv);
+    mystl::serialize(fd, tv);
+    lseek(fd, 0, SEEK_SET);
+    mystl::vector<tagged> tv2(size_t(3), tagged());
+    mystl::deserialize(fd, tv2);
+    mystl::deserialize(fd, td);
+    cout << "tagged vector size " << tv2.size() << " last " << tv2[599].id << "," << tv2[599].tag
+         << " deque size " << td.size() << " last " << td[599].id << "," << td[599].tag << endl;
+    close(fd);
+    unlink(path);
+}
@@ -0,0 +1,74 @@
+#include "../STL/soa_vector.h"
+
+#include <iostream>
+#include <string>
+#include <tuple>
+
+
+using namespace std;
+
+// 移动构造可能抛出异常，拷贝到第 failAt 次时抛出
+struct fragile {
+    static int copies;
+    static int failAt;
+    int value;
+    fragile(int v) : value(v) {}
+    fragile(const fragile& rhs) : value(rhs.value) {
+        if(++copies == failAt) throw runtime_error("fragile copy");
+    }
+    fragile(fragile&& rhs) noexcept(false) : value(rhs.value) {}
+};
+int fragile::copies = 0;
+int fragile::failAt = 0;
+
+int main() {
+    // 三列：id, price, name
+    mystl::soa_vector<int, double, string> records;
+    records.push_back(1, 9.5, "apple");
+    records.push_back(2, 3.25, "banana");
+    records.emplace_back(3, 12.0, "cherry");
+    records.push_back(make_tuple(4, 1.5, string("date")));
+    cout << "size is " << records.size() << " capacity is " << records.capacity() << endl;
+
+    // 只扫描price一列
+    double total = 0;
+    mystl::span<double> prices = records.column<1>();
+    for(size_t i = 0; i < prices.size(); i++) total += prices[i];
+    cout << "total price " << total << endl;
+
+    // 行代理引用
+    records[1] = make_tuple(20, 4.0, string("blueberry"));
+    for(auto it = records.begin(); it != records.end(); ++it) {
+        cout << (*it).get<0>() << " " << (*it).get<1>() << " " << (*it).get<2>() << endl;
+    }
+
+    records.pop_back();
+    tuple<int, double, string> row = records.back();
+    cout << "back is " << get<2>(row) << endl;
+    records.clear();
+    cout << "after clear size is " << records.size() << endl;
+
+    // 满了以后用自己的元素作参数，新行先构造，旧的行之后才被移走
+    mystl::soa_vector<int, string> self;
+    self.push_back(1, string("a string long enough to live on the heap"));
+    self.shrink_to_fit();
+    self.emplace_back(self.get<0>(0), self.get<1>(0));
+    self.shrink_to_fit();
+    self.push_back(self.get<0>(1), self.get<1>(1));
+    cout << "self emplace size " << self.size() << " last " << self.get<1>(2) << endl;
+
+    // 有一列不能安全移动时所有列都拷贝，扩容失败时原来的行不变
+    mystl::soa_vector<string, fragile> mixed;
+    for(int i = 0; i < 4; i++) mixed.push_back(string("name number ") + to_string(i) + " on the heap", fragile(i));
+    fragile::copies = 0;
+    fragile::failAt = 3;
+    try {
+        mixed.reserve(mixed.capacity() * 2);
+    } catch(const runtime_error& e) {
+        cout << "reserve failed: " << e.what() << endl;
+    }
+    fragile::failAt = 0;
+    cout << "after failed reserve size " << mixed.size() << " capacity " << mixed.capacity() << ":";
+    for(size_t i = 0; i < mixed.size(); i++) cout << " [" << mixed.get<0>(i) << "|" << mixed.get<1>(i).value << "]";
+    cout << endl;
+}
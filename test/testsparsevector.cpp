@@ -0,0 +1,82 @@
+#include "../STL/sparse_vector.h"
+#include "../STL/memory_resource.h"
+
+#include <iostream>
+#include <string>
+
+
+using namespace std;
+
+int main() {
+    // 2^32 个元素，只写几个位置
+    const size_t n = size_t(1) << 32;
+    mystl::sparse_vector<int> sv(n, -1);
+    cout << "size " << sv.size() << " page size " << sv.page_size() << " pages " << sv.page_count()
+         << " bytes " << sv.memory_bytes() << endl;
+    sv.set(0, 10);
+    sv.set(5, 50);
+    sv.set(n / 2, 7);
+    sv.ref(n - 1) = 99;
+    cout << "sv[0] " << sv[0] << " sv[1] " << sv[1] << " sv[5] " << sv[5] << " sv[n/2] " << sv[n / 2]
+         << " sv[n/2+1] " << sv[n / 2 + 1] << " sv[n-1] " << sv[n - 1] << " sv[12345678] " << sv[12345678] << endl;
+    cout << "pages " << sv.page_count() << " bytes " << sv.memory_bytes()
+         << " has_page(3) " << sv.has_page(3) << " has_page(1 << 20) " << sv.has_page(size_t(1) << 20) << endl;
+
+    // 按页遍历，只经过写过的页
+    for(auto it = sv.page_begin(); it != sv.page_end(); ++it) {
+        int touched = 0;
+        for(int x : *it) touched += x != -1;
+        cout << "page at " << (*it).index << " length " << (*it).size() << " touched " << touched << endl;
+    }
+
+    // 写回默认值的页可以释放
+    sv.reset(0);
+    sv.set(5, -1);
+    sv.reset(12345);
+    cout << "released " << sv.release_default_pages() << " pages " << sv.page_count() << endl;
+
+    try {
+        sv.at(n);
+    } catch(const out_of_range& e) {
+        cout << "out_of_range: " << e.what() << endl;
+    }
+
+    // 拷贝只复制写过的页，const 遍历
+    const mystl::sparse_vector<int> copy(sv);
+    size_t visited = 0;
+    for(auto it = copy.page_begin(); it != copy.page_end(); ++it) visited++;
+    cout << "copy pages " << copy.page_count() << " visited " << visited << " copy[n-1] " << copy[n - 1] << endl;
+
+    // 变短时释放后面的页，所在页后半部分恢复成默认值
+    mystl::sparse_vector<int> small(3000, 0);
+    for(size_t i = 0; i < 3000; i += 100) small.set(i, static_cast<int>(i));
+    cout << "small pages " << small.page_count();
+    small.resize(1500);
+    small.resize(3000);
+    cout << " after shrink/grow pages " << small.page_count() << " small[1400] " << small[1400]
+         << " small[1600] " << small[1600] << " small[2100] " << small[2100] << endl;
+
+    // 移动和交换
+    mystl::sparse_vector<int> moved(std::move(small));
+    mystl::sparse_vector<int> other;
+    other = std::move(moved);
+    swap(other, small);
+    cout << "after move/swap size " << small.size() << " small[1400] " << small[1400] << " other size " << other.size() << endl;
+
+    // 非平凡类型，页释放时元素被析构
+    mystl::sparse_vector<string> names(size_t(1) << 24, string("none"));
+    names.set(1000000, string("alice, who needs a heap allocated buffer"));
+    names.set(16000000, "bob");
+    cout << names[1000000] << " " << names[16000000] << " " << names[3] << " pages " << names.page_count() << endl;
+    names.clear();
+    cout << "after clear size " << names.size() << " pages " << names.page_count() << endl;
+
+    // 用 pmr 资源申请页和页表
+    {
+        mystl::pmr::monotonic_buffer_resource arena;
+        mystl::sparse_vector<long, mystl::pmr::polymorphic_allocator<long>> pv(size_t(1) << 30, 0L, &arena);
+        for(size_t i = 0; i < (size_t(1) << 30); i += size_t(1) << 25) pv.set(i, static_cast<long>(i >> 25));
+        cout << "pmr pages " << pv.page_count() << " pv[1 << 29] " << pv[size_t(1) << 29]
+             << " resource " << (pv.get_allocator().resource() == &arena) << endl;
+    }
+}
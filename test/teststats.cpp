@@ -0,0 +1,57 @@
+// 编译时加上 -DMYSTL_STATS 才会有计数，否则全部是0
+#include "../STL/vector.h"
+#include "../STL/deque.h"
+#include "../STL/stats.h"
+
+#include <iostream>
+#include <thread>
+#include <string>
+
+
+using namespace std;
+
+static void print_snapshot(const char* title) {
+    mystl::stats_snapshot snap = mystl::stats_take_snapshot();
+    cout << title << endl;
+    for(size_t i = 0; i < mystl::stat_counter_count; i++) {
+        mystl::stat_counter c = static_cast<mystl::stat_counter>(i);
+        cout << "  " << mystl::stat_counter_name(c) << " " << snap[c] << endl;
+    }
+}
+
+int main() {
+    {
+        mystl::vector<int> vec;
+        for(int i = 0; i < 1000; i++) vec.push_back(i);
+        vec.insert(vec.begin(), 5, -1);
+        vec.erase(vec.begin(), vec.begin() + 10);
+        mystl::vector<string> strs;
+        for(int i = 0; i < 100; i++) strs.emplace(strs.begin(), to_string(i));
+    }
+    print_snapshot("vector:");
+
+    mystl::stats_reset();
+    {
+        mystl::deque<int> dq;
+        for(int i = 0; i < 10000; i++) dq.push_back(i);
+        for(int i = 0; i < 10000; i++) dq.push_front(i);
+        dq.insert(dq.begin() + 100, 50, 7);
+        dq.erase(dq.begin() + 10, dq.begin() + 20);
+        while(!dq.empty()) dq.pop_front();
+    }
+    print_snapshot("deque:");
+
+    // 线程退出后计数合并到全局，不会丢失
+    mystl::stats_reset();
+    thread workers[4];
+    for(auto& t : workers) {
+        t = thread([] {
+            mystl::vector<int> vec;
+            for(int i = 0; i < 100; i++) vec.push_back(i);
+        });
+    }
+    for(auto& t : workers) t.join();
+#ifdef MYSTL_STATS
+    mystl::stats_dump(cout);
+#endif
+}
@@ -0,0 +1,70 @@
+// 容器通过线程缓存申请内存
+#define MYSTL_THREAD_CACHE
+#include "../STL/vector.h"
+#include "../STL/deque.h"
+#include "../STL/stack.h"
+#include "../STL/basic_string.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+
+int main() {
+    cout << "size classes " << mystl::thread_cache_class_count
+         << " class(100) " << mystl::thread_cache_class(100)
+         << " bytes " << mystl::thread_cache_class_bytes(mystl::thread_cache_class(100))
+         << " class(5000) bytes " << mystl::thread_cache_class_bytes(mystl::thread_cache_class(5000)) << endl;
+
+    // 每个线程创建销毁容器
+    const int nthreads = 4;
+    vector<long> sums(nthreads);
+    vector<thread> workers;
+    for(int t = 0; t < nthreads; t++) {
+        workers.emplace_back([&sums, t] {
+            for(int r = 0; r < 200; r++) {
+                mystl::vector<mystl::string> names;
+                mystl::deque<int> dq;
+                for(int i = 0; i < 100; i++) {
+                    names.push_back(mystl::string("a long name that does not fit inline ") + mystl::string(1, char('a' + i % 26)));
+                    dq.push_front(i);
+                }
+                sums[t] += static_cast<long>(names.size()) + dq[0];
+            }
+        });
+    }
+    for(auto& w : workers) w.join();
+    for(int t = 0; t < nthreads; t++) cout << "thread " << t << " sum " << sums[t] << endl;
+
+    // 一个线程申请，另一个线程释放
+    mystl::vector<mystl::vector<int>*> produced;
+    thread producer([&produced] {
+        for(int i = 0; i < 10000; i++) {
+            auto* vec = new mystl::vector<int>(size_t(i % 300 + 1), i);
+            produced.push_back(vec);
+        }
+    });
+    producer.join();
+    long total = 0;
+    thread consumer([&produced, &total] {
+        for(auto* vec : produced) {
+            total += static_cast<long>(vec->size());
+            delete vec;
+        }
+        mystl::thread_cache_flush();
+    });
+    consumer.join();
+    cout << "cross thread elements " << total << endl;
+
+    // 直接把 thread_cache_allocator 交给容器，deque 的结点表用 rebind 得到的分配器
+    mystl::deque<int, mystl::thread_cache_allocator<int>> tdq;
+    for(int i = 0; i < 5000; i++) tdq.push_back(i);
+    mystl::deque<int, mystl::thread_cache_allocator<int>> tmoved(std::move(tdq));
+    mystl::stack<int, mystl::deque<int, mystl::thread_cache_allocator<int>>> tst;
+    for(int i = 0; i < 5000; i++) tst.push(i);
+    mystl::thread_cache_allocator<long> along = mystl::thread_cache_allocator<int>();
+    cout << "thread cache deque size " << tmoved.size() << " stack top " << tst.top()
+         << " allocators equal " << (along == mystl::thread_cache_allocator<int>()) << endl;
+}
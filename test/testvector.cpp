@@ -17,10 +17,17 @@ int main() {
     mystl::vector<int> vec1(vec.begin(), vec.end());
     for(int i = 0; i < vec1.size(); i++) cout << vec1[i] << endl;
 
-    // size_t a = 5;
-    // int b = 10;
-    // mystl::vector<int> t(2, 3);
-    // for(int i = 0; i < t.size(); i++) cout << t[i] << " " << endl;
+    mystl::vector<int> t(2, 3);
+    for(int i = 0; i < t.size(); i++) cout << t[i] << " " << endl;
+
+    // 区间插入、赋值、追加
+    int arr[] = {7, 8, 9};
+    t.insert(t.begin() + 1, arr, arr + 3);
+    t.append_range(vec1);
+    for(int i = 0; i < t.size(); i++) cout << t[i] << " ";
+    cout << endl;
+    t.assign(vec.begin(), vec.begin() + 2);
+    cout << "after assign size " << t.size() << endl;
 
     mystl::vector<string> strVec;
     strVec.push_back("Hello");
@@ -38,4 +45,12 @@ int main() {
     strVec.emplace_back("world");
     strVec.insert(strVec.begin() + 1, 2, "longintlong");
     for(int i = 0; i < strVec.size(); i++) cout << strVec[i] << endl;
-}
\ No newline at end of file
+
+    // 扩容时追加自己的元素，容量每次正好用完
+    mystl::vector<string> self;
+    self.push_back("a string long enough to need a heap buffer");
+    self.push_back("another string long enough to need a heap buffer");
+    self.append_range(self);
+    self.append_range(self);
+    cout << "self append size " << self.size() << " capacity " << self.capacity() << " last " << self[self.size() - 1] << endl;
+}
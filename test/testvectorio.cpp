@@ -0,0 +1,39 @@
+#include "../STL/vector_io.h"
+
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <unistd.h>
+
+
+using namespace std;
+
+int main() {
+    int fds[2];
+    if(pipe(fds) != 0) return 1;
+    const char* msg = "Hello, world! This is my tiny STL!";
+    write(fds[1], msg, strlen(msg));
+
+    // 直接读进vector的备用空间，不清零
+    mystl::vector<char> buf;
+    buf.reserve(16);
+    ssize_t n = mystl::vector_read(fds[0], buf, 13);
+    cout << "read " << n << " bytes: " << string(buf.data(), buf.size()) << endl;
+    n = mystl::vector_readv(fds[0], buf);
+    cout << "readv " << n << " bytes, size is " << buf.size() << " capacity is " << buf.capacity() << endl;
+    cout << string(buf.data(), buf.size()) << endl;
+    close(fds[0]);
+    close(fds[1]);
+
+    // 交出缓冲区再接管，不拷贝
+    mystl::vector<char>::raw_buffer raw = buf.release();
+    cout << "after release size is " << buf.size() << endl;
+    mystl::vector<char> adopted = mystl::vector<char>::from_raw(raw.data, raw.size, raw.capacity);
+    cout << "adopted size is " << adopted.size() << " front is " << adopted.front() << endl;
+
+    mystl::vector<int> ints;
+    ints.resize_for_overwrite(4);
+    for(int i = 0; i < 4; i++) ints[i] = i * i;
+    for(auto it = ints.begin(); it != ints.end(); ++it) cout << *it << " ";
+    cout << endl;
+}